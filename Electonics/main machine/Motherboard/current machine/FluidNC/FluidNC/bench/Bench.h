@@ -0,0 +1,25 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "src/Logging.h"  // MsgLevel
+
+#include <cstdint>
+
+// Counters shared between the benchmark driver and its link seams
+class Bench {
+public:
+    static MsgLevel logLevel;
+
+    static uint32_t allocations;      // Calls to operator new since startup
+    static uint32_t planAllocations;  // The subset made while submitting a move to the planner
+    static uint32_t blocksConsumed;   // Planner blocks retired by the stand-in stepper
+    static uint32_t alarms;
+
+    // Charges allocations made during its lifetime to the planner stage
+    struct PlanScope {
+        uint32_t _start = allocations;
+        ~PlanScope() { planAllocations += allocations - _start; }
+    };
+};
@@ -0,0 +1,341 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+/*
+  BenchStubs.cpp - link seams for the line-throughput benchmark.
+
+  The benchmark links the real parser, motion control and planner sources.
+  Everything they reach beyond that - channels, settings storage, the stepper,
+  the tool rack file and the configuration tree - is replaced here by the
+  smallest stand-in that lets a line travel from gc_execute_line() into the
+  planner.  The "stepper" consumes a planner block whenever the planner is
+  full, so the planner runs in its steady state of always having a full queue.
+*/
+
+#include "Bench.h"
+
+#include "src/Machine/MachineConfig.h"
+#include "src/Kinematics/Kinematics.h"
+#include "src/WebUI/ToolConfig.h"
+#include "src/Machine/Homing.h"
+#include "src/Channel.h"
+#include "src/Serial.h"
+#include "src/Settings.h"
+#include "src/Planner.h"
+#include "src/Protocol.h"
+#include "src/MotionControl.h"
+#include "src/Report.h"
+#include "src/RealtimeCmd.h"
+#include "src/Probe.h"
+#include "src/Pin.h"
+#include "src/Stepper.h"
+#include "src/Logging.h"
+#include "src/Error.h"
+#include "src/Job.h"
+#include "src/Event.h"
+#include "src/Pen.h"
+#include "src/ToolCalibration.h"
+#include "src/WorkAreaCalibration.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Timing
+
+uint32_t ticks_per_us = 1000;
+
+int32_t getCpuTicks() {
+    using namespace std::chrono;
+    return int32_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// Logging goes to stderr, errors only unless the benchmark asks for more
+
+MsgLevel Bench::logLevel = MsgLevelError;
+
+bool atMsgLevel(MsgLevel level) {
+    return level <= Bench::logLevel;
+}
+
+LogStream::LogStream(Channel& channel, MsgLevel level) : _channel(channel), _level(level) {
+    _line = new std::string();
+}
+LogStream::LogStream(Channel& channel, MsgLevel level, const char* name) : LogStream(channel, level) {
+    print(name);
+}
+LogStream::LogStream(Channel& channel, const char* name) : LogStream(channel, MsgLevelNone, name) {}
+LogStream::LogStream(MsgLevel level, const char* name) : LogStream(allChannels, level, name) {}
+
+size_t LogStream::write(uint8_t c) {
+    *_line += char(c);
+    return 1;
+}
+
+LogStream::~LogStream() {
+    if ((*_line)[0] == '[') {
+        *_line += ']';
+    }
+    fprintf(stderr, "%s\n", _line->c_str());
+    delete _line;
+}
+
+// Channels
+
+AllChannels allChannels;
+
+void AllChannels::notifyWco() {}
+void AllChannels::notifyNgc(CoordIndex coord) {}
+void AllChannels::notifyOvr() {}
+
+size_t AllChannels::write(uint8_t data) {
+    return 1;
+}
+size_t AllChannels::write(const uint8_t* buffer, size_t length) {
+    return length;
+}
+void AllChannels::print_msg(MsgLevel level, const char* msg) {}
+void AllChannels::flushRx() {}
+
+TaskHandle_t outputTask    = nullptr;
+xQueueHandle message_queue = nullptr;
+
+bool is_realtime_command(uint8_t data) {
+    return false;
+}
+void execute_realtime_command(Cmd command, Channel& channel) {}
+
+// Reports
+
+const char* grbl_version = "bench";
+
+Counter     report_ovr_counter = 0;
+Counter     report_wco_counter = 0;
+std::string report_pin_string;
+
+void report_realtime_status(Channel& channel) {}
+void report_ngc_coord(CoordIndex coord, Channel& channel) {}
+void report_gcode_modes(Channel& channel) {}
+void report_recompute_pin_string() {}
+void mpos_to_wpos(float* position) {}
+
+const char* errorString(Error errorNumber) {
+    return "error";
+}
+
+// Pins.  Nothing is wired up, so every pin is undefined.
+
+Pins::PinDetail* Pin::undefinedPin = nullptr;
+
+Pin::~Pin() {}
+
+// Configuration tree.  Only the members that the parser and planner read are
+// populated; see Bench::makeMachine().
+
+MachineConfig::~MachineConfig() {}
+void MachineConfig::group(Configuration::HandlerBase& handler) {}
+void MachineConfig::afterParse() {}
+
+MachineConfig* config = nullptr;
+
+namespace Machine {
+    Axes::Axes() {
+        for (int i = 0; i < MAX_N_AXIS; ++i) {
+            _axis[i] = nullptr;
+        }
+    }
+    Axes::~Axes() {}
+    void Axes::group(Configuration::HandlerBase& handler) {}
+    void Axes::afterParse() {}
+
+    std::string Axes::maskToNames(AxisMask mask) {
+        std::string retval("");
+        for (int axis = 0; axis < _numberAxis; ++axis) {
+            if (bitnum_is_true(mask, axis)) {
+                retval += _names[axis];
+            }
+        }
+        return retval;
+    }
+
+    Axis::~Axis() {}
+    void Axis::group(Configuration::HandlerBase& handler) {}
+    void Axis::afterParse() {}
+
+    AxisMask Homing::unhomed_axes() {
+        return 0;
+    }
+}
+
+// Cartesian kinematics with no soft limits
+namespace Kinematics {
+    Kinematics::~Kinematics() {}
+    void Kinematics::group(Configuration::HandlerBase& handler) {}
+    void Kinematics::afterParse() {}
+
+    bool Kinematics::cartesian_to_motors(float* target, plan_line_data_t* pl_data, float* position) {
+        Bench::PlanScope scope;
+        return mc_move_motors(target, pl_data);
+    }
+    void Kinematics::motors_to_cartesian(float* cartesian, float* motors, int n_axis) {
+        copyAxes(cartesian, motors);
+    }
+    bool Kinematics::transform_cartesian_to_motors(float* motors, float* cartesian) {
+        copyAxes(motors, cartesian);
+        return true;
+    }
+    bool Kinematics::invalid_line(float* target) {
+        return false;
+    }
+    bool Kinematics::invalid_arc(
+        float* target, plan_line_data_t* pl_data, float* position, float center[3], float radius, size_t caxes[3], bool is_clockwise_arc) {
+        return false;
+    }
+}
+
+// No keep-out zones either
+
+bool limitsKeepOut(const float* from, const float* to) {
+    return false;
+}
+void limit_error() {}
+
+// Coordinate systems live in NVS on the machine; here they are all zero
+
+Coordinates* coords[CoordIndex::End];
+
+void Coordinates::set(float* value) {
+    memcpy(&_currentValue, value, sizeof(_currentValue));
+}
+
+// Protocol.  The planner is drained by discarding the oldest block, which is
+// what the stepper does once it has executed one.
+
+volatile bool pen_change              = false;
+volatile bool cycle_start_tool_change = false;
+
+static void consume_block() {
+    plan_discard_current_block();
+    ++Bench::blocksConsumed;
+}
+
+void protocol_execute_realtime() {
+    if (plan_check_full_buffer()) {
+        consume_block();
+    }
+}
+void protocol_exec_rt_system() {}
+void protocol_auto_cycle_start() {}
+void protocol_buffer_synchronize() {
+    while (plan_get_current_block()) {
+        consume_block();
+    }
+}
+void protocol_send_event(const Event* evt, void* arg) {}
+
+const NoArgEvent feedHoldEvent { nullptr };
+const NoArgEvent cycleStartEvent { nullptr };
+
+void send_alarm(ExecAlarm alarm) {
+    ++Bench::alarms;
+}
+
+void report_feedback_message(Message message) {}
+void report_probe_parameters(Channel& channel) {}
+
+
+// Stepper
+
+bool Stepper::update_plan_block_parameters() {
+    return false;
+}
+void Stepper::reset() {}
+
+extern "C" float stepper_get_mm_remaining() {
+    return 0;
+}
+extern "C" float stepper_get_current_block_nominal_speed_mm_per_min() {
+    return 0;
+}
+
+namespace Machine {
+    void Stepping::beginLowLatency() {}
+    void Stepping::endLowLatency() {}
+}
+
+// Jobs, probing, I/O and the jog and tool-calibration paths are not exercised
+
+bool Job::active() {
+    return false;
+}
+Channel* Job::channel() {
+    return nullptr;
+}
+float Job::get_param(int slot) {
+    return 0;
+}
+void Job::set_param(int slot, float value) {}
+bool Job::param_exists(int slot) {
+    return false;
+}
+bool is_program_number(const char* line) {
+    return false;
+}
+
+bool Probe::get_state() {
+    return false;
+}
+bool Probe::tripped() {
+    return false;
+}
+void Probe::set_direction(bool is_away) {}
+
+void CoolantControl::off() {}
+void CoolantControl::set_state(CoolantState state) {}
+
+namespace Machine {
+    bool UserOutputs::setDigital(size_t io_num, bool isOn) {
+        return true;
+    }
+    bool UserOutputs::setAnalogPercent(size_t io_num, float percent) {
+        return true;
+    }
+}
+
+Error jog_execute(plan_line_data_t* pl_data, parser_block_t* gc_block, bool* cancelledInflight) {
+    return Error::Ok;
+}
+
+void ToolCalibration::startCalibration() {}
+void ToolCalibration::setToolZ(float z) {}
+void WorkAreaCalibration::startPass(int pass) {}
+
+// Tool rack.  Pens sit in a row along the back of the bed.
+
+namespace WebUI {
+    static int loadedPen = 0;
+
+    bool ToolConfig::loadConfig() {
+        return true;
+    }
+    bool ToolConfig::ensureLoaded() {
+        return true;
+    }
+    int ToolConfig::getLastKnownState() {
+        return loadedPen;
+    }
+    bool ToolConfig::saveCurrentState(int currentPen) {
+        loadedPen = currentPen;
+        return true;
+    }
+    bool ToolConfig::getToolPosition(int toolNumber, float* position) {
+        if (toolNumber < 1 || toolNumber > MAX_TOOLS) {
+            return false;
+        }
+        position[0] = 20.0f + 40.0f * (toolNumber - 1);
+        position[1] = 290.0f;
+        position[2] = 10.0f;
+        return true;
+    }
+}
+
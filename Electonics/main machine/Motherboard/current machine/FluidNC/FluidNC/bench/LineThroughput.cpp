@@ -0,0 +1,417 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+/*
+  LineThroughput.cpp - lines per second through the parser and planner.
+
+  Feeds G-code corpora through collapseGCode(), gc_execute_line() and
+  plan_buffer_line() on the build host and reports, per corpus, the line rate,
+  the time spent in each stage and the number of heap allocations each stage
+  makes.  The built-in corpora are generated to look like the files the
+  plotters run: a dense hatch fill, text outlines made of short segments,
+  stipple circles made of arcs, and a multi-colour drawing with a pen change
+  between colours.  Any files named on the command line are run as well.
+
+      pio run -e bench -t exec
+      .pio/build/bench/program [--repeat N] [--verbose] [file.nc ...]
+
+  Stage times come from the Profiler counters, so they are inclusive:
+  "execute" is the whole of gc_execute_line(), which contains "plan", which
+  contains "recalc".  Run it before and after a parser or planner change.
+*/
+
+#include "Bench.h"
+
+#include "src/GCode.h"
+#include "src/Planner.h"
+#include "src/Profiler.h"
+#include "src/Protocol.h"  // LINE_BUFFER_SIZE
+#include "src/Settings.h"  // coords
+#include "src/System.h"    // sys
+#include "src/Error.h"
+#include "src/Machine/MachineConfig.h"
+#include "src/Kinematics/Kinematics.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+uint32_t Bench::allocations     = 0;
+uint32_t Bench::planAllocations = 0;
+uint32_t Bench::blocksConsumed  = 0;
+uint32_t Bench::alarms          = 0;
+
+// Every heap allocation in the process goes through here.  Each form of new
+// and delete calls the same pair, which are kept out of line so that the
+// compiler does not see free() applied to what a new expression returned.
+
+__attribute__((noinline)) static void* countedAlloc(size_t size) {
+    ++Bench::allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+__attribute__((noinline)) static void countedFree(void* p) noexcept {
+    free(p);
+}
+
+void* operator new(size_t size) {
+    return countedAlloc(size);
+}
+void* operator new[](size_t size) {
+    return countedAlloc(size);
+}
+void operator delete(void* p) noexcept {
+    countedFree(p);
+}
+void operator delete[](void* p) noexcept {
+    countedFree(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    countedFree(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    countedFree(p);
+}
+
+// A plotter shaped machine: the X and Y numbers match MAXA3.yaml
+static void makeMachine() {
+    config = new Machine::MachineConfig();
+
+    auto axes         = new Machine::Axes();
+    axes->_numberAxis = 3;
+    for (int i = 0; i < axes->_numberAxis; i++) {
+        auto axis           = new Machine::Axis(i);
+        axis->_stepsPerMm   = 160;
+        axis->_maxRate      = i == Z_AXIS ? 2200 : 20000;
+        axis->_acceleration = i == Z_AXIS ? 8000 : 1000;
+        axes->_axis[i]      = axis;
+    }
+    config->_axes           = axes;
+    config->_kinematics     = new Kinematics::Kinematics();
+    config->_start          = new Machine::Start();
+    config->_planner_blocks = 20;
+
+    for (int i = 0; i < CoordIndex::End; i++) {
+        coords[i] = new Coordinates("bench");
+        coords[i]->setDefault();
+    }
+
+    plan_init();
+}
+
+// Corpora
+
+struct Corpus {
+    std::string              name;
+    std::vector<std::string> lines;
+};
+
+class Writer {
+    std::vector<std::string>& _lines;
+    bool                      _penDown = true;
+
+public:
+    explicit Writer(std::vector<std::string>& lines) : _lines(lines) {}
+
+    void line(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char    buf[LINE_BUFFER_SIZE];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        _lines.emplace_back(buf);
+    }
+    void header() {
+        line("G21");
+        line("G90");
+        line("G17");
+        up();
+    }
+    void up() {
+        if (_penDown) {
+            line("G0 Z3");
+            _penDown = false;
+        }
+    }
+    void down() {
+        if (!_penDown) {
+            line("G1 Z0 F2000");
+            _penDown = true;
+        }
+    }
+    void travel(float x, float y) {
+        up();
+        line("G0 X%.3f Y%.3f", x, y);
+    }
+    void draw(float x, float y) {
+        down();
+        line("G1 X%.3f Y%.3f F6000", x, y);
+    }
+};
+
+// 45 degree hatching of a 200 x 150 mm rectangle at 0.4 mm pitch, boustrophedon
+static Corpus hatchFill() {
+    Corpus c { "hatch fill" };
+    Writer w(c.lines);
+    w.header();
+    const float width = 200, height = 150, pitch = 0.4f * sqrtf(2);
+    bool        flip = false;
+    for (float d = pitch; d < width + height; d += pitch) {
+        float x0 = std::max(0.0f, d - height), y0 = std::min(d, height);
+        float x1 = std::min(d, width), y1 = std::max(0.0f, d - width);
+        if (flip) {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+        w.travel(10 + x0, 10 + y0);
+        w.draw(10 + x1, 10 + y1);
+        flip = !flip;
+    }
+    w.up();
+    return c;
+}
+
+// Rows of glyph-sized closed outlines made of 0.2 - 1 mm segments, the way a
+// font outline looks after flattening
+static Corpus textOutlines() {
+    Corpus c { "text outlines" };
+    Writer w(c.lines);
+    w.header();
+    const float glyph = 6.0f;
+    for (int row = 0; row < 24; row++) {
+        for (int col = 0; col < 40; col++) {
+            float cx = 10 + col * glyph, cy = 280 - row * glyph * 1.6f;
+            int   lobes = 2 + (row * 40 + col) % 5;
+            int   steps = 40 + 8 * lobes;
+            for (int i = 0; i <= steps; i++) {
+                float t = 2 * float(M_PI) * i / steps;
+                float r = glyph * (0.3f + 0.12f * cosf(lobes * t));
+                float x = cx + r * cosf(t), y = cy + r * sinf(t);
+                if (i == 0) {
+                    w.travel(x, y);
+                } else {
+                    w.draw(x, y);
+                }
+            }
+        }
+    }
+    w.up();
+    return c;
+}
+
+// Stipple: thousands of small full circles drawn as G2 arcs
+static Corpus stippleCircles() {
+    Corpus c { "stipple circles" };
+    Writer w(c.lines);
+    w.header();
+    uint32_t seed = 12345;
+    auto     rnd  = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return float((seed >> 8) & 0xffff) / 65536.0f;
+    };
+    for (int i = 0; i < 4000; i++) {
+        float x = 10 + 380 * rnd(), y = 10 + 260 * rnd(), r = 0.3f + 1.2f * rnd();
+        w.travel(x + r, y);
+        w.down();
+        w.line("G2 X%.3f Y%.3f I%.3f J0 F4000", x + r, y, -r);
+    }
+    w.up();
+    return c;
+}
+
+// Four colours of short strokes, changing pens between colours and cycling
+// through the colours several times
+static Corpus penChanges() {
+    Corpus c { "pen changes" };
+    Writer w(c.lines);
+    w.header();
+    for (int pass = 0; pass < 5; pass++) {
+        for (int pen = 1; pen <= 4; pen++) {
+            w.up();
+            w.line("M6 T%d", pen);
+            for (int stroke = 0; stroke < 60; stroke++) {
+                float x = 20 + 5 * stroke, y = 20 + 40 * pen + 4 * pass;
+                w.travel(x, y);
+                w.draw(x + 3, y + 2);
+                w.draw(x + 1, y + 5);
+            }
+        }
+    }
+    w.up();
+    w.line("M6 T0");
+    return c;
+}
+
+static bool readFile(const char* path, Corpus& c) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    c.name = path;
+    for (std::string line; std::getline(in, line);) {
+        c.lines.push_back(line);
+    }
+    return true;
+}
+
+// Running
+
+struct Result {
+    uint32_t lines;
+    uint32_t errors;
+    double   wallUs;
+    double   collapseUs;
+    uint32_t collapseAllocs;
+    uint32_t executeAllocs;
+};
+
+static double elapsedUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void resetMachine() {
+    plan_reset();
+    gc_init();
+    sys.abort = false;
+}
+
+static Result run(const Corpus& c, int repeat) {
+    Result r {};
+    char   line[LINE_BUFFER_SIZE];
+    char   scratch[LINE_BUFFER_SIZE];
+
+    resetMachine();
+    Profiler::reset();
+    Bench::planAllocations = 0;
+
+    for (int pass = 0; pass < repeat; pass++) {
+        for (auto& text : c.lines) {
+            if (text.length() >= LINE_BUFFER_SIZE) {
+                ++r.errors;
+                continue;
+            }
+            // collapseGCode() on its own, on a copy, so its share is visible
+            strcpy(scratch, text.c_str());
+            uint32_t allocs = Bench::allocations;
+            auto     start  = std::chrono::steady_clock::now();
+            collapseGCode(scratch);
+            r.collapseUs += elapsedUs(start);
+            r.collapseAllocs += Bench::allocations - allocs;
+
+            strcpy(line, text.c_str());
+            allocs = Bench::allocations;
+            start  = std::chrono::steady_clock::now();
+            Error status = gc_execute_line(line);
+            r.wallUs += elapsedUs(start);
+            r.executeAllocs += Bench::allocations - allocs;
+
+            if (status != Error::Ok) {
+                if (r.errors++ < 5) {
+                    fprintf(stderr, "%s: error %d on \"%s\"\n", c.name.c_str(), int(status), text.c_str());
+                }
+            }
+            ++r.lines;
+        }
+    }
+    protocol_buffer_synchronize();
+    return r;
+}
+
+static double sectionUs(ProfileSection section) {
+    return double(Profiler::counters[int(section)].totalTicks) / ticks_per_us;
+}
+
+static void report(const Corpus& c, const Result& r) {
+    double executeUs = sectionUs(ProfileSection::GCodeExecute);
+    double planUs    = sectionUs(ProfileSection::PlanBufferLine);
+    double recalcUs  = sectionUs(ProfileSection::PlanRecalculate);
+    double perLine   = r.lines ? 1.0 / r.lines : 0;
+
+    printf("%-16s %7u %10.0f %9.3f %9.3f %9.3f %9.3f %8.2f %8.2f %8.2f %6u\n",
+           c.name.c_str(),
+           r.lines,
+           r.wallUs ? r.lines * 1e6 / r.wallUs : 0,
+           r.collapseUs * perLine,
+           executeUs * perLine,
+           planUs * perLine,
+           recalcUs * perLine,
+           r.collapseAllocs * perLine,
+           (r.executeAllocs - Bench::planAllocations) * perLine,
+           Bench::planAllocations * perLine,
+           r.errors);
+}
+
+int main(int argc, char** argv) {
+    int                 repeat = 3;
+    std::vector<Corpus> corpora;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--verbose")) {
+            Bench::logLevel = MsgLevelInfo;
+        } else {
+            Corpus c;
+            if (!readFile(argv[i], c)) {
+                fprintf(stderr, "Cannot read %s\n", argv[i]);
+                return 1;
+            }
+            corpora.push_back(std::move(c));
+        }
+    }
+    if (corpora.empty()) {
+        corpora.push_back(hatchFill());
+        corpora.push_back(textOutlines());
+        corpora.push_back(stippleCircles());
+        corpora.push_back(penChanges());
+    }
+
+    makeMachine();
+
+    printf("%-16s %7s %10s %9s %9s %9s %9s %8s %8s %8s %6s\n",
+           "",
+           "",
+           "",
+           "us/line",
+           "",
+           "",
+           "",
+           "allocs/line",
+           "",
+           "",
+           "");
+    printf("%-16s %7s %10s %9s %9s %9s %9s %8s %8s %8s %6s\n",
+           "corpus",
+           "lines",
+           "lines/s",
+           "collapse",
+           "execute",
+           "plan",
+           "recalc",
+           "collapse",
+           "parse",
+           "plan",
+           "errors");
+
+    uint32_t errors = 0;
+    for (auto& c : corpora) {
+        Result r = run(c, repeat);
+        report(c, r);
+        errors += r.errors;
+    }
+    if (Bench::alarms) {
+        printf("%u alarms\n", Bench::alarms);
+    }
+    // A corpus that no longer parses would make the numbers meaningless
+    return errors || Bench::alarms ? 1 : 0;
+}
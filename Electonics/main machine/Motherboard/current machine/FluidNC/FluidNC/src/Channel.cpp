@@ -13,9 +13,7 @@
 void Channel::flushRx() {
     _linelen   = 0;
     _lastWasCR = false;
-    while (_queue.size()) {
-        _queue.pop();
-    }
+    _queue.clear();
 }
 
 bool Channel::lineComplete(char* line, char ch) {
@@ -178,41 +176,145 @@ void Channel::handleRealtimeCharacter(uint8_t ch) {
     execute_realtime_command(static_cast<Cmd>(cmd), *this);
 }
 
-void Channel::push(uint8_t byte) {
-    if (is_realtime_command(byte)) {
-        handleRealtimeCharacter(byte);
-    } else {
-        _queue.push(byte);
-    }
+// Input is scanned a 32-bit word at a time.  hasByte() is nonzero if any
+// byte of word equals c.
+static inline uint32_t hasByte(uint32_t word, uint8_t c) {
+    uint32_t x = word ^ (0x01010101u * c);
+    return (x - 0x01010101u) & ~x & 0x80808080u;
 }
 
-Error Channel::pollLine(char* line) {
-    handle();
-    while (1) {
-        int ch = -1;
-        if (line && _queue.size()) {
-            ch = _queue.front();
-            _queue.pop();
-        } else {
-            ch = read();
-            if (ch < 0) {
-                break;
-            }
-            _active = true;
-            if (realtimeOkay(ch) && is_realtime_command(ch)) {
-                handleRealtimeCharacter((uint8_t)ch);
+// The number of bytes before the first one that might be a realtime
+// character.  The word test flags every byte that is_realtime_command()
+// accepts - the Grbl single-byte commands and everything from 0x80 up -
+// and is_realtime_command() has the final say on flagged words.
+static size_t plainRun(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        if (i + 4 <= length) {
+            uint32_t word;
+            memcpy(&word, data + i, 4);
+            if (!((word & 0x80808080u) | hasByte(word, uint8_t(Cmd::Reset)) | hasByte(word, uint8_t(Cmd::StatusReport)) |
+                  hasByte(word, uint8_t(Cmd::CycleStart)) | hasByte(word, uint8_t(Cmd::FeedHold)))) {
+                i += 4;
                 continue;
             }
-            if (!line) {
-                _queue.push(ch);
-                continue;
+        }
+        for (size_t end = std::min(i + 4, length); i < end; ++i) {
+            if (is_realtime_command(data[i])) {
+                return i;
             }
-            // Fall through if line is non-null and it is not a realtime character
         }
+    }
+    return length;
+}
+
+// The number of bytes before the first line ending or backspace
+static size_t lineRun(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        uint32_t word;
+        memcpy(&word, data + i, 4);
+        if (hasByte(word, '\n') | hasByte(word, '\r') | hasByte(word, '\b')) {
+            break;
+        }
+    }
+    for (; i < length; ++i) {
+        uint8_t c = data[i];
+        if (c == '\n' || c == '\r' || c == '\b') {
+            break;
+        }
+    }
+    return i;
+}
 
-        if (lineComplete(line, ch)) {
-            return Error::Ok;
+size_t Channel::queueInput(const uint8_t* data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        done += _queue.push(data + done, plainRun(data + done, length - done));
+        if (done == length) {
+            break;
+        }
+        uint8_t c = data[done];
+        if (realtimeOkay(c) && is_realtime_command(c)) {
+            handleRealtimeCharacter(c);
+        } else if (!_queue.push(c)) {
+            // Full; the rest is lost, as it would be in a device buffer
+            break;
         }
+        ++done;
+    }
+    return done;
+}
+
+bool Channel::push(const uint8_t* data, size_t length) {
+    // Realtime characters are not stored, so this can refuse a message that
+    // would just fit, but never takes one that does not.
+    if (length > _queue.space()) {
+        return false;
+    }
+    queueInput(data, length);
+    return true;
+}
+
+size_t Channel::rxBytes(uint8_t* buffer, size_t length) {
+    size_t n = 0;
+    int    ch;
+    while (n < length && (ch = read()) >= 0) {
+        buffer[n++] = ch;
+    }
+    return n;
+}
+
+void Channel::receive() {
+    uint8_t buffer[64];
+    // Stop when _queue is full so that the device's own buffer and flow
+    // control hold the excess, as they did when input was read per line.
+    while (_queue.space()) {
+        size_t n = rxBytes(buffer, std::min(sizeof(buffer), _queue.space()));
+        if (!n) {
+            break;
+        }
+        _active = true;
+        queueInput(buffer, n);
+    }
+}
+
+bool Channel::assembleLine(char* line) {
+    while (!_queue.empty()) {
+        size_t         len;
+        const uint8_t* p = _queue.span(len);
+        size_t         n = lineRun(p, len);
+        if (n) {
+            _lastWasCR = false;
+            if (_linelen == 0 && n < len && p[n] != '\b' && n < size_t(Channel::maxLine)) {
+                // The whole line is contiguous in _queue, so hand it over directly
+                memcpy(line, p, n);
+                line[n]    = '\0';
+                _lastWasCR = p[n] == '\r';
+                _queue.consume(n + 1);
+                return true;
+            }
+            // Append the run to the line being assembled.  As in lineComplete(),
+            // characters past the maximum line length are dropped.
+            size_t room = std::min(n, size_t(Channel::maxLine - 1) - _linelen);
+            memcpy(_line + _linelen, p, room);
+            _linelen += room;
+            _queue.consume(n);
+            continue;
+        }
+        // Line endings and editing go through lineComplete()
+        if (lineComplete(line, _queue.pop())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Error Channel::pollLine(char* line) {
+    handle();
+    receive();
+    if (line && assembleLine(line)) {
+        return Error::Ok;
     }
     if (_active) {
         autoReport();
@@ -253,7 +355,7 @@ void Channel::registerEvent(uint8_t code, EventPin* obj) {
     _events[code] = obj;
 }
 
-void Channel::ack(Error status) {
+void Channel::ack(Error status, size_t line_number) {
     if (status == Error::Ok) {
         sendLine(MsgLevelNone, "ok");
         return;
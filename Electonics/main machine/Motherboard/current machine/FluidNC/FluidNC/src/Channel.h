@@ -21,13 +21,13 @@
 #include "Types.h"        // State
 #include "RealtimeCmd.h"  // Cmd
 #include "UTF8.h"
+#include "RingBuffer.h"
 
 #include "Pins/PinAttributes.h"
 #include "Machine/EventPin.h"
 
 #include <Stream.h>
 #include <freertos/FreeRTOS.h>  // TickType_T
-#include <queue>
 
 class Channel : public Stream {
 private:
@@ -55,7 +55,25 @@ protected:
     bool        _addCR         = false;
     char        _lastWasCR     = false;
 
-    std::queue<uint8_t> _queue;
+    // Received characters that are not realtime commands, waiting to be
+    // assembled into lines
+    static constexpr size_t rxQueueSize = 1024;
+    RingBuffer<rxQueueSize> _queue;
+
+    // receive() moves everything the device has received into _queue.
+    // queueInput() stores data in _queue, acting on realtime characters
+    // instead of storing them, and returns how many bytes it used.
+    void           receive();
+    virtual size_t queueInput(const uint8_t* data, size_t length);
+
+    // rxBytes() reads up to length received bytes without waiting.  The
+    // default uses read(); devices that can read in bulk override it.
+    virtual size_t rxBytes(uint8_t* buffer, size_t length);
+
+    // assembleLine() takes characters from _queue until a line is complete.
+    // The default copies runs of ordinary characters in bulk, handing a line
+    // that is already complete in _queue straight to the caller.
+    virtual bool assembleLine(char* line);
 
     uint32_t _reportInterval = 0;
     int32_t  _nextReportTime = 0;
@@ -95,7 +113,7 @@ public:
 
     virtual void       handle() {};
     virtual Error      pollLine(char* line);
-    virtual void       ack(Error status);
+    virtual void       ack(Error status, size_t line_number);
     const std::string& name() { return _name; }
 
     virtual void sendLine(MsgLevel level, const char* line);
@@ -106,13 +124,22 @@ public:
 
     std::string _progress;
 
-    // rx_buffer_available() is the number of bytes that can be sent without overflowing
-    // a reception buffer, even if the system is busy.  Channels that can handle external
-    // input via an interrupt or other background mechanism should override it to return
-    // the remaining space that mechanism has available.
-    // The queue can handle more than 256 characters but we don't want it to get too
-    // large, so we report a limited size.
-    virtual int rx_buffer_available() { return std::max(0, 256 - int(_queue.size())); }
+    // Character-counting senders keep up to rx_buffer_size() bytes of unacknowledged
+    // lines in flight.  Every channel can hold that much, because input moves from the
+    // device into _queue, which is that size, and realtime characters do not count.
+    // Device buffers must be at least that size too, or input is lost whenever the
+    // polling task falls behind with _queue full.
+    // It is advertised in the [OPT:] line of $I.
+    static constexpr int rx_buffer_size() { return rxQueueSize; }
+
+    // rx_buffer_available() is the number of bytes that can be sent without overflowing,
+    // even if the system is busy - the space in _queue less what is still waiting in the
+    // device.  It is the second number of the Bf: status field.
+    int rx_buffer_available() { return std::max(0, int(_queue.space()) - rx_device_pending()); }
+
+    // rx_device_pending() is the number of bytes received by the device or network stack
+    // that have not yet been moved into _queue.
+    virtual int rx_device_pending() { return 0; }
 
     // flushRx() discards any characters that have already been received.  It is used
     // after a reset, so that anything already sent will not be processed.
@@ -165,18 +192,14 @@ public:
     virtual void autoReport();
     void         autoReportGCodeState();
 
-    void push(uint8_t byte);
-    void push(const uint8_t* data, size_t length) {
-        while (length--) {
-            push(*data++);
-        }
-    }
-    void push(std::string_view data) {
-        for (auto const& c : data) {
-            push((uint8_t)c);
-        }
-    }
-    void push(const std::string& s) { push(reinterpret_cast<const uint8_t*>(s.c_str()), s.length()); }
+    // push() queues input that arrives in messages rather than from a
+    // device buffer.  A message is taken whole or not at all: if it might
+    // not fit in _queue, nothing is queued and push() returns false, so the
+    // sender can be told to send it again instead of losing part of a line.
+    bool push(const uint8_t* data, size_t length);
+    bool push(uint8_t byte) { return push(&byte, 1); }
+    bool push(std::string_view data) { return push(reinterpret_cast<const uint8_t*>(data.data()), data.length()); }
+    bool push(const std::string& s) { return push(reinterpret_cast<const uint8_t*>(s.c_str()), s.length()); }
 
     void end() { _ended = true; }
 
@@ -192,6 +215,18 @@ public:
 
     size_t lineNumber() { return _line_number; }
 
+    // Input is read ahead of execution, so a job channel that stops itself in
+    // ack(), or is ended by M2 or M30, may already have more lines queued.
+    // stopped() tells the protocol task to discard them, as they would never
+    // have been read.
+    virtual bool stopped() { return _ended; }
+
     virtual void save() {}
     virtual void restore() {}
+
+    // O-word flow control in a job repeats lines and passes over them by
+    // moving the read position, so it needs a channel that can do that.
+    virtual bool   seekable() { return false; }
+    virtual size_t tell() { return 0; }
+    virtual void   seek(size_t position, size_t lineNumber) {}
 };
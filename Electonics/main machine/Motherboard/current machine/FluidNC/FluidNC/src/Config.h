@@ -182,14 +182,11 @@ const double ARC_ANGULAR_TRAVEL_EPSILON = 5E-7;  // Float (radians)
 
 // Writing to non-volatile storage (NVS) can take a long time and interfere with timely instruction
 // execution, causing problems for the stepper ISRs and serial comm ISRs and subsequent loss of
-// stepper position and serial data. This configuration option forces the planner buffer to completely
-// empty whenever the NVS is written, to prevent any chance of lost steps.
-// It doesn't prevent loss of serial Rx data, especially if a GUI is premptively filling up the
-// serial Rx buffer.  GUIs should detect GCodes that write to NVS - notably G10,G28.1,G30.1 -
-// and wait for an 'ok' before sending more data.
-// NOTE: Most setting changes - $ commands - are blocked when a job is running. Coordinate setting
-// GCode commands (G10,G28/30.1) are not blocked, since they are part of an active streaming job.
-// This option forces a planner buffer sync only with such GCode commands.
+// stepper position and serial data. Setting changes, including those made by G10,G28.1,G30.1,
+// are held in RAM and written to NVS together once they stop arriving.  This configuration option
+// defers that write until the planner buffer is empty and motion has stopped, so that it never
+// competes with stepping.  Disabling it lets the write happen while moving.
+// Pending changes are also written before a restart.
 const bool FORCE_BUFFER_SYNC_DURING_NVS_WRITE = true;  // Default enabled. Comment to disable.
 
 // In old versions of Grbl, v0.9 and prior, there is a bug where the `WPos:` work position reported
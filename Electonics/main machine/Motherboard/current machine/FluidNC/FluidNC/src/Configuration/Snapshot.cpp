@@ -0,0 +1,273 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Snapshot.h"
+
+#include "../FileStream.h"
+#include "../Transfer/Crc32.h"  // Transfer::crc32()
+
+#include <algorithm>
+#include <array>
+
+namespace Configuration {
+    enum : uint8_t { Section = 'S', Item = 'I', End = 'E' };
+
+    // SnapshotWriter
+
+    void SnapshotWriter::name(uint8_t tag, const char* name) {
+        size_t len = strlen(name);
+        _out.push_back(tag);
+        _out.push_back(uint8_t(len));
+        _out.insert(_out.end(), name, name + len);
+    }
+
+    void SnapshotWriter::value(const char* name, const void* data, size_t length) {
+        this->name(Item, name);
+        _out.push_back(uint8_t(length));
+        _out.push_back(uint8_t(length >> 8));
+        auto bytes = static_cast<const uint8_t*>(data);
+        _out.insert(_out.end(), bytes, bytes + length);
+    }
+
+    void SnapshotWriter::enterSection(const char* name, Configurable* value) {
+        // A section listed twice in a group() must appear only once, else
+        // reading it back would look like a duplicate section
+        if (std::find(_written.begin(), _written.end(), value) != _written.end()) {
+            return;
+        }
+        _written.push_back(value);
+        this->name(Section, name);
+        value->group(*this);
+        _out.push_back(End);
+    }
+
+    void SnapshotWriter::item(const char* name, bool& value) {
+        uint8_t b = value;
+        this->value(name, &b, 1);
+    }
+    void SnapshotWriter::item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) {
+        this->value(name, &value, sizeof(value));
+    }
+    void SnapshotWriter::item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) {
+        this->value(name, &value, sizeof(value));
+    }
+    void SnapshotWriter::item(const char* name, float& value, const float minValue, const float maxValue) {
+        this->value(name, &value, sizeof(value));
+    }
+    void SnapshotWriter::item(const char* name, std::vector<speedEntry>& value) {
+        this->value(name, value.data(), value.size() * sizeof(speedEntry));
+    }
+    void SnapshotWriter::item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) {
+        uint8_t mode[3] = { uint8_t(wordLength), uint8_t(parity), uint8_t(stopBits) };
+        this->value(name, mode, sizeof(mode));
+    }
+    void SnapshotWriter::item(const char* name, std::string& value, const int minLength, const int maxLength) {
+        this->value(name, value);
+    }
+    void SnapshotWriter::item(const char* name, Pin& value) {
+        this->value(name, value.name());
+    }
+    void SnapshotWriter::item(const char* name, Macro& value) {
+        this->value(name, value.get());
+    }
+    void SnapshotWriter::item(const char* name, IPAddress& value) {
+        uint32_t addr = value;
+        this->value(name, &addr, sizeof(addr));
+    }
+    void SnapshotWriter::item(const char* name, int& value, const EnumItem* e) {
+        int32_t v = value;
+        this->value(name, &v, sizeof(v));
+    }
+
+    // SnapshotReader
+
+    SnapshotReader::SnapshotReader(const uint8_t* data, size_t length) : _pos(data), _end(data + length) {
+        next();
+    }
+
+    void SnapshotReader::next() {
+        _matched = false;
+        _entered = false;
+        if (_pos == _end) {
+            throw SnapshotError("Snapshot truncated");
+        }
+        _tag = *_pos++;
+        if (_tag == End) {
+            return;
+        }
+        if (_pos == _end || _end - _pos < 1 + *_pos) {
+            throw SnapshotError("Snapshot truncated");
+        }
+        size_t len = *_pos++;
+        _name      = std::string_view(reinterpret_cast<const char*>(_pos), len);
+        _pos += len;
+        if (_tag == Section) {
+            return;
+        }
+        if (_tag != Item || _end - _pos < 2) {
+            throw SnapshotError("Snapshot corrupt");
+        }
+        _length = _pos[0] | (_pos[1] << 8);
+        _pos += 2;
+        if (size_t(_end - _pos) < _length) {
+            throw SnapshotError("Snapshot truncated");
+        }
+        _value = _pos;
+        _pos += _length;
+    }
+
+    // Steps past the current record, including everything in it if it is a section
+    void SnapshotReader::skip() {
+        int depth = 0;
+        do {
+            if (_tag == Section) {
+                ++depth;
+            } else if (_tag == End) {
+                --depth;
+            }
+            next();
+        } while (depth > 0);
+    }
+
+    bool SnapshotReader::is(const char* name) {
+        if (_matched || _tag == End || _name != name) {
+            return false;
+        }
+        _matched = true;
+        return true;
+    }
+
+    void SnapshotReader::enterSection(const char* name, Configurable* value) {
+        // The current record is the header of this section
+        next();
+        while (_tag != End) {
+            _matched = false;
+            _entered = false;
+            value->group(*this);
+            if (!_matched) {
+                // The snapshot came from this firmware, so everything in it has a home
+                throw SnapshotError("Snapshot does not match the configuration tree");
+            }
+            if (!_entered) {
+                skip();
+            }
+        }
+        // Step past our End; the caller sees the record after it
+        if (_pos != _end) {
+            next();
+        }
+        _matched = true;
+        _entered = true;
+    }
+
+    void SnapshotReader::item(const char* name, bool& value) {
+        if (is(name)) {
+            value = get<uint8_t>();
+        }
+    }
+    void SnapshotReader::item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) {
+        if (is(name)) {
+            value = get<int32_t>();
+        }
+    }
+    void SnapshotReader::item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) {
+        if (is(name)) {
+            value = get<uint32_t>();
+        }
+    }
+    void SnapshotReader::item(const char* name, float& value, const float minValue, const float maxValue) {
+        if (is(name)) {
+            value = get<float>();
+        }
+    }
+    void SnapshotReader::item(const char* name, std::vector<speedEntry>& value) {
+        if (is(name)) {
+            if (_length % sizeof(speedEntry)) {
+                throw SnapshotError("Snapshot value size mismatch");
+            }
+            value.resize(_length / sizeof(speedEntry));
+            memcpy(value.data(), _value, _length);
+        }
+    }
+    void SnapshotReader::item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) {
+        if (is(name)) {
+            auto mode  = get<std::array<uint8_t, 3>>();
+            wordLength = UartData(mode[0]);
+            parity     = UartParity(mode[1]);
+            stopBits   = UartStop(mode[2]);
+        }
+    }
+    void SnapshotReader::item(const char* name, std::string& value, const int minLength, const int maxLength) {
+        if (is(name)) {
+            value = str();
+        }
+    }
+    void SnapshotReader::item(const char* name, Pin& value) {
+        if (is(name)) {
+            auto pin = Pin::create(str());
+            value.swap(pin);
+        }
+    }
+    void SnapshotReader::item(const char* name, Macro& value) {
+        if (is(name)) {
+            value.set(str());
+        }
+    }
+    void SnapshotReader::item(const char* name, IPAddress& value) {
+        if (is(name)) {
+            value = IPAddress(get<uint32_t>());
+        }
+    }
+    void SnapshotReader::item(const char* name, int& value, const EnumItem* e) {
+        if (is(name)) {
+            value = get<int32_t>();
+        }
+    }
+
+    // Snapshot files
+
+    struct SnapshotHeader {
+        char     magic[4];
+        uint32_t keyLength;
+        uint32_t dataLength;
+        uint32_t crc;  // Of the key and the data
+    };
+    static const char snapshotMagic[4] = { 'F', 'N', 'C', '1' };
+
+    bool saveSnapshot(const std::string& path, const std::string& key, const std::vector<uint8_t>& data) {
+        SnapshotHeader header;
+        memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+        header.keyLength  = key.length();
+        header.dataLength = data.size();
+        header.crc        = Transfer::crc32(reinterpret_cast<const uint8_t*>(key.data()), key.length());
+        header.crc        = Transfer::crc32(data.data(), data.size(), header.crc);
+        try {
+            FileStream file(path, "w", "");
+            return file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+                   file.write(reinterpret_cast<const uint8_t*>(key.data()), key.length()) == key.length() &&
+                   file.write(data.data(), data.size()) == data.size();
+        } catch (...) { return false; }
+    }
+
+    bool loadSnapshot(const std::string& path, const std::string& key, std::vector<uint8_t>& data) {
+        try {
+            FileStream     file(path, "r", "");
+            SnapshotHeader header;
+            if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+                memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) || header.keyLength != key.length() ||
+                sizeof(header) + header.keyLength + header.dataLength != file.size()) {
+                return false;
+            }
+            std::string fileKey(header.keyLength, '\0');
+            if (file.read(fileKey.data(), fileKey.length()) != fileKey.length() || fileKey != key) {
+                return false;
+            }
+            data.resize(header.dataLength);
+            if (file.read(reinterpret_cast<char*>(data.data()), data.size()) != data.size()) {
+                return false;
+            }
+            uint32_t crc = Transfer::crc32(reinterpret_cast<const uint8_t*>(key.data()), key.length());
+            return Transfer::crc32(data.data(), data.size(), crc) == header.crc;
+        } catch (...) { return false; }
+    }
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "HandlerBase.h"
+#include "Configurable.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A snapshot is the parsed configuration tree in a compact binary form, so
+// that a later boot can rebuild the tree without tokenizing the YAML.  It is
+// a sequence of records:
+//
+//   'S' <name>                         start of a section
+//   'I' <name> <u16 length> <value>    an item
+//   'E'                                end of the current section
+//
+// where <name> is a length byte followed by the characters.  Values are
+// little-endian binary; strings and pins are stored as their text.
+//
+// SnapshotWriter walks the tree like the Generator.  SnapshotReader builds
+// a tree like the ParserHandler, taking one record at a time instead of one
+// token, so factories and sections are created exactly as when parsing.
+
+namespace Configuration {
+    class SnapshotError : public std::runtime_error {
+    public:
+        SnapshotError(const char* what) : std::runtime_error(what) {}
+    };
+
+    class SnapshotWriter : public HandlerBase {
+        std::vector<uint8_t>&      _out;
+        std::vector<Configurable*> _written;
+
+        void name(uint8_t tag, const char* name);
+        void value(const char* name, const void* data, size_t length);
+        void value(const char* name, std::string_view str) { value(name, str.data(), str.length()); }
+
+    protected:
+        bool        matchesUninitialized(const char* name) override { return false; }
+        HandlerType handlerType() override { return HandlerType::Snapshot; }
+
+    public:
+        SnapshotWriter(std::vector<uint8_t>& out) : _out(out) {}
+
+        void enterSection(const char* name, Configurable* value) override;
+
+        void item(const char* name, bool& value) override;
+        void item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) override;
+        void item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) override;
+        void item(const char* name, float& value, const float minValue, const float maxValue) override;
+        void item(const char* name, std::vector<speedEntry>& value) override;
+        void item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) override;
+        void item(const char* name, std::string& value, const int minLength, const int maxLength) override;
+        void item(const char* name, Pin& value) override;
+        void item(const char* name, Macro& value) override;
+        void item(const char* name, IPAddress& value) override;
+        void item(const char* name, int& value, const EnumItem* e) override;
+    };
+
+    class SnapshotReader : public HandlerBase {
+        const uint8_t* _pos;
+        const uint8_t* _end;
+
+        // The current record
+        uint8_t          _tag;
+        std::string_view _name;
+        const uint8_t*   _value;
+        size_t           _length;
+
+        bool _matched;  // The current record was claimed by an item or section
+        bool _entered;  // ... and it was a section, now fully consumed
+
+        void next();
+        void skip();
+        bool is(const char* name);
+
+        template <typename T>
+        T get() {
+            T value;
+            if (_length != sizeof(value)) {
+                throw SnapshotError("Snapshot value size mismatch");
+            }
+            memcpy(&value, _value, sizeof(value));
+            return value;
+        }
+        std::string_view str() { return std::string_view(reinterpret_cast<const char*>(_value), _length); }
+
+    protected:
+        bool        matchesUninitialized(const char* name) override { return is(name); }
+        HandlerType handlerType() override { return HandlerType::Parser; }
+
+    public:
+        SnapshotReader(const uint8_t* data, size_t length);
+
+        // Reads the top-level section, which must be the current record
+        void enterSection(const char* name, Configurable* value) override;
+
+        void item(const char* name, bool& value) override;
+        void item(const char* name, int32_t& value, const int32_t minValue, const int32_t maxValue) override;
+        void item(const char* name, uint32_t& value, const uint32_t minValue, const uint32_t maxValue) override;
+        void item(const char* name, float& value, const float minValue, const float maxValue) override;
+        void item(const char* name, std::vector<speedEntry>& value) override;
+        void item(const char* name, UartData& wordLength, UartParity& parity, UartStop& stopBits) override;
+        void item(const char* name, std::string& value, const int minLength, const int maxLength) override;
+        void item(const char* name, Pin& value) override;
+        void item(const char* name, Macro& value) override;
+        void item(const char* name, IPAddress& value) override;
+        void item(const char* name, int& value, const EnumItem* e) override;
+    };
+
+    // Stores a snapshot in a file along with a key identifying what it was
+    // made from, and loads it back only if the key still matches.
+    bool saveSnapshot(const std::string& path, const std::string& key, const std::vector<uint8_t>& data);
+    bool loadSnapshot(const std::string& path, const std::string& key, std::vector<uint8_t>& data);
+}
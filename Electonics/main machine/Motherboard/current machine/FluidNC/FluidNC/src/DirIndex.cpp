@@ -0,0 +1,144 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "DirIndex.h"
+
+#include <algorithm>
+#include <sys/stat.h>
+
+std::list<DirIndex::Dir> DirIndex::_dirs;
+std::mutex               DirIndex::_mutex;
+uint32_t                 DirIndex::_generation = 0;
+
+// Paths from FluidPath can end with a separator; the index does not care
+std::string DirIndex::key(const std::filesystem::path& path) {
+    std::string k = path.lexically_normal().string();
+    while (k.length() > 1 && k.back() == '/') {
+        k.pop_back();
+    }
+    return k;
+}
+
+// One stat() gives everything, where directory_entry would take two
+bool DirIndex::entryFor(const std::filesystem::path& path, Entry& entry) {
+    struct stat st;
+    if (::stat(path.c_str(), &st)) {
+        return false;
+    }
+    entry.name  = path.filename();
+    entry.size  = S_ISDIR(st.st_mode) ? -1 : int32_t(st.st_size);
+    entry.mtime = st.st_mtime;
+    return true;
+}
+
+// Drops the listing of prefix and of every directory below it
+void DirIndex::forget(const std::string& prefix) {
+    _dirs.remove_if([&prefix](const Dir& dir) {
+        return dir.path.compare(0, prefix.length(), prefix) == 0 && (dir.path.length() == prefix.length() || dir.path[prefix.length()] == '/');
+    });
+}
+
+void DirIndex::mounted(const std::string& volume) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+    forget(volume);
+}
+
+void DirIndex::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+    _dirs.clear();
+}
+
+void DirIndex::list(const std::filesystem::path& dir, const std::function<void(const Entry&)>& each, std::error_code& ec) {
+    ec.clear();
+    auto k = key(dir);
+
+    std::vector<Entry> entries;
+    bool               indexed = false;
+    uint32_t           generation;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _dirs.begin(); it != _dirs.end(); ++it) {
+            if (it->path == k) {
+                _dirs.splice(_dirs.begin(), _dirs, it);
+                entries = it->entries;
+                indexed = true;
+                break;
+            }
+        }
+        generation = _generation;
+    }
+    if (indexed) {
+        for (auto const& entry : entries) {
+            each(entry);
+        }
+        return;
+    }
+
+    auto iter = std::filesystem::directory_iterator { dir, ec };
+    if (ec) {
+        return;
+    }
+    bool fits = true;
+    for (auto const& dir_entry : iter) {
+        Entry entry;
+        if (!entryFor(dir_entry.path(), entry)) {
+            continue;
+        }
+        each(entry);
+        if (fits) {
+            if (entries.size() < maxEntries) {
+                entries.push_back(std::move(entry));
+            } else {
+                // Too big to keep; it will be read each time
+                fits = false;
+                std::vector<Entry>().swap(entries);
+            }
+        }
+    }
+    if (fits) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (generation == _generation) {
+            forget(k);  // In case another task indexed it meanwhile
+            _dirs.push_front({ k, std::move(entries) });
+            if (_dirs.size() > maxDirs) {
+                _dirs.pop_back();
+            }
+        }
+    }
+}
+
+void DirIndex::update(const std::filesystem::path& path) {
+    auto k = key(path);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_generation;
+
+    // If path was a directory, its contents went with it
+    forget(k);
+
+    auto parent = key(std::filesystem::path(k).parent_path());
+    for (auto it = _dirs.begin(); it != _dirs.end(); ++it) {
+        if (it->path != parent) {
+            continue;
+        }
+        auto& entries = it->entries;
+        auto  name    = std::filesystem::path(k).filename().string();
+        auto  old     = std::find_if(entries.begin(), entries.end(), [&name](const Entry& e) { return e.name == name; });
+
+        Entry entry;
+        if (!entryFor(k, entry)) {
+            if (old != entries.end()) {
+                entries.erase(old);
+            }
+        } else if (old != entries.end()) {
+            *old = std::move(entry);
+        } else if (entries.size() < maxEntries) {
+            entries.push_back(std::move(entry));
+        } else {
+            _dirs.erase(it);
+        }
+        return;
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// DirIndex keeps the listings of recently browsed directories in RAM, so
+// that browsing the SD card from the WebUI does not read the card, and so
+// does not compete with a running job for the SPI bus.
+//
+// The firmware reports the changes it makes with update(), and listings
+// are patched in place.  Changes made elsewhere, such as on a PC, can only
+// happen while the card is unmounted, so mounted() drops a volume's
+// listings and the next list() reads every entry's size and mtime afresh.
+// A running job keeps the card mounted, which is when the index matters.
+//
+// list() runs in the polling task and update() mostly in the protocol
+// task, so every entry point takes _mutex.  Callbacks run without it.
+
+class DirIndex {
+public:
+    struct Entry {
+        std::string name;
+        int32_t     size;  // -1 for a directory
+        time_t      mtime;
+    };
+
+    // Calls each() for every entry in dir, from RAM if dir is indexed, else
+    // by reading the directory and indexing it if it is not too large
+    static void list(const std::filesystem::path& dir, const std::function<void(const Entry&)>& each, std::error_code& ec);
+
+    // Reports that path was created, written, deleted or renamed away
+    static void update(const std::filesystem::path& path);
+    static void rename(const std::filesystem::path& from, const std::filesystem::path& to) {
+        update(from);
+        update(to);
+    }
+
+    // Reports that the volume, e.g. "/sd", was mounted
+    static void mounted(const std::string& volume);
+
+    static void clear();
+
+private:
+    static const size_t maxDirs    = 8;
+    static const size_t maxEntries = 256;
+
+    struct Dir {
+        std::string        path;
+        std::vector<Entry> entries;
+    };
+    static std::list<Dir> _dirs;  // Most recently used first
+
+    static std::mutex _mutex;
+
+    // Counts changes, so that a listing read while one was made, and which
+    // might have missed it, is not kept
+    static uint32_t _generation;
+
+    static std::string key(const std::filesystem::path& path);
+    static bool        entryFor(const std::filesystem::path& path, Entry& entry);
+    static void        forget(const std::string& prefix);
+};
@@ -88,6 +88,9 @@ enum class Error : uint8_t {
     ExpressionUnknownOp               = 173,
     ExpressionArgumentOutOfRange      = 174,
     ExpressionSyntaxError             = 175,
+    FlowControlSyntaxError            = 176,
+    FlowControlNotExecutingMacro      = 177,
+    FlowControlStackOverflow          = 179,
     GcodeToolChangeRequiresToolNumber = 180,
     GcodeUnsupportedToolNumber        = 181,
     GcodeToolChangeFailed             = 182
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unordered_map>
 
 #define DEGRAD (180 / M_PI)
 #define RADDEG (M_PI / 180)
@@ -254,7 +255,7 @@ static Error execute_unary(float& operand, ngc_unary_op_t operation) {
             break;
 
         case NGCUnaryOp_Exists:
-            // do nothing here, result for the EXISTS function is set by read_unary()
+            // do nothing here, EXISTS is evaluated by Expression::evaluate()
             break;
 
         case NGCUnaryOp_EXP:
@@ -571,45 +572,84 @@ static Error read_operation_unary(const char* line, size_t* pos, ngc_unary_op_t*
     return status;
 }
 
-/*! \brief Reads a slash and the second argument to the ATAN function,
-starting at the index given by the pos offset. Then it computes the value
-of the ATAN operation applied to the two arguments.
-
-\param line pointer to RS274/NGC code (block).
-\param pos offset into line where expression starts.
-\param value pointer to float where result is to be stored.
-\returns #Error::Ok enum value if processed without error, appropriate \ref Error enum value if not.
-*/
-static Error read_atan(const char* line, size_t* pos, float& value) {
-    float argument2;
+void Expression::emit(Op op, uint8_t code, uint16_t index, float value) {
+    _code.push_back({ op, code, index, value });
+    switch (op) {
+        case Op::Constant:
+        case Op::Param:
+        case Op::Exists:
+            ++_depth;
+            break;
+        case Op::Binary:
+        case Op::Atan:
+            --_depth;
+            break;
+        default:
+            break;
+    }
+}
 
-    if (line[*pos] != '/')
-        return Error::ExpressionSyntaxError;  // Slash missing after first ATAN argument
+/*! \brief Compiles a parameter reference, with the # already consumed.
 
-    (*pos)++;
+The forms are #<name>, #number, ##... (the parameter whose number is the
+value of another) and #[expression].
+*/
+Error Expression::param(const char* line, size_t* pos) {
+    Error status;
+    char  c = line[*pos];
 
-    if (line[*pos] != '[')
-        return Error::ExpressionSyntaxError;  // Left bracket missing after slash with ATAN;
+    switch (c) {
+        case '#':
+            ++*pos;
+            if ((status = param(line, pos)) != Error::Ok) {
+                return status;
+            }
+            emit(Op::Indirect);
+            return Error::Ok;
 
-    Error status;
+        case '[':
+            if ((status = bracket(line, pos)) != Error::Ok) {
+                return status;
+            }
+            emit(Op::Indirect);
+            return Error::Ok;
 
-    if ((status = expression(line, pos, argument2)) == Error::Ok)
-        value = atan2f(value, argument2) * DEGRAD; /* value in radians, convert to degrees */
+        case '<': {
+            param_ref_t ref;
+            ++*pos;
+            while ((c = line[*pos]) && c != '>') {
+                ++*pos;
+                ref.name += c;
+            }
+            if (!c) {
+                return Error::BadNumberFormat;
+            }
+            ++*pos;
+            if (ref.name.length() && ref.name[0] != '/') {
+                ref.slot = param_slot(ref.name);
+            }
+            _params.push_back(std::move(ref));
+            emit(Op::Param, 0, _params.size() - 1);
+            return Error::Ok;
+        }
 
-    return status;
+        default: {
+            float id;
+            if (!read_float(line, pos, id)) {
+                return Error::BadNumberFormat;
+            }
+            param_ref_t ref;
+            ref.id = id;
+            _params.push_back(std::move(ref));
+            emit(Op::Param, 0, _params.size() - 1);
+            return Error::Ok;
+        }
+    }
 }
 
-/*! \brief Reads the value out of an unary operation of the line, starting at the
-index given by the pos offset. The ATAN operation is
-handled specially because it is followed by two arguments.
-
-\param line pointer to RS274/NGC code (block).
-\param pos offset into line where expression starts.
-\param value pointer to float where result is to be stored.
-\returns #Error::Ok enum value if processed without error, appropriate \ref Error enum value if not.
+/*! \brief Compiles a unary function such as SIN[...], ATAN[...]/[...] or EXISTS[...].
 */
-// cppcheck-suppress unusedFunction
-Error read_unary(const char* line, size_t* pos, float& value) {
+Error Expression::function(const char* line, size_t* pos) {
     ngc_unary_op_t operation;
     Error          status;
 
@@ -631,72 +671,223 @@ Error read_unary(const char* line, size_t* pos, float& value) {
             return Error::ExpressionSyntaxError;
         }
         ++*pos;
-        value = named_param_exists(arg) ? 1.0 : 0.0;
+        _names.push_back(std::move(arg));
+        emit(Op::Exists, 0, _names.size() - 1);
         return Error::Ok;
     }
-    if ((status = expression(line, pos, value)) != Error::Ok) {
+    if ((status = bracket(line, pos)) != Error::Ok) {
         return status;
     }
     if (operation == NGCUnaryOp_ATAN) {
-        return read_atan(line, pos, value);
+        if (line[*pos] != '/') {
+            return Error::ExpressionSyntaxError;  // Slash missing after first ATAN argument
+        }
+        ++*pos;
+        if (line[*pos] != '[') {
+            return Error::ExpressionSyntaxError;  // Left bracket missing after slash with ATAN
+        }
+        if ((status = bracket(line, pos)) != Error::Ok) {
+            return status;
+        }
+        emit(Op::Atan);
+        return Error::Ok;
     }
-    return execute_unary(value, operation);
+    emit(Op::Unary, operation);
+    return Error::Ok;
 }
 
-/*! \brief Evaluate expression and set result if successful.
-
-\param line pointer to RS274/NGC code (block).
-\param pos offset into line where expression starts.
-\param value pointer to float where result is to be stored.
-\returns #Error::Ok enum value if evaluated without error, appropriate \ref Error enum value if not.
+/*! \brief Compiles one operand of a binary operation: a number, a parameter,
+a bracketed expression, a function or a signed operand.
 */
-Error expression(const char* line, size_t* pos, float& value) {
-    float           values[MAX_STACK];
-    ngc_binary_op_t operators[MAX_STACK];
-    uint_fast8_t    stack_index = 1;
+Error Expression::operand(const char* line, size_t* pos) {
+    Error status;
+    char  c = line[*pos];
 
-    if (line[*pos] != '[')
-        return Error::GcodeUnsupportedCommand;
+    if (c == '#') {
+        ++*pos;
+        status = param(line, pos);
+    } else if (c == '[') {
+        status = bracket(line, pos);
+    } else if (isalpha(c)) {
+        // Functions are available only inside expressions because
+        // their names conflict with GCode words
+        status = function(line, pos);
+    } else if (c == '-') {
+        ++*pos;
+        if ((status = operand(line, pos)) == Error::Ok) {
+            emit(Op::Negate);
+        }
+    } else if (c == '+') {
+        ++*pos;
+        status = operand(line, pos);
+    } else {
+        float value;
+        if (!read_float(line, pos, value)) {
+            return Error::BadNumberFormat;
+        }
+        emit(Op::Constant, 0, 0, value);
+        status = Error::Ok;
+    }
+    if (status == Error::Ok && _depth > maxDepth) {
+        status = Error::ExpressionSyntaxError;  // Too deeply nested
+    }
+    return status;
+}
 
-    (*pos)++;
+/*! \brief Compiles a bracketed expression.
 
-    Error status;
+Operators are held back until one of no higher precedence follows, so they
+are emitted in the order in which the evaluator of old applied them; all
+binary operators are left associative.  ] has the lowest precedence, so it
+emits everything that is pending.
+*/
+Error Expression::bracket(const char* line, size_t* pos) {
+    ngc_binary_op_t pending[MAX_STACK];
+    int             n_pending = 0;
+    Error           status;
 
-    if ((!read_number(line, pos, values[0], true)))
-        return Error::BadNumberFormat;
+    if (line[*pos] != '[') {
+        return Error::GcodeUnsupportedCommand;
+    }
+    ++*pos;
 
-    if ((status = read_operation(line, pos, operators)) != Error::Ok)
+    if ((status = operand(line, pos)) != Error::Ok) {
         return status;
+    }
+    for (;;) {
+        ngc_binary_op_t operation;
+        if ((status = read_operation(line, pos, &operation)) != Error::Ok) {
+            return status;
+        }
+        while (n_pending && precedence(operation) <= precedence(pending[n_pending - 1])) {
+            emit(Op::Binary, pending[--n_pending]);
+        }
+        if (operation == NGCBinaryOp_RightBracket) {
+            return Error::Ok;
+        }
+        if (n_pending == MAX_STACK) {
+            return Error::ExpressionSyntaxError;  // Too many operators of rising precedence
+        }
+        pending[n_pending++] = operation;
+        if ((status = operand(line, pos)) != Error::Ok) {
+            return status;
+        }
+    }
+}
 
-    for (; operators[0] != NGCBinaryOp_RightBracket;) {
-        if ((!read_number(line, pos, values[stack_index], true)))
-            return Error::BadNumberFormat;
+Error Expression::compile(const char* line, size_t* pos) {
+    _code.clear();
+    _params.clear();
+    _names.clear();
+    _depth = 0;
 
-        if ((status = read_operation(line, pos, operators + stack_index)) != Error::Ok)
-            return status;
+    Error status = bracket(line, pos);
+    if (status != Error::Ok) {
+        _code.clear();
+    }
+    return status;
+}
 
-        if (precedence(operators[stack_index]) > precedence(operators[stack_index - 1]))
-            stack_index++;
-        else {  // precedence of latest operator is <= previous precedence
-            for (; precedence(operators[stack_index]) <= precedence(operators[stack_index - 1]);) {
-                if ((status = execute_binary(values[stack_index - 1], operators[stack_index - 1], values[stack_index])) != Error::Ok)
-                    return status;
+Error Expression::evaluate(float& value) const {
+    float stack[maxDepth];
+    int   sp = 0;
+    Error status;
 
-                operators[stack_index - 1] = operators[stack_index];
-                // auto o1 = operators[stack_index - 1];
-                // auto o2 = operators[stack_index - 2];
-                // auto p1 = precedence(o1);
-                // auto p2 = precedence(o1);
-                // if ((stack_index > 1) && p1 <= p2)
-                if ((stack_index > 1) && precedence(operators[stack_index - 1]) <= precedence(operators[stack_index - 2]))
-                    stack_index--;
-                else
-                    break;
-            }
+    for (auto const& insn : _code) {
+        switch (insn.op) {
+            case Op::Constant:
+                stack[sp++] = insn.value;
+                break;
+            case Op::Param:
+                if (!get_param(_params[insn.index], stack[sp++])) {
+                    return Error::BadNumberFormat;
+                }
+                break;
+            case Op::Indirect: {
+                param_ref_t ref;
+                ref.id = stack[sp - 1];
+                if (!get_param(ref, stack[sp - 1])) {
+                    return Error::BadNumberFormat;
+                }
+            } break;
+            case Op::Negate:
+                stack[sp - 1] = -stack[sp - 1];
+                break;
+            case Op::Binary:
+                --sp;
+                if ((status = execute_binary(stack[sp - 1], ngc_binary_op_t(insn.code), stack[sp])) != Error::Ok) {
+                    return status;
+                }
+                break;
+            case Op::Unary:
+                if ((status = execute_unary(stack[sp - 1], ngc_unary_op_t(insn.code))) != Error::Ok) {
+                    return status;
+                }
+                break;
+            case Op::Atan:
+                --sp;
+                stack[sp - 1] = atan2f(stack[sp - 1], stack[sp]) * DEGRAD; /* value in radians, convert to degrees */
+                break;
+            case Op::Exists: {
+                std::string name = _names[insn.index];
+                stack[sp++]      = named_param_exists(name) ? 1.0 : 0.0;
+            } break;
         }
     }
+    value = stack[0];
+    return Error::Ok;
+}
 
-    value = values[0];
+// Recently compiled expressions, by their text.  A job rarely has more
+// distinct expressions in play than this; when it does, the cache starts over.
+static std::unordered_map<std::string, Expression> compiled;
+static const size_t                                maxCompiled = 32;
 
-    return Error::Ok;
+/*! \brief Evaluate expression and set result if successful.
+
+\param line pointer to RS274/NGC code (block).
+\param pos offset into line where expression starts.
+\param value pointer to float where result is to be stored.
+\returns #Error::Ok enum value if evaluated without error, appropriate \ref Error enum value if not.
+*/
+Error expression(const char* line, size_t* pos, float& value) {
+    if (line[*pos] != '[') {
+        return Error::GcodeUnsupportedCommand;
+    }
+
+    // The text up to the matching ] is the key
+    size_t end   = *pos;
+    int    depth = 0;
+    do {
+        switch (line[end++]) {
+            case '\0':
+                return Error::ExpressionSyntaxError;
+            case '[':
+                ++depth;
+                break;
+            case ']':
+                --depth;
+                break;
+        }
+    } while (depth);
+
+    std::string text(line + *pos, end - *pos);
+    auto        it = compiled.find(text);
+    if (it == compiled.end()) {
+        Expression expr;
+        size_t     compiledEnd = *pos;
+        Error      status      = expr.compile(line, &compiledEnd);
+        if (status != Error::Ok) {
+            return status;
+        }
+        if (compiledEnd != end) {
+            return Error::ExpressionSyntaxError;
+        }
+        if (compiled.size() >= maxCompiled) {
+            compiled.clear();
+        }
+        it = compiled.emplace(std::move(text), std::move(expr)).first;
+    }
+    *pos = end;
+    return it->second.evaluate(value);
 }
@@ -1,3 +1,58 @@
 #pragma once
+
+#include "Error.h"
+#include "Parameters.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An expression compiled from its [...] text into a small stack program, so
+// that evaluating it again does not mean parsing it again.  Parameters are
+// bound when the expression is compiled - named ones by slot and numbered
+// ones by id - but their values are fetched each time it is evaluated.
+class Expression {
+public:
+    // Compiles the expression at line[*pos], which must start with [,
+    // leaving *pos after the matching ]
+    Error compile(const char* line, size_t* pos);
+    Error evaluate(float& value) const;
+
+    bool empty() const { return _code.empty(); }
+
+private:
+    enum class Op : uint8_t {
+        Constant,  // Push value
+        Param,     // Push the parameter _params[index]
+        Indirect,  // Replace the top with the numbered parameter it names
+        Negate,
+        Binary,  // code is an ngc_binary_op_t
+        Unary,   // code is an ngc_unary_op_t
+        Atan,    // ATAN[y]/[x]
+        Exists,  // Push EXISTS[_names[index]]
+    };
+    struct Insn {
+        Op       op;
+        uint8_t  code;
+        uint16_t index;
+        float    value;
+    };
+
+    static const int maxDepth = 16;
+
+    std::vector<Insn>        _code;
+    std::vector<param_ref_t> _params;
+    std::vector<std::string> _names;
+    int                      _depth = 0;  // While compiling, the stack depth reached
+
+    void  emit(Op op, uint8_t code = 0, uint16_t index = 0, float value = 0.0f);
+    Error bracket(const char* line, size_t* pos);
+    Error operand(const char* line, size_t* pos);
+    Error param(const char* line, size_t* pos);
+    Error function(const char* line, size_t* pos);
+};
+
+// Evaluates the expression at line[*pos].  Compiled forms of the expressions
+// seen most recently are kept, keyed by their text, so an expression in a
+// loop body is parsed only once.
 Error expression(const char* line, size_t* pos, float& value);
-Error read_unary(const char* line, size_t* pos, float& value);
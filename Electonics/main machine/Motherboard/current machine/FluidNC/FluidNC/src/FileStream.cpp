@@ -3,6 +3,7 @@
 
 #include "FileStream.h"
 #include "Machine/MachineConfig.h"  // config->
+#include "DirIndex.h"
 
 std::string FileStream::path() {
     return _fpath.c_str();
@@ -83,8 +84,16 @@ void FileStream::restore() {
     }
 }
 
+void FileStream::seek(size_t position, size_t lineNumber) {
+    fseek(_fd, position, SEEK_SET);
+    _line_number = lineNumber;
+}
+
 FileStream::~FileStream() {
     if (_fd) {
         fclose(_fd);
+        if (*_mode != 'r') {
+            DirIndex::update(_fpath);
+        }
     }
 }
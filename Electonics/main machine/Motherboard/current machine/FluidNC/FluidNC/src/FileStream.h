@@ -63,6 +63,10 @@ public:
     void save() override;
     void restore() override;
 
+    bool   seekable() override { return _fd != nullptr; }
+    size_t tell() override { return position(); }
+    void   seek(size_t position, size_t lineNumber) override;
+
     // Operator to check if the file is open
     operator bool() const { return _fd != nullptr; }
 
@@ -0,0 +1,441 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "FlowControl.h"
+
+#include "Job.h"
+#include "Logging.h"
+#include "Parameters.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+// In the order of FlowControl::Word
+static const char* wordNames[] = { "SUB",    "ENDSUB", "RETURN", "CALL",  "DO",    "WHILE", "ENDWHILE", "REPEAT",
+                                   "ENDREPEAT", "IF", "ELSEIF", "ELSE", "ENDIF", "BREAK", "CONTINUE" };
+
+static uint32_t bit(int word) {
+    return 1 << word;
+}
+
+bool is_flowcontrol(const char* line) {
+    while (isspace(*line)) {
+        ++line;
+    }
+    return *line == 'O' || *line == 'o';
+}
+
+bool is_program_number(const char* line) {
+    if (line[0] != 'O') {
+        return false;
+    }
+    const char* p = line + 1;
+    if (*p == '<') {
+        p = strchr(p, '>');
+        if (!p) {
+            return false;
+        }
+        ++p;
+    } else {
+        if (!isdigit(*p)) {
+            return false;
+        }
+        while (isdigit(*p)) {
+            ++p;
+        }
+    }
+    return *p == '\0';
+}
+
+// Reads the label and the word after the O
+static bool parse(const char* line, size_t* pos, std::string& label, int& word) {
+    if (line[*pos] == '<') {
+        const char* end = strchr(line + *pos, '>');
+        if (!end) {
+            return false;
+        }
+        size_t len = end + 1 - (line + *pos);
+        label.assign(line + *pos, len);
+        *pos += len;
+    } else {
+        if (!isdigit(line[*pos])) {
+            return false;
+        }
+        char* end;
+        label = std::to_string(strtol(line + *pos, &end, 10));
+        *pos  = end - line;
+    }
+
+    size_t start = *pos;
+    while (isalpha(line[*pos])) {
+        ++*pos;
+    }
+    size_t len = *pos - start;
+    for (word = 0; word < int(sizeof(wordNames) / sizeof(wordNames[0])); word++) {
+        if (strlen(wordNames[word]) == len && !strncmp(line + start, wordNames[word], len)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FlowControl::Mark FlowControl::here() {
+    auto channel = Job::channel();
+    return { channel->tell(), channel->lineNumber() };
+}
+
+void FlowControl::seek(const Mark& mark) {
+    Job::channel()->seek(mark.position, mark.lineNumber);
+}
+
+Error FlowControl::condition(const char* line, size_t* pos, bool& result) {
+    float value;
+    Error status = expression(line, pos, value);
+    result       = value != 0.0f;
+    return status;
+}
+
+// The innermost loop with the label, not looking past a call
+FlowControl::Frame* FlowControl::find(const std::string& label, bool loop) {
+    for (auto it = _frames.rbegin(); it != _frames.rend(); ++it) {
+        if (it->word == Call && (loop || it->label != label)) {
+            return nullptr;
+        }
+        if (it->label == label) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+// Passes over the rest of the block opened at key.  Blocks are known by where
+// they open, not by label, because a label can be used again later on.
+void FlowControl::skip(const std::string& label, size_t key, uint32_t until) {
+    _skipping  = true;
+    _skipLabel = label;
+    _skipKey   = key;
+    _skipUntil = until;
+
+    // Once the end of the block has been seen, there is no need to read up to it
+    for (auto word : { EndSub, EndWhile, EndRepeat, EndIf }) {
+        if (until == bit(word)) {
+            auto end = _ends.find(key);
+            if (end != _ends.end()) {
+                seek(end->second);
+                size_t pos = 0;
+                endSkip(word, "", &pos);
+            }
+            return;
+        }
+    }
+}
+
+// Runs the line that ends a skip.  pos is after its word.
+Error FlowControl::endSkip(Word word, const char* line, size_t* pos) {
+    _skipping = false;
+
+    switch (word) {
+        case EndSub:
+        case EndWhile:
+        case EndRepeat:
+            _ends[_skipKey] = here();
+            return Error::Ok;
+
+        case EndIf:
+            _ends[_skipKey] = here();
+            _frames.pop_back();
+            return Error::Ok;
+
+        case Else:
+            _frames.back().taken = true;
+            return Error::Ok;
+
+        case ElseIf: {
+            bool  result;
+            Error status = condition(line, pos, result);
+            if (status != Error::Ok) {
+                return status;
+            }
+            if (result) {
+                _frames.back().taken = true;
+            } else {
+                _skipping = true;
+            }
+            return Error::Ok;
+        }
+
+        case While:
+            // The end of a do loop, reached by break or continue.  After a
+            // break the loop is gone; after a continue it is still there.
+            if (!_frames.empty() && _frames.back().word == Do && _frames.back().label == _skipLabel) {
+                return execute(line);
+            }
+            return Error::Ok;
+
+        default:
+            return Error::Ok;
+    }
+}
+
+// Ends one pass of a loop.  If there is to be another, the read position
+// goes back to the start of the body, else the loop is dropped.
+Error FlowControl::again(Frame& frame) {
+    bool more;
+    if (frame.word == Repeat) {
+        more = --frame.count > 0;
+    } else {
+        float value;
+        Error status = frame.condition.evaluate(value);
+        if (status != Error::Ok) {
+            return status;
+        }
+        more = value != 0.0f;
+    }
+    if (more) {
+        seek(frame.start);
+    } else {
+        _frames.pop_back();
+    }
+    return Error::Ok;
+}
+
+// Returns from the call of subroutine label, dropping any blocks inside it
+Error FlowControl::leave(const std::string& label, const char* line, size_t* pos) {
+    auto frame = find(label, false);
+    if (!frame || frame->word != Call) {
+        log_error("O" << label << " return outside of a call");
+        return Error::FlowControlSyntaxError;
+    }
+    if (line[*pos] == '[') {
+        float value;
+        Error status = expression(line, pos, value);
+        if (status != Error::Ok) {
+            return status;
+        }
+        set_named_param("_VALUE", value);
+    }
+    std::copy(frame->saved.begin(), frame->saved.end(), call_params);
+    Mark back = frame->start;
+    _frames.erase(_frames.begin() + (frame - _frames.data()), _frames.end());
+    seek(back);
+    return Error::Ok;
+}
+
+Error FlowControl::execute(const char* line) {
+    if (is_program_number(line)) {
+        return _skipping ? Error::Ok : Error::GcodeUnsupportedCommand;
+    }
+
+    size_t      pos = 1;
+    std::string label;
+    int         parsed;
+    if (line[0] != 'O' || !parse(line, &pos, label, parsed)) {
+        log_error("Bad O-word line " << line);
+        return Error::FlowControlSyntaxError;
+    }
+    Word word = Word(parsed);
+
+    if (!Job::active() || !Job::channel()->seekable()) {
+        return Error::FlowControlNotExecutingMacro;
+    }
+
+    if (_skipping) {
+        if (label != _skipLabel || !(_skipUntil & bit(word))) {
+            return Error::Ok;
+        }
+        return endSkip(word, line, &pos);
+    }
+
+    Error status = Error::Ok;
+    auto  top    = _frames.empty() ? nullptr : &_frames.back();
+    bool  inside = top && top->label == label;  // The line belongs to the innermost block
+
+    bool opens = word == Call || word == Do || (word == While && !(inside && top->word == Do)) || word == Repeat || word == If;
+    if (opens && _frames.size() == maxFrames) {
+        return Error::FlowControlStackOverflow;
+    }
+
+    switch (word) {
+        case Sub: {
+            // Loops can read a definition more than once, but only from one place
+            Mark body = here();
+            auto sub  = _subs.find(label);
+            if (sub != _subs.end() && sub->second.position != body.position) {
+                log_error("O" << label << " sub is already defined");
+                return Error::FlowControlSyntaxError;
+            }
+            _subs[label] = body;
+            skip(label, body.position, bit(EndSub));
+            return Error::Ok;
+        }
+
+        case Call: {
+            auto sub = _subs.find(label);
+            if (sub == _subs.end()) {
+                log_error("O" << label << " sub is not defined");
+                return Error::FlowControlSyntaxError;
+            }
+            float args[n_call_params] = { 0.0f };
+            int   nargs               = 0;
+            while (line[pos] == '[') {
+                if (nargs == n_call_params) {
+                    return Error::FlowControlSyntaxError;
+                }
+                if ((status = expression(line, &pos, args[nargs++])) != Error::Ok) {
+                    return status;
+                }
+            }
+            Frame frame;
+            frame.label = label;
+            frame.word  = Call;
+            frame.start = here();
+            frame.saved.assign(call_params, call_params + n_call_params);
+            _frames.push_back(std::move(frame));
+            std::copy(args, args + n_call_params, call_params);
+            seek(sub->second);
+            return Error::Ok;
+        }
+
+        case EndSub:
+        case Return:
+            return leave(label, line, &pos);
+
+        case Do: {
+            Frame frame;
+            frame.label = label;
+            frame.word   = Do;
+            frame.start  = here();
+            frame.opened = frame.start.position;
+            _frames.push_back(std::move(frame));
+            return Error::Ok;
+        }
+
+        case While: {
+            if (inside && top->word == Do) {
+                // The end of a do loop; the condition is compiled on the first pass
+                if (top->condition.empty() && (status = top->condition.compile(line, &pos)) != Error::Ok) {
+                    return status;
+                }
+                _ends[top->opened] = here();
+                return again(*top);
+            }
+            Frame frame;
+            frame.label  = label;
+            frame.word   = While;
+            frame.start  = here();
+            frame.opened = frame.start.position;
+            if ((status = frame.condition.compile(line, &pos)) != Error::Ok) {
+                return status;
+            }
+            float value;
+            if ((status = frame.condition.evaluate(value)) != Error::Ok) {
+                return status;
+            }
+            if (value == 0.0f) {
+                skip(label, frame.opened, bit(EndWhile));
+                return Error::Ok;
+            }
+            _frames.push_back(std::move(frame));
+            return Error::Ok;
+        }
+
+        case Repeat: {
+            float count;
+            if ((status = expression(line, &pos, count)) != Error::Ok) {
+                return status;
+            }
+            Mark body = here();
+            if (count < 1.0f) {
+                skip(label, body.position, bit(EndRepeat));
+                return Error::Ok;
+            }
+            Frame frame;
+            frame.label  = label;
+            frame.word   = Repeat;
+            frame.start  = body;
+            frame.opened = body.position;
+            frame.count  = count;
+            _frames.push_back(std::move(frame));
+            return Error::Ok;
+        }
+
+        case EndWhile:
+        case EndRepeat:
+            if (!inside || top->word != (word == EndWhile ? While : Repeat)) {
+                break;
+            }
+            _ends[top->opened] = here();
+            return again(*top);
+
+        case If: {
+            bool result;
+            if ((status = condition(line, &pos, result)) != Error::Ok) {
+                return status;
+            }
+            Frame frame;
+            frame.label  = label;
+            frame.word   = If;
+            frame.taken  = result;
+            frame.opened = here().position;
+            size_t key   = frame.opened;
+            _frames.push_back(std::move(frame));
+            if (!result) {
+                skip(label, key, bit(ElseIf) | bit(Else) | bit(EndIf));
+            }
+            return Error::Ok;
+        }
+
+        case ElseIf:
+        case Else:
+            // A branch has run, so the rest are passed over
+            if (!inside || top->word != If) {
+                break;
+            }
+            skip(label, top->opened, bit(EndIf));
+            return Error::Ok;
+
+        case EndIf:
+            if (!inside || top->word != If) {
+                break;
+            }
+            _ends[top->opened] = here();
+            _frames.pop_back();
+            return Error::Ok;
+
+        case Break:
+        case Continue: {
+            auto loop = find(label, true);
+            if (!loop || !(loop->word == While || loop->word == Do || loop->word == Repeat)) {
+                break;
+            }
+            Word   loopWord = loop->word;
+            size_t key      = loop->opened;
+            _frames.erase(_frames.begin() + (loop - _frames.data()) + 1, _frames.end());
+            if (word == Break) {
+                _frames.pop_back();
+                skip(label, key, bit(loopWord == While ? EndWhile : loopWord == Repeat ? EndRepeat : While));
+                return Error::Ok;
+            }
+            if (loopWord == Do) {
+                // The condition is at the end, so read on to it
+                skip(label, key, bit(While));
+                return Error::Ok;
+            }
+            if ((status = again(_frames.back())) != Error::Ok) {
+                return status;
+            }
+            if (_frames.empty() || _frames.back().label != label) {
+                // That was the last pass
+                skip(label, key, bit(loopWord == While ? EndWhile : EndRepeat));
+            }
+            return Error::Ok;
+        }
+
+        default:
+            break;
+    }
+    log_error("O" << label << " " << wordNames[word] << " does not match an open block");
+    return Error::FlowControlSyntaxError;
+}
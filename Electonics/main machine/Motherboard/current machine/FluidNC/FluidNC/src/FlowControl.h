@@ -0,0 +1,108 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "Error.h"
+#include "Expression.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// LinuxCNC-style O-word flow control for file and macro jobs:
+//
+//   O100 sub ... O100 endsub [v]    O100 call [arg1] [arg2] ...   O100 return [v]
+//   O101 while [cond] ... O101 endwhile
+//   O102 do ... O102 while [cond]
+//   O103 repeat [count] ... O103 endrepeat
+//   O104 if [cond] ... O104 elseif [cond] ... O104 else ... O104 endif
+//   O105 break, O105 continue       inside loop O105
+//
+// A label is a number or a <name>, and belongs to one block at a time; it
+// can be used again for a later block, but a subroutine is defined only
+// once.  The arguments of a call are #1-#30 in the subroutine, and the
+// caller's values come back on return; a return value is left in
+// #<_value>.  A subroutine must be defined in the same job before it is
+// called.
+//
+// Loops and calls move the job's read position, which is why this works
+// only in jobs.  O-word lines are barriers in Protocol.cpp, so when one runs
+// no line after it has been read yet.  Lines passed over, as in an if branch
+// not taken, are read but not executed; once the end of a block has been
+// seen, later passes over it seek straight past it instead.
+
+// True if line, which need not be collapsed, is an O-word line
+bool is_flowcontrol(const char* line);
+
+// True if the collapsed line is an O-word with no keyword, such as the
+// O1000 program number that CAM programs often start with.  It fails as an
+// unsupported command, which does not stop a job.
+bool is_program_number(const char* line);
+
+class FlowControl {
+public:
+    // Runs an O-word line that has been collapsed
+    Error execute(const char* line);
+
+    // True while lines are being passed over
+    bool skipping() const { return _skipping; }
+
+private:
+    enum Word : uint8_t {
+        Sub,
+        EndSub,
+        Return,
+        Call,
+        Do,
+        While,
+        EndWhile,
+        Repeat,
+        EndRepeat,
+        If,
+        ElseIf,
+        Else,
+        EndIf,
+        Break,
+        Continue,
+        nWords,
+    };
+
+    struct Mark {
+        size_t position;
+        size_t lineNumber;
+    };
+
+    struct Frame {
+        std::string        label;
+        Word               word;           // What opened the block; Call for a subroutine call
+        Mark               start;          // Where the body starts, or for a call where to return
+        size_t             opened = 0;     // Read position after the opening line, the block's key in _ends
+        int32_t            count = 0;      // Repeat iterations left
+        bool               taken = false;  // An if branch has run
+        Expression         condition;      // Of a while, compiled when first met
+        std::vector<float> saved;          // The caller's #1-#30
+    };
+
+    static const size_t maxFrames = 16;
+
+    std::vector<Frame>          _frames;
+    std::map<std::string, Mark> _subs;  // Where each subroutine body starts
+    std::map<size_t, Mark>      _ends;  // Just past the end of each block seen so far, by Frame::opened
+
+    bool        _skipping = false;
+    std::string _skipLabel;
+    size_t      _skipKey   = 0;  // The opened position of the block being passed over
+    uint32_t    _skipUntil = 0;  // Bit mask of the words that end the skip
+
+    static Mark here();
+    static void seek(const Mark& mark);
+
+    Error  condition(const char* line, size_t* pos, bool& result);
+    Frame* find(const std::string& label, bool loop);
+    void   skip(const std::string& label, size_t key, uint32_t until);
+    Error  endSkip(Word word, const char* line, size_t* pos);
+    Error  again(Frame& frame);
+    Error  leave(const std::string& label, const char* line, size_t* pos);
+};
@@ -8,6 +8,7 @@
 #include "Machine/MachineConfig.h"
 #include "FluidError.hpp"
 #include "HashFS.h"
+#include "DirIndex.h"
 
 int FluidPath::_refcnt = 0;
 
@@ -33,6 +34,8 @@ FluidPath::FluidPath(const char* name, const char* fs, std::error_code* ecptr) :
                 }
                 throw stdfs::filesystem_error { "SD card is inaccessible", name, ec };
             }
+            // The card may have been changed or swapped while it was unmounted
+            DirIndex::mounted("/sd");
         }
         ++_refcnt;
     }
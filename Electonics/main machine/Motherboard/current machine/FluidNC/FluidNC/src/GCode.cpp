@@ -15,7 +15,7 @@
 #include "MotionControl.h"        // mc_override_ctrl_update
 #include "Machine/UserOutputs.h"  // setAnalogPercent
 #include "Platform.h"             // WEAK_LINK
-#include "Job.h"
+#include "Job.h"                  // Job, is_program_number
 #include "ToolCalibration.h"      // Tool calibration functionality
 #include "Pen.h"
 #include "WebUI/ToolConfig.h"
@@ -23,6 +23,7 @@
 
 #include "Machine/MachineConfig.h"
 #include "Parameters.h"
+#include "Profiler.h"
 
 #include <string.h>  // memset
 #include <math.h>    // sqrt etc.
@@ -218,9 +219,16 @@ void remove_laser_pointer_offset() {
 // exported to internal functions in terms of (mm, mm/min) and absolute machine
 // coordinates, respectively.
 Error gc_execute_line(char* line) {
+    ProfileScope profile(ProfileSection::GCodeExecute);
+
     // Step 0 - remove whitespace and comments and convert to upper case
     collapseGCode(line);
 
+    // O-words are run by the job's FlowControl; one here is not in a job
+    if (line[0] == 'O') {
+        FAIL(is_program_number(line) ? Error::GcodeUnsupportedCommand : Error::FlowControlNotExecutingMacro);
+    }
+
     /* -------------------------------------------------------------------------------------
        STEP 1: Initialize parser block struct and copy current g-code state modes. The parser
        updates these modes and commands as the block line is parser and will only be used and
@@ -332,6 +332,9 @@ enum class AxisCommand : uint8_t {
 // Initialize the parser
 void gc_init();
 
+// Remove whitespace and comments from a line and convert it to upper case, in place
+void collapseGCode(char* line);
+
 // Execute one block of rs275/ngc/g-code
 Error gc_execute_line(char* line);
 
@@ -111,6 +111,11 @@ std::string HashFS::hash(const std::filesystem::path& path) {
     if (file_is_hashed(path)) {
         std::map<std::string, std::string>::const_iterator it;
         it = localFsHashes.find(path.filename());
+        if (it == localFsHashes.end()) {
+            // Not hashed yet, as during startup
+            rehash_file(path, false);
+            it = localFsHashes.find(path.filename());
+        }
         if (it != localFsHashes.end()) {
             return it->second;
         }
@@ -32,14 +32,14 @@ Error InputFile::readLine(char* line, int maxlen) {
     return len || c >= 0 ? Error::Ok : Error::Eof;
 }
 
-void InputFile::ack(Error status) {
+void InputFile::ack(Error status, size_t line_number) {
     if (status != Error::Ok) {
-        log_error(static_cast<int>(status) << " (" << errorString(status) << ") in " << name() << " at line " << lineNumber());
+        log_error(static_cast<int>(status) << " (" << errorString(status) << ") in " << name() << " at line " << line_number);
         if (status != Error::GcodeUnsupportedCommand) {
             // Do not stop on unsupported commands because most senders do not stop.
             // Stop the file job on other errors
-            _notifyf("File job error", "Error:%d in %s at line: %d", status, name(), lineNumber());
-            _pending_error == status;
+            _notifyf("File job error", "Error:%d in %s at line: %d", status, name(), line_number);
+            _pending_error = status;
         }
     }
 }
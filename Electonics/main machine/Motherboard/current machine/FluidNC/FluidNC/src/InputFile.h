@@ -47,7 +47,8 @@ public:
 
     // Channel methods
     size_t write(uint8_t c) override { return 0; }
-    void   ack(Error status) override;
+    void   ack(Error status, size_t line_number) override;
+    bool   stopped() override { return _pending_error != Error::Ok || Channel::stopped(); }
     Error  pollLine(char* line) override;
 
     ~InputFile();
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "Channel.h"
+
+#include <atomic>
+#include <cstdint>
+
+// InputQueue carries complete input lines from the polling task, which reads
+// the channels and the job stack, to the protocol task, which executes them.
+// There is exactly one producer - polling_loop() - and one consumer -
+// protocol_main_loop() - so no lock is needed.  Each side owns one index and
+// publishes it with release ordering only after it is done with the slot.
+//
+// The consumer leaves a line in the queue while it executes and acks it, and
+// removes it afterwards, so an empty queue means that the protocol task is
+// not working on any input.  The polling task relies on that before it
+// changes the job stack or deletes a channel.
+
+struct InputLine {
+    Channel* channel;     // Where the line came from and where it is acked
+    size_t   lineNumber;  // The channel's line number when the line was read
+    uint32_t epoch;       // See InputQueue::discard()
+    bool     fromJob;     // Read from the job stack rather than a serial-style channel
+    char     line[Channel::maxLine];
+};
+
+class InputQueue {
+public:
+    static constexpr uint32_t depth = 8;  // Power of 2 so the indices can wrap
+
+private:
+    InputLine _slots[depth];
+
+    std::atomic<uint32_t> _head { 0 };  // Next line to execute, advanced by the consumer
+    std::atomic<uint32_t> _tail { 0 };  // Next slot to fill, advanced by the producer
+    std::atomic<uint32_t> _epoch { 0 };
+
+public:
+    // Producer side.  The line is read directly into back() and becomes
+    // visible to the consumer when push() is called.
+    bool full() { return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire) == depth; }
+    bool empty() { return _tail.load(std::memory_order_relaxed) == _head.load(std::memory_order_acquire); }
+
+    InputLine& back() { return _slots[_tail.load(std::memory_order_relaxed) % depth]; }
+    void       push() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer side
+    InputLine* front() {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        return head == _tail.load(std::memory_order_acquire) ? nullptr : &_slots[head % depth];
+    }
+    void pop() { _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Serial-style input that was received before a reset must not run after
+    // it.  The producer stamps each line with the epoch before it starts to
+    // read it, and discard() makes every line stamped so far stale.
+    uint32_t epoch() { return _epoch.load(std::memory_order_acquire); }
+    void     discard() { _epoch.fetch_add(1, std::memory_order_acq_rel); }
+    bool     stale(const InputLine& in) { return !in.fromJob && in.epoch != epoch(); }
+
+    // Whether the consumer should execute a line.  Job input that was read
+    // ahead of an alarm, or of an error or M2/M30 that stopped the job, is
+    // dropped too.
+    bool runnable(const InputLine& in, bool alarm) { return !stale(in) && !(in.fromJob && (alarm || in.channel->stopped())); }
+};
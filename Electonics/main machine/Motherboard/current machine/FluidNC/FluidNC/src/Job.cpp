@@ -55,15 +55,18 @@ void Job::abort() {
     }
 }
 
-float Job::get_param(const std::string& name) {
-    return job.top()->get_param(name);
+float Job::get_param(int slot) {
+    return job.top()->get_param(slot);
 }
-void Job::set_param(const std::string& name, float value) {
-    job.top()->set_param(name, value);
+void Job::set_param(int slot, float value) {
+    job.top()->set_param(slot, value);
 }
-bool Job::param_exists(const std::string& name) {
-    return job.top()->param_exists(name);
+bool Job::param_exists(int slot) {
+    return job.top()->param_exists(slot);
 }
 Channel* Job::channel() {
     return job.top()->channel();
 }
+FlowControl& Job::flow() {
+    return job.top()->flow();
+}
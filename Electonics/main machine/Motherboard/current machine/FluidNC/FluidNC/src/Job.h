@@ -1,19 +1,33 @@
 // Copyright (c) 2024 - Mitch Bradley
 // Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
 
+#pragma once
+
 #include "Channel.h"
+#include "Parameters.h"
+#include "FlowControl.h"
+
 #include <stack>
+#include <vector>
 
 class JobSource {
 private:
-    Channel*                     _channel;
-    std::map<std::string, float> _local_params;
+    Channel*                   _channel;
+    std::vector<param_value_t> _local_params;  // Indexed by slot, see Parameters.h
+    FlowControl                _flow;
 
 public:
     JobSource(Channel* channel) : _channel(channel) {}
-    float get_param(const std::string& name) { return _local_params[name]; }
-    void  set_param(const std::string& name, float value) { _local_params[name] = value; }
-    bool  param_exists(const std::string& name) { return _local_params.count(name) != 0; }
+    float get_param(int slot) { return size_t(slot) < _local_params.size() ? _local_params[slot].value : 0.0f; }
+    void  set_param(int slot, float value) {
+        if (size_t(slot) >= _local_params.size()) {
+            _local_params.resize(slot + 1);
+        }
+        _local_params[slot] = { value, true };
+    }
+    bool param_exists(int slot) { return size_t(slot) < _local_params.size() && _local_params[slot].set; }
+
+    FlowControl& flow() { return _flow; }
 
     void     save() { _channel->save(); }
     void     restore() { _channel->restore(); }
@@ -37,8 +51,9 @@ public:
     static void unnest();
     static void abort();
 
-    static float    get_param(const std::string& name);
-    static void     set_param(const std::string& name, float value);
-    static bool     param_exists(const std::string& name);
-    static Channel* channel();
+    static float        get_param(int slot);
+    static void         set_param(int slot, float value);
+    static bool         param_exists(int slot);
+    static Channel*     channel();
+    static FlowControl& flow();
 };
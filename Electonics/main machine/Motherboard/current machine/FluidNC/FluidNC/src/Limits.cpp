@@ -6,7 +6,8 @@
 #include "Protocol.h"       // protocol_execute_realtime
 #include "Platform.h"       // WEAK_LINK
 #include "Machine/Axis.h"
-#include "GCode.h"  // laser_offset_disabled
+#include "GCode.h"     // laser_offset_disabled
+#include "Settings.h"  // Setting::generation()
 
 #include <freertos/task.h>
 #include <freertos/queue.h>
@@ -72,61 +73,102 @@ bool soft_limit = false;
 // Define pen_change as volatile since it's accessed from multiple tasks
 volatile bool pen_change = false;  // Globally controlled flag to restrict travel during pen/tool changes
 
-// Calculate maximum allowed position based on configured limits and current mode
-float limitsMaxPosition(size_t axis) {
-    auto axisConfig = config->_axes->_axis[axis];
-    auto homing     = axisConfig->_homing;
-    auto mpos       = homing ? homing->_mpos : 0;
+// The soft-limit envelope for each way the limits can be in force.  Working
+// it out means consulting the axis config, the homing direction and the work
+// area, which is too much to do for every axis of every line, so it is done
+// once and again only when a setting or the work area changes.  Picking the
+// envelope for the current mode is then the only per-call work.
+enum EnvelopeMode {
+    NormalLimits,
+    PenChangeLimits,  // The wider pen_change_travel_mm on X and Y, to reach the pen bank
+    WorkAreaLimits,   // The work area on X and Y, for jogging and setup outside of a job
+    nEnvelopeModes,
+};
+
+struct Envelope {
+    float min[MAX_N_AXIS];
+    float max[MAX_N_AXIS];
+};
+
+static Envelope                envelopes[nEnvelopeModes];
+static Machine::MachineConfig* envelopeConfig     = nullptr;
+static uint32_t                envelopeGeneration = 0;
+
+static void buildEnvelopes() {
+    auto n_axis = config->_axes->_numberAxis;
+    for (size_t axis = 0; axis < n_axis; axis++) {
+        auto axisConfig = config->_axes->_axis[axis];
+        auto homing     = axisConfig->_homing;
+        auto mpos       = homing ? homing->_mpos : 0;
+        bool positive   = !homing || homing->_positiveDirection;
+
+        for (int mode = 0; mode < nEnvelopeModes; mode++) {
+            auto maxtravel = (mode == PenChangeLimits && axis != Z_AXIS) ? axisConfig->_penChangeTravel : axisConfig->_maxTravel;
+
+            envelopes[mode].min[axis] = positive ? mpos - maxtravel : mpos;
+            envelopes[mode].max[axis] = positive ? mpos : mpos + maxtravel;
+        }
+    }
+    if (n_axis > Y_AXIS) {
+        auto& workArea = envelopes[WorkAreaLimits];
 
-    // When pen_change mode is active, use restricted travel limits for X and Y axes
-    // This prevents accidental collisions during tool changes
-    auto maxtravel = (pen_change && axis != Z_AXIS) ? axisConfig->_penChangeTravel : axisConfig->_maxTravel;
+        workArea.min[X_AXIS] = config->getWorkAreaMinX();
+        workArea.max[X_AXIS] = config->getWorkAreaMaxX();
+        workArea.min[Y_AXIS] = config->getWorkAreaMinY();
+        workArea.max[Y_AXIS] = config->getWorkAreaMaxY();
+    }
+    envelopeConfig     = config;
+    envelopeGeneration = Setting::generation();
+}
+
+static const Envelope& envelope() {
+    if (envelopeConfig != config || envelopeGeneration != Setting::generation()) {
+        buildEnvelopes();
+    }
 
-    // Check if custom work area limits are configured and should be applied
     // Work area limits are disabled during:
     // 1. pen_change operations (tool changing)
     // 2. Normal job execution (when machine is in Cycle state)
     // Work area limits are ENABLED during:
     // - Manual jogging and alignment (Idle state)
     // - Setup operations with laser pointer
-    if (config->useWorkAreaLimits() && !pen_change && !state_is(State::Cycle)) {
-        if (axis == X_AXIS) {
-            return config->getWorkAreaMaxX();
-        } else if (axis == Y_AXIS) {
-            return config->getWorkAreaMaxY();
-        }
-        // For Z axis and other axes, fall through to normal calculation
+    if (pen_change) {
+        return envelopes[PenChangeLimits];
+    }
+    if (config->useWorkAreaLimits() && !state_is(State::Cycle)) {
+        return envelopes[WorkAreaLimits];
     }
+    return envelopes[NormalLimits];
+}
 
-    return (!homing || homing->_positiveDirection) ? mpos : mpos + maxtravel;
+// Calculate maximum allowed position based on configured limits and current mode
+float limitsMaxPosition(size_t axis) {
+    return envelope().max[axis];
 }
 
 // Calculate minimum allowed position based on configured limits and current mode
 float limitsMinPosition(size_t axis) {
-    auto axisConfig = config->_axes->_axis[axis];
-    auto homing     = axisConfig->_homing;
-    auto mpos       = homing ? homing->_mpos : 0;
-
-    // Apply pen_change travel restriction to minimum positions
-    auto maxtravel = (pen_change && axis != Z_AXIS) ? axisConfig->_penChangeTravel : axisConfig->_maxTravel;
+    return envelope().min[axis];
+}
 
-    // Check if custom work area limits are configured and should be applied
-    // Work area limits are disabled during:
-    // 1. pen_change operations (tool changing)
-    // 2. Normal job execution (when machine is in Cycle state)
-    // Work area limits are ENABLED during:
-    // - Manual jogging and alignment (Idle state)
-    // - Setup operations with laser pointer
-    if (config->useWorkAreaLimits() && !pen_change && !state_is(State::Cycle)) {
-        if (axis == X_AXIS) {
-            return config->getWorkAreaMinX();
-        } else if (axis == Y_AXIS) {
-            return config->getWorkAreaMinY();
+bool limitsKeepOut(const float* from, const float* to) {
+    auto keepOut = config->_keepOut;
+    if (!keepOut || pen_change) {
+        return false;
+    }
+    // Until X and Y are homed the positions say nothing about where the zones are
+    if (!Machine::Homing::axis_is_homed(X_AXIS) || !Machine::Homing::axis_is_homed(Y_AXIS)) {
+        return false;
+    }
+    auto n_axis = config->_axes->_numberAxis;
+    for (int i = 0; i < Machine::KeepOut::n_zones; i++) {
+        auto zone = keepOut->_zones[i];
+        if (zone && zone->crosses(from, to, n_axis)) {
+            log_info("Move crosses keep-out zone" << i);
+            return true;
         }
-        // For Z axis and other axes, fall through to normal calculation
     }
-
-    return (!homing || homing->_positiveDirection) ? mpos - maxtravel : mpos;
+    return false;
 }
 
 // Performs a soft limit check. Called from mcline() only. Assumes the machine has been homed,
@@ -63,6 +63,15 @@ float limitsMaxPosition(size_t axis);
  */
 float limitsMinPosition(size_t axis);
 
+/**
+ * @brief Check a straight move against the keep-out zones
+ * Zones are ignored during a pen change and until X and Y are homed
+ * @param from The start of the move in machine coordinates
+ * @param to The end of the move in machine coordinates
+ * @return true if the move passes through a zone
+ */
+bool limitsKeepOut(const float* from, const float* to);
+
 // Private
 
 // Returns limit state under mask
@@ -12,20 +12,28 @@
 #include "../UartChannel.h"
 
 #include "../SettingsDefinitions.h"  // config_filename
+#include "../Settings.h"             // Setting::_handle
 #include "../FileStream.h"
+#include "../HashFS.h"
 
 #include "../Configuration/Parser.h"
 #include "../Configuration/ParserHandler.h"
 #include "../Configuration/Validator.h"
 #include "../Configuration/AfterParse.h"
 #include "../Configuration/ParseException.h"
+#include "../Configuration/Snapshot.h"
 #include "../Config.h"  // ENABLE_*
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <atomic>
 #include <memory>
 
+#include <esp_ota_ops.h>    // esp_ota_get_app_description()
+#include <esp_timer.h>      // esp_timer_get_time()
+#include <esp_heap_caps.h>  // heap_caps_get_largest_free_block()
+
 Machine::MachineConfig* config;
 
 // TODO FIXME: Split this file up into several files, perhaps put it in some folder and namespace Machine?
@@ -63,6 +71,7 @@ namespace Machine {
 
         // Add work area configuration
         handler.section("work_area", _workArea);
+        handler.section("keep_out", _keepOut);
 
         handler.section("control", _control);
         handler.section("coolant", _coolant);
@@ -146,6 +155,101 @@ namespace Machine {
         // detectModuleType();
     }
 
+    // The NVS record of a runtime work area update
+    struct WorkAreaDelta {
+        float fromFile[6];  // The config.yaml values it replaces
+        float values[6];
+    };
+    static const char* workAreaKey = "WorkArea";
+
+    void WorkArea::get(float* values) const {
+        values[0] = _minX;
+        values[1] = _maxX;
+        values[2] = _originX;
+        values[3] = _minY;
+        values[4] = _maxY;
+        values[5] = _originY;
+    }
+
+    void WorkArea::set(const float* values) {
+        _minX    = values[0];
+        _maxX    = values[1];
+        _originX = values[2];
+        _minY    = values[3];
+        _maxY    = values[4];
+        _originY = values[5];
+    }
+
+    void WorkArea::afterParse() {
+        get(_fromFile);
+
+        WorkAreaDelta delta;
+        size_t        len = sizeof(delta);
+        if (nvs_get_blob(Setting::_handle, workAreaKey, &delta, &len) != ESP_OK || len != sizeof(delta)) {
+            return;
+        }
+        if (memcmp(delta.fromFile, _fromFile, sizeof(_fromFile))) {
+            // The file was edited after the calibration, so the file wins
+            log_info("Work area in config file overrides calibrated values");
+            Setting::nvsErase(workAreaKey);
+            return;
+        }
+        set(delta.values);
+        log_info("Work area X[" << _minX << "," << _maxX << "] Y[" << _minY << "," << _maxY << "] origin " << _originX << "," << _originY);
+    }
+
+    void WorkArea::update(float minX, float maxX, float originX, float minY, float maxY, float originY) {
+        WorkAreaDelta delta;
+        memcpy(delta.fromFile, _fromFile, sizeof(_fromFile));
+        delta.values[0] = minX;
+        delta.values[1] = maxX;
+        delta.values[2] = originX;
+        delta.values[3] = minY;
+        delta.values[4] = maxY;
+        delta.values[5] = originY;
+
+        set(delta.values);
+        Setting::changed();
+        Setting::nvsSet(workAreaKey, &delta, sizeof(delta));
+    }
+
+    bool KeepOutZone::crosses(const float* from, const float* to, size_t n_axis) const {
+        n_axis = std::min(n_axis, size_t(3));
+
+        bool inside = true;
+        for (size_t axis = 0; axis < n_axis; axis++) {
+            inside = inside && from[axis] > _min[axis] && from[axis] < _max[axis];
+        }
+        if (inside) {
+            return false;
+        }
+
+        // Clip the move to the box one axis at a time; if anything is left
+        // of it, that part is inside.  Touching a face is not entering.
+        float enter = 0.0f;
+        float leave = 1.0f;
+        for (size_t axis = 0; axis < n_axis; axis++) {
+            float delta = to[axis] - from[axis];
+            if (delta == 0.0f) {
+                if (from[axis] <= _min[axis] || from[axis] >= _max[axis]) {
+                    return false;
+                }
+                continue;
+            }
+            float t0 = (_min[axis] - from[axis]) / delta;
+            float t1 = (_max[axis] - from[axis]) / delta;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            enter = std::max(enter, t0);
+            leave = std::min(leave, t1);
+            if (enter >= leave) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     const char defaultConfig[] = "name: Default (Test Drive)\nboard: None\n";
 
     void MachineConfig::load() {
@@ -162,10 +266,41 @@ namespace Machine {
         }
     }
 
+    // The snapshot of a config file is kept beside it as a hidden file
+    static std::string snapshot_path(const FluidPath& fpath) {
+        return (fpath.parent_path() / ("." + fpath.filename().string() + ".snap")).string();
+    }
+
+    // A snapshot is only good for the firmware and the file contents it was made from
+    static std::string snapshot_key(const FluidPath& fpath) {
+        auto hash = HashFS::hash(fpath);
+        if (hash.empty()) {
+            return hash;
+        }
+        auto app = esp_ota_get_app_description();
+        return std::string(reinterpret_cast<const char*>(app->app_elf_sha256), sizeof(app->app_elf_sha256)) + hash;
+    }
+
+    static void report_load(int64_t start) {
+        log_info("Configuration loaded in " << uint32_t((esp_timer_get_time() - start) / 1000) << " ms, heap free "
+                                            << uint32_t(xPortGetFreeHeapSize()) << " largest block "
+                                            << uint32_t(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)));
+    }
+
     void MachineConfig::load_file(const std::string_view filename) {
+        auto start = esp_timer_get_time();
         try {
             FileStream file(std::string { filename }, "r", "");
 
+            std::string          snapPath = snapshot_path(file.fpath());
+            std::string          key      = snapshot_key(file.fpath());
+            std::vector<uint8_t> snapshot;
+            if (key.length() && Configuration::loadSnapshot(snapPath, key, snapshot) && load_snapshot(snapshot)) {
+                log_info("Configuration file:" << filename << " (from snapshot)");
+                report_load(start);
+                return;
+            }
+
             auto filesize = file.size();
             if (filesize <= 0) {
                 log_config_error("Configuration file:" << filename << " is empty");
@@ -180,7 +315,14 @@ namespace Machine {
                 return;
             }
             log_info("Configuration file:" << filename);
-            load_yaml(std::string_view { buffer.get(), filesize });
+            snapshot.clear();
+            load_yaml(std::string_view { buffer.get(), filesize }, &snapshot);
+            buffer.reset();
+            report_load(start);
+
+            if (key.length() && !state_is(State::ConfigAlarm) && !Configuration::saveSnapshot(snapPath, key, snapshot)) {
+                log_debug("Cannot save configuration snapshot " << snapPath);
+            }
         } catch (...) {
             log_config_error("Cannot open configuration file:" << filename);
             log_info("Using default configuration");
@@ -189,7 +331,40 @@ namespace Machine {
         }
     }
 
-    void MachineConfig::load_yaml(std::string_view input) {
+    // Rebuilds the tree from a snapshot made by load_yaml().  The snapshot is
+    // of a configuration that passed validation, so only the after-parse
+    // tasks are run.
+    bool MachineConfig::load_snapshot(const std::vector<uint8_t>& snapshot) {
+        try {
+            Configuration::SnapshotReader reader(snapshot.data(), snapshot.size());
+
+            auto& machineConfig = instance();
+            if (machineConfig != nullptr) {
+                delete machineConfig;
+            }
+            machineConfig = new MachineConfig();
+            config        = instance();
+
+            reader.enterSection("machine", config);
+        } catch (std::exception& ex) {
+            log_info("Configuration snapshot not used: " << ex.what());
+            return false;
+        } catch (const AssertionFailed& ex) {
+            log_info("Configuration snapshot not used: " << ex.what());
+            return false;
+        }
+
+        try {
+            Configuration::AfterParse afterParse;
+            config->afterParse();
+            config->group(afterParse);
+        } catch (std::exception& ex) { log_error("Validation error: " << ex.what()); }
+
+        std::atomic_thread_fence(std::memory_order::memory_order_seq_cst);
+        return true;
+    }
+
+    void MachineConfig::load_yaml(std::string_view input, std::vector<uint8_t>* snapshot) {
         bool successful = false;
         try {
             Configuration::Parser        parser(input);
@@ -208,6 +383,13 @@ namespace Machine {
 
             handler.enterSection("machine", config);
 
+            // The snapshot is of the tree as parsed, before the after-parse
+            // tasks fill in defaults and apply runtime changes
+            if (snapshot) {
+                Configuration::SnapshotWriter writer(*snapshot);
+                writer.enterSection("machine", config);
+            }
+
             log_debug("Running after-parse tasks");
 
             try {
@@ -251,5 +433,6 @@ namespace Machine {
         delete _spi;
         delete _control;
         delete _macros;
+        delete _keepOut;
     }
 }
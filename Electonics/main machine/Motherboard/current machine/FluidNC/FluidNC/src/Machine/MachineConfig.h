@@ -34,6 +34,7 @@ namespace Kinematics {
 #include "Macros.h"
 
 #include <string_view>
+#include <vector>
 
 namespace Machine {
     using ::Kinematics::Kinematics;
@@ -86,7 +87,84 @@ namespace Machine {
             handler.item("move_to_origin", _moveToOriginAfterHoming);
         }
 
+        // Applies the values saved by update(), unless config.yaml has
+        // been edited since they were saved
+        void afterParse() override;
+
+        // Replaces the bounds and origin in the running machine, as after a
+        // calibration.  The new values are kept in NVS as a delta over the
+        // ones read from config.yaml, so the file is not rewritten and no
+        // restart is needed.
+        void update(float minX, float maxX, float originX, float minY, float maxY, float originY);
+
         ~WorkArea() = default;
+
+    private:
+        static const int nValues = 6;
+
+        // The values as read from config.yaml, before any saved delta
+        float _fromFile[nValues];
+
+        void get(float* values) const;
+        void set(const float* values);
+    };
+
+    // A box that motion must not enter, such as the pen bank.  Moves are
+    // checked against it along their whole path, except during a pen change,
+    // which has to reach into the bank.  The Z bounds default to unlimited,
+    // so a zone given only in X and Y blocks every height.
+    class KeepOutZone : public Configuration::Configurable {
+    public:
+        float _min[3] = { -100000.0f, -100000.0f, -100000.0f };
+        float _max[3] = { 100000.0f, 100000.0f, 100000.0f };
+
+    public:
+        KeepOutZone() {}
+
+        void validate() override {
+            for (size_t axis = 0; axis < 3; axis++) {
+                Assert(_min[axis] < _max[axis], "Keep-out zone minimum must be below its maximum");
+            }
+        }
+
+        void group(Configuration::HandlerBase& handler) {
+            handler.item("min_x", _min[0]);
+            handler.item("max_x", _max[0]);
+            handler.item("min_y", _min[1]);
+            handler.item("max_y", _max[1]);
+            handler.item("min_z", _min[2]);
+            handler.item("max_z", _max[2]);
+        }
+
+        // True if the straight move from one point to the other passes
+        // through the inside of the zone.  Moves that start inside are
+        // allowed, so that the machine can be taken out of a zone.
+        bool crosses(const float* from, const float* to, size_t n_axis) const;
+
+        ~KeepOutZone() = default;
+    };
+
+    class KeepOut : public Configuration::Configurable {
+    public:
+        static const int n_zones = 4;
+
+        KeepOutZone* _zones[n_zones] = { nullptr };
+
+    public:
+        KeepOut() {}
+
+        void group(Configuration::HandlerBase& handler) {
+            handler.section("zone0", _zones[0]);
+            handler.section("zone1", _zones[1]);
+            handler.section("zone2", _zones[2]);
+            handler.section("zone3", _zones[3]);
+        }
+
+        ~KeepOut() {
+            for (auto zone : _zones) {
+                delete zone;
+            }
+        }
     };
 
     class MachineConfig : public Configuration::Configurable {
@@ -107,6 +185,7 @@ namespace Machine {
         Macros*                   _macros         = nullptr;
         Start*                    _start          = nullptr;
         WorkArea*                 _workArea       = nullptr;
+        KeepOut*                  _keepOut        = nullptr;
         Parking*                  _parking        = nullptr;
         OLED*                     _oled           = nullptr;
         Status_Outputs*           _stat_out       = nullptr;
@@ -152,7 +231,9 @@ namespace Machine {
 
         static void load();
         static void load_file(std::string_view file);
-        static void load_yaml(std::string_view yaml_string);
+        // If snapshot is given, the parsed tree is stored in it, see Configuration/Snapshot.h
+        static void load_yaml(std::string_view yaml_string, std::vector<uint8_t>* snapshot = nullptr);
+        static bool load_snapshot(const std::vector<uint8_t>& snapshot);
 
         float getLaserOffsetX() const { return _laserOffsetX; }
         float getLaserOffsetY() const { return _laserOffsetY; }
@@ -6,11 +6,12 @@
 #include "src/System.h"                 // sys
 #include "src/Machine/MachineConfig.h"  // config
 #include "src/Job.h"                    // Job::
+#include "src/Protocol.h"               // protocol_run_macro
 #include <sstream>
 #include <iomanip>
 
 void MacroEvent::run(void* arg) const {
-    config->_macros->_macro[_num].run(nullptr);
+    protocol_run_macro(&config->_macros->_macro[_num]);
 }
 
 const MacroEvent macro0Event { 0 };
@@ -97,13 +98,13 @@ Error MacroChannel::readLine(char* line, int maxlen) {
     return len ? Error::Ok : Error::Eof;
 }
 
-void MacroChannel::ack(Error status) {
+void MacroChannel::ack(Error status, size_t line_number) {
     if (status != Error::Ok) {
         //        log_error(static_cast<int>(status) << " (" << errorString(status) << ") in " << name() << " at line " << lineNumber());
         //        if (status != Error::GcodeUnsupportedCommand) {
         // Do not stop on unsupported commands because most senders do not stop.
         // Stop the macro job on other errors
-        _notifyf("Macro job error", "Error:%d in %s at line: %d", status, name().c_str(), lineNumber());
+        _notifyf("Macro job error", "Error:%d in %s at line: %d", status, name().c_str(), line_number);
         _pending_error = status;
         //        }
     }
@@ -119,6 +120,11 @@ Error MacroChannel::pollLine(char* line) {
     if (_pending_error != Error::Ok) {
         return _pending_error;
     }
+    if (_ended) {
+        _progress = name();
+        _progress += ": Sent";
+        return Error::Eof;
+    }
     switch (auto err = readLine(line, Channel::maxLine)) {
         case Error::Ok: {
             log_debug("Macro line: " << line);
@@ -73,7 +73,15 @@ namespace Machine {
 
         // Channel methods
         size_t write(uint8_t c) override { return 0; }
-        void   ack(Error status) override;
+        void   ack(Error status, size_t line_number) override;
+        bool   stopped() override { return _pending_error != Error::Ok || Channel::stopped(); }
+
+        bool   seekable() override { return true; }
+        size_t tell() override { return _position; }
+        void   seek(size_t position, size_t lineNumber) override {
+            _position    = position;
+            _line_number = lineNumber;
+        }
 
         ~MacroChannel();
     };
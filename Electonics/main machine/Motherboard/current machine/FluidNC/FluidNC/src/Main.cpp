@@ -126,6 +126,8 @@ void setup() {
 
     WebUI::wifi_config.begin();
 
+    index_settings();  // Every command and setting has been made by now
+
     allChannels.ready();
     allChannels.deregistration(&startupLog);
     protocol_send_event(&startEvent);
@@ -123,6 +123,13 @@ bool mc_linear(float* target, plan_line_data_t* pl_data, float* position) {
     if (!pl_data->is_jog && !pl_data->limits_checked)
         if (config->_kinematics->invalid_line(target))
             return false;
+    // Keep-out zones are checked per segment, so arcs and jogs are covered too
+    if (limitsKeepOut(position, target)) {
+        if (!pl_data->is_jog) {
+            limit_error();
+        }
+        return false;
+    }
     return mc_linear_no_check(target, pl_data, position);
 }
 
@@ -0,0 +1,89 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "MotionStats.h"
+
+#include "Channel.h"
+#include "Logging.h"
+#include "System.h"  // sys, state_is()
+
+#include <climits>  // UINT_MAX
+#include <string>
+
+volatile uint32_t MotionStats::isrHistogram[MotionStats::isrBuckets];
+volatile uint32_t MotionStats::isrMaxTicks = 0;
+
+uint32_t MotionStats::segmentLowWater  = UINT_MAX;
+uint32_t MotionStats::segmentUnderruns = 0;
+uint32_t MotionStats::plannerStarved   = 0;
+
+uint32_t MotionStats::prepCalls   = 0;
+uint32_t MotionStats::prepTotalUs = 0;
+uint32_t MotionStats::prepMaxUs   = 0;
+
+static bool plannerWasEmpty = true;
+
+void MotionStats::prepDone(int32_t startTicks) {
+    uint32_t us = uint32_t(getCpuTicks() - startTicks) / ticks_per_us;
+    ++prepCalls;
+    prepTotalUs += us;
+    if (us > prepMaxUs) {
+        prepMaxUs = us;
+    }
+}
+
+// Called by prep_buffer() before it starts filling the segment buffer
+void MotionStats::segmentsQueued(uint32_t queued, bool motionPending) {
+    if (!state_is(State::Cycle)) {
+        return;
+    }
+    if (queued < segmentLowWater) {
+        segmentLowWater = queued;
+    }
+    if (queued == 0 && motionPending) {
+        ++segmentUnderruns;
+    }
+}
+
+// Called by prep_buffer() each time it asks the planner for a block.  Only the
+// transition from having blocks to having none is counted.
+void MotionStats::plannerEmpty(bool empty) {
+    if (empty && !plannerWasEmpty && state_is(State::Cycle)) {
+        ++plannerStarved;
+    }
+    plannerWasEmpty = empty;
+}
+
+void MotionStats::reset() {
+    for (int i = 0; i < isrBuckets; i++) {
+        isrHistogram[i] = 0;
+    }
+    isrMaxTicks      = 0;
+    segmentLowWater  = UINT_MAX;
+    segmentUnderruns = 0;
+    plannerStarved   = 0;
+    prepCalls        = 0;
+    prepTotalUs      = 0;
+    prepMaxUs        = 0;
+}
+
+void MotionStats::report(Channel& out) {
+    std::string histogram;
+    for (int i = 0; i < isrBuckets; i++) {
+        if (i) {
+            histogram += ' ';
+        }
+        histogram += i == isrBuckets - 1 ? ">=" : "<";
+        histogram += std::to_string(i == isrBuckets - 1 ? 1 << i : 2 << i);
+        histogram += ':';
+        histogram += std::to_string(isrHistogram[i]);
+    }
+    log_info_to(out, "Stepper ISR us " << histogram << " max:" << isrMaxTicks / ticks_per_us);
+
+    if (segmentLowWater == UINT_MAX) {
+        log_info_to(out, "Segments low water:- underruns:" << segmentUnderruns << " planner starved:" << plannerStarved);
+    } else {
+        log_info_to(out, "Segments low water:" << segmentLowWater << " underruns:" << segmentUnderruns << " planner starved:" << plannerStarved);
+    }
+    log_info_to(out, "Prep calls:" << prepCalls << " avg us:" << (prepCalls ? prepTotalUs / prepCalls : 0) << " max us:" << prepMaxUs);
+}
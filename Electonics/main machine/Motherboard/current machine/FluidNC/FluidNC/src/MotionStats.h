@@ -0,0 +1,64 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+/*
+  MotionStats.h - lightweight counters for diagnosing motion throughput problems.
+
+  When a machine stutters on a dense file, the cause is usually one of three things:
+  the stepper ISR took too long, Stepper::prep_buffer() did not refill the segment
+  buffer in time, or the planner ran out of blocks because the parser fell behind.
+  These counters are cheap enough to leave on all the time and tell those apart.
+  They are shown by $Stats/Motion and, if enabled in $Report/Status, by the MS:
+  field of the realtime status report.
+*/
+
+#include "Driver/delay_usecs.h"  // getCpuTicks(), ticks_per_us
+
+#include <esp_attr.h>  // IRAM_ATTR
+#include <cstdint>
+
+class Channel;
+
+class MotionStats {
+public:
+    // ISR durations are binned by powers of two: bucket 0 is < 2us, bucket 1 is
+    // 2-3us, bucket 2 is 4-7us, ... and the last bucket holds everything longer.
+    static const int isrBuckets = 8;
+
+    static volatile uint32_t isrHistogram[isrBuckets];
+    static volatile uint32_t isrMaxTicks;
+
+    // Smallest number of queued segments seen by prep_buffer() during a cycle
+    static uint32_t segmentLowWater;
+    // Times prep_buffer() found the segment buffer empty with motion still pending
+    static uint32_t segmentUnderruns;
+    // Times the planner went empty while in Cycle state
+    static uint32_t plannerStarved;
+
+    static uint32_t prepCalls;
+    static uint32_t prepTotalUs;
+    static uint32_t prepMaxUs;
+
+    // Called at the end of each stepper ISR with the CPU tick count from its start
+    static inline void IRAM_ATTR isrDone(int32_t startTicks) {
+        uint32_t ticks = uint32_t(getCpuTicks() - startTicks);
+        if (ticks > isrMaxTicks) {
+            isrMaxTicks = ticks;
+        }
+        uint32_t us     = ticks / ticks_per_us;
+        int      bucket = us < 2 ? 0 : 31 - __builtin_clz(us);
+        if (bucket >= isrBuckets) {
+            bucket = isrBuckets - 1;
+        }
+        isrHistogram[bucket]++;
+    }
+
+    static void prepDone(int32_t startTicks);
+    static void segmentsQueued(uint32_t queued, bool motionPending);
+    static void plannerEmpty(bool empty);
+
+    static void reset();
+    static void report(Channel& out);
+};
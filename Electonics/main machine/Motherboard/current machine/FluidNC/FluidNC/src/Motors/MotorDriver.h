@@ -23,6 +23,7 @@
 */
 
 #include "../Configuration/Configurable.h"
+#include "../Pins/PinDetail.h"  // pinnum_t
 
 #include <cstdint>
 
@@ -78,6 +79,13 @@ namespace MotorDrivers {
         // states of the step pins are unknown.
         virtual void unstep();
 
+        // i2so_step_bit() reports the I2SO output bit that carries this
+        // motor's step signal, so the specialized stepping ISR can drive
+        // it directly instead of calling step() and unstep().  It returns
+        // false if the step signal is not a plain I2SO bit, in which case
+        // the ISR falls back to step() and unstep().
+        virtual bool i2so_step_bit(pinnum_t& bit, bool& invert) { return false; }
+
         // this is used to configure and test motors. This would be used for Trinamic
         virtual void config_motor() {}
 
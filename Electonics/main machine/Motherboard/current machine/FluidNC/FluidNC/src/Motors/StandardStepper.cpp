@@ -118,6 +118,19 @@ namespace MotorDrivers {
         }
     }
 
+    bool StandardStepper::i2so_step_bit(pinnum_t& bit, bool& invert) {
+        auto engine = config->_stepping->_engine;
+        if (engine != Stepping::I2S_STATIC && engine != Stepping::I2S_STREAM) {
+            return false;
+        }
+        if (!_step_pin.capabilities().has(Pin::Capabilities::I2S)) {
+            return false;
+        }
+        bit    = _step_pin.getNative(Pin::Capabilities::I2S);
+        invert = _step_pin.getAttr().has(Pin::Attr::ActiveLow);
+        return true;
+    }
+
     void IRAM_ATTR StandardStepper::set_direction(bool dir) {
         _dir_pin.write(dir);
     }
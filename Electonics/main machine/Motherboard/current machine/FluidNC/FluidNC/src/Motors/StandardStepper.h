@@ -20,6 +20,7 @@ namespace MotorDrivers {
         void set_direction(bool) override;
         void step() override;
         void unstep() override;
+        bool i2so_step_bit(pinnum_t& bit, bool& invert) override;
         void read_settings() override;
 
         void init_step_dir_pins();
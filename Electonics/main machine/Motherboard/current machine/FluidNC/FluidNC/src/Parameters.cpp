@@ -14,6 +14,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "Expression.h"
 
@@ -22,8 +23,6 @@ const std::map<const int, bool *> bool_params = {
     { 5070, &probe_succeeded },
     // { 5399, &m66okay },
 };
-typedef int ngc_param_id_t;
-
 std::map<const ngc_param_id_t, float> user_params = {};
 
 const std::map<const ngc_param_id_t, CoordIndex> axis_params = {
@@ -75,7 +74,22 @@ const std::array<const std::string, 6> unsupported_sys = {
 
 // clang-format on
 
-std::map<std::string, float> global_named_params;
+// Slot numbers are handed out as names are first seen and never reused
+static std::map<std::string, int>  param_slots;
+static std::vector<param_value_t> global_named_params;
+
+int param_slot(const std::string& name) {
+    auto it = param_slots.find(name);
+    if (it != param_slots.end()) {
+        return it->second;
+    }
+    int slot = global_named_params.size();
+    param_slots.emplace(name, slot);
+    global_named_params.emplace_back();
+    return slot;
+}
+
+float call_params[n_call_params];
 
 bool ngc_param_is_rw(ngc_param_id_t id) {
     return true;
@@ -103,6 +117,10 @@ bool set_numbered_param(ngc_param_id_t id, float value) {
         gc_state.tool = static_cast<uint32_t>(value);
         return true;
     }
+    if (id >= 1 && id <= n_call_params) {
+        call_params[id - 1] = value;
+        return true;
+    }
     if (id >= 31 && id <= 5000) {
         user_params[id] = value;
         return true;
@@ -157,6 +175,10 @@ bool get_numbered_param(ngc_param_id_t id, float& result) {
             return true;
         }
     }
+    if (id >= 1 && id <= n_call_params) {
+        result = call_params[id - 1];
+        return true;
+    }
     if (id >= 31 && id <= 5000) {
         result = user_params[id];
         return true;
@@ -165,10 +187,6 @@ bool get_numbered_param(ngc_param_id_t id, float& result) {
     return false;
 }
 
-struct param_ref_t {
-    std::string    name;  // If non-empty, the parameter is named
-    ngc_param_id_t id;    // Valid if name is empty
-};
 std::vector<std::tuple<param_ref_t, float>> assignments;
 
 void set_config_item(const std::string& name, float result) {
@@ -326,30 +344,32 @@ bool named_param_exists(std::string& name) {
         if (got) {
             return true;
         }
-        got = Job::param_exists(search);
-        if (got) {
-            return true;
-        }
     }
-    return global_named_params.count(search) != 0;
+    auto it = param_slots.find(search);
+    if (it == param_slots.end()) {
+        return false;
+    }
+    // Where get_param() would look
+    if (search[0] != '_' && Job::active()) {
+        return Job::param_exists(it->second);
+    }
+    return global_named_params[it->second].set;
 }
 
 bool get_param(const param_ref_t& param_ref, float& result) {
-    auto name = param_ref.name;
+    auto& name = param_ref.name;
     if (name.length()) {
         if (name[0] == '/') {
             return get_config_item(name, result);
         }
-        bool got;
         if (name[0] == '_') {
-            got = get_system_param(name, result);
-            if (got) {
+            if (get_system_param(name, result)) {
                 return true;
             }
-            result = global_named_params[name];
+            result = global_named_params[param_ref.slot].value;
             return true;
         }
-        result = Job::active() ? Job::get_param(name) : global_named_params[name];
+        result = Job::active() ? Job::get_param(param_ref.slot) : global_named_params[param_ref.slot].value;
         return true;
     }
     return get_numbered_param(param_ref.id, result);
@@ -386,6 +406,9 @@ bool get_param_ref(const char* line, size_t* pos, param_ref_t& param_ref) {
                 return false;
             }
             ++*pos;
+            if (param_ref.name.length() && param_ref.name[0] != '/') {
+                param_ref.slot = param_slot(param_ref.name);
+            }
             return true;
         case '[': {
             // Expression evaluating to param number
@@ -410,15 +433,15 @@ bool get_param_ref(const char* line, size_t* pos, param_ref_t& param_ref) {
 
 void set_param(const param_ref_t& param_ref, float value) {
     if (param_ref.name.length()) {
-        auto name = param_ref.name;
+        auto& name = param_ref.name;
         if (name[0] == '/') {
             set_config_item(param_ref.name, value);
             return;
         }
         if (name[0] != '_' && Job::active()) {
-            Job::set_param(name, value);
+            Job::set_param(param_ref.slot, value);
         } else {
-            global_named_params[name] = value;
+            global_named_params[param_ref.slot] = { value, true };
         }
         return;
     }
@@ -428,8 +451,16 @@ void set_param(const param_ref_t& param_ref, float value) {
     }
 }
 
-// Gets a numeric value, either a literal number or a #-prefixed parameter value
-bool read_number(const char* line, size_t* pos, float& result, bool in_expression) {
+void set_named_param(const std::string& name, float value) {
+    param_ref_t param_ref;
+    param_ref.name = name;
+    param_ref.slot = param_slot(name);
+    set_param(param_ref, value);
+}
+
+// Gets a numeric value, either a literal number, a #-prefixed parameter value
+// or a bracketed expression
+bool read_number(const char* line, size_t* pos, float& result) {
     char c = line[*pos];
     if (c == '#') {
         ++*pos;
@@ -447,25 +478,6 @@ bool read_number(const char* line, size_t* pos, float& result, bool in_expressio
         }
         return true;
     }
-    if (in_expression) {
-        if (isalpha(c)) {
-            // Functions are available only inside expressions because
-            // their names conflict with GCode words
-            return read_unary(line, pos, result) == Error::Ok;
-        }
-        if (c == '-') {
-            ++*pos;
-            if (!read_number(line, pos, result, in_expression)) {
-                return false;
-            }
-            result = -result;
-            return true;
-        }
-        if (c == '+') {
-            ++*pos;
-            return read_number(line, pos, result, in_expression);
-        }
-    }
     return read_float(line, pos, result);
 }
 
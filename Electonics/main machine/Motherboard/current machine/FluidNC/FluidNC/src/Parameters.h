@@ -6,7 +6,33 @@
 #include <stddef.h>
 #include <string>
 
+typedef int ngc_param_id_t;
+
+// A parameter as written after #
+struct param_ref_t {
+    std::string    name;       // If non-empty, the parameter is named
+    int            slot = -1;  // For a named parameter that is not a config item
+    ngc_param_id_t id   = 0;   // Valid if name is empty
+};
+
+// Named parameters are kept in flat arrays indexed by slot.  The name is
+// looked up when a line or expression that uses it is parsed, and only the
+// slot is used after that.
+struct param_value_t {
+    float value = 0.0f;
+    bool  set   = false;
+};
+int param_slot(const std::string& name);
+
+// #1-#30 are the arguments of a subroutine call, see FlowControl.h
+const int    n_call_params = 30;
+extern float call_params[n_call_params];
+
+bool get_param(const param_ref_t& param_ref, float& result);
+void set_param(const param_ref_t& param_ref, float value);
+void set_named_param(const std::string& name, float value);
+
 bool assign_param(const char* line, size_t* pos);
-bool read_number(const char* line, size_t* pos, float& value, bool in_expression = false);
+bool read_number(const char* line, size_t* pos, float& value);
 void perform_assignments();
 bool named_param_exists(std::string& name);
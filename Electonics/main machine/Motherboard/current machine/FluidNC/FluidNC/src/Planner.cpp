@@ -12,6 +12,7 @@
 #include "Machine/MachineConfig.h"
 #include "WebUI/ToolConfig.h"
 #include "Limits.h"  // For pen_change flag
+#include "Profiler.h"
 
 #include <cstdlib>  // PSoc Required for labs
 #include <cmath>
@@ -127,6 +128,8 @@ Recalculates the motion plan according to the following basic guidelines:
 
 */
 static void planner_recalculate() {
+    ProfileScope profile(ProfileSection::PlanRecalculate);
+
     if (block_buffer_head == block_buffer_tail) {
         // Nothing to do; planner buffer is empty.
         return;
@@ -401,6 +404,8 @@ void plan_update_velocity_profile_parameters() {
 }
 
 bool plan_buffer_line(float* target, plan_line_data_t* pl_data) {
+    ProfileScope profile(ProfileSection::PlanBufferLine);
+
     // Prepare and initialize new block. Copy relevant pl_data for block execution.
     plan_block_t* block = &block_buffer[block_buffer_head];
     memset(block, 0, sizeof(plan_block_t));  // Zero all block values.
@@ -41,7 +41,7 @@ struct plan_line_data_t {
 };
 
 // Now safe to include pen.h
-#include "pen.h"
+#include "Pen.h"
 
 #include <cstdint>
 
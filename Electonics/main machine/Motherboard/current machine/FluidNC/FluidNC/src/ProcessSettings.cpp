@@ -21,8 +21,11 @@
 #include "UartChannel.h"          // Uart0.write()
 #include "FileStream.h"           // FileStream()
 #include "xmodem.h"               // xmodemReceive(), xmodemTransmit()
+#include "Transfer/Transfer.h"    // transferReceive()
 #include "StartupLog.h"           // startupLog
 #include "Driver/fluidnc_gpio.h"  // gpio_dump()
+#include "MotionStats.h"          // MotionStats::report()
+#include "Profiler.h"             // Profiler::report()
 
 #include "FluidPath.h"
 #include "HashFS.h"
@@ -30,6 +33,8 @@
 #include <cstring>
 #include <map>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 
 // External reference to soft_limit flag
 extern bool soft_limit;
@@ -188,17 +193,40 @@ static Error report_gcode(const char* value, WebUI::AuthenticationLevel auth_lev
     return Error::Ok;
 }
 
-static void show_settings(Channel& out, type_t type) {
-    for (Setting* s : Setting::List) {
-        if (s->getType() == type && s->getGrblName()) {
-            // The following test could be expressed more succinctly with XOR,
-            // but is arguably clearer when written out
-            show_setting(s->getGrblName(), s->getCompatibleValue(), NULL, out);
+static Error report_normal_settings(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
+    // Senders poll $$, so its lines are formatted once per change to
+    // the settings instead of on every request.  $$ also comes from web
+    // commands on the polling task, so each rendering is a snapshot that
+    // is never changed once published, and only the pointer is locked.
+    struct Rendered {
+        uint32_t                 generation;
+        std::vector<std::string> lines;
+    };
+    static std::shared_ptr<const Rendered> cache;
+    static std::mutex                      cacheMutex;
+
+    std::shared_ptr<const Rendered> rendered;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        rendered = cache;
+    }
+    uint32_t generation = Setting::generation();
+    if (!rendered || rendered->generation != generation) {
+        auto fresh        = std::make_shared<Rendered>();
+        fresh->generation = generation;
+        for (Setting* s : Setting::List) {
+            if (s->getType() == GRBL && s->getGrblName()) {
+                fresh->lines.push_back(std::string(s->getGrblName()) + "=" + uriEncodeGrblCharacters(s->getCompatibleValue()));
+            }
         }
+        rendered = fresh;
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache = rendered;
+    }
+    for (auto const& line : rendered->lines) {
+        LogStream s(out, "$");
+        s << line;
     }
-}
-static Error report_normal_settings(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
-    show_settings(out, GRBL);  // GRBL non-axis settings
     return Error::Ok;
 }
 static Error list_grbl_names(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
@@ -733,6 +761,34 @@ static Error xmodem_receive(const char* value, WebUI::AuthenticationLevel auth_l
     return size < 0 ? Error::UploadFailed : Error::Ok;
 }
 
+static Error transfer_receive(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
+    if (!value || !*value) {
+        value = "uploaded";
+    }
+    FileStream* outfile;
+    try {
+        outfile = new FileStream(value, "w");
+    } catch (...) {
+        log_info("Cannot open " << value);
+        return Error::UploadFailed;
+    }
+    pollingPaused = true;
+    bool oldCr    = out.setCr(false);
+    int  size     = transferReceive(&out, outfile);
+    out.setCr(oldCr);
+    pollingPaused = false;
+    if (size >= 0) {
+        log_info("Received " << size << " bytes to file " << outfile->path());
+    } else {
+        log_info("Reception failed or was canceled");
+    }
+    std::filesystem::path fname = outfile->fpath();
+    delete outfile;
+    HashFS::rehash_file(fname);
+
+    return size < 0 ? Error::UploadFailed : Error::Ok;
+}
+
 static Error xmodem_send(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
     if (!value || !*value) {
         value = "config.yaml";
@@ -840,6 +896,32 @@ static Error showHeap(const char* value, WebUI::AuthenticationLevel auth_level,
     return Error::Ok;
 }
 
+static Error showMotionStats(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
+    if (value) {
+        if (strcasecmp(value, "reset") != 0) {
+            return Error::InvalidValue;
+        }
+        MotionStats::reset();
+        log_info_to(out, "Motion stats reset");
+        return Error::Ok;
+    }
+    MotionStats::report(out);
+    return Error::Ok;
+}
+
+static Error showProfile(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
+    if (value) {
+        if (strcasecmp(value, "reset") != 0) {
+            return Error::InvalidValue;
+        }
+        Profiler::reset();
+        log_info_to(out, "Profile reset");
+        return Error::Ok;
+    }
+    Profiler::report(out);
+    return Error::Ok;
+}
+
 // Commands use the same syntax as Settings, but instead of setting or
 // displaying a persistent value, a command causes some action to occur.
 // That action could be anything, from displaying a run-time parameter
@@ -851,6 +933,7 @@ void make_user_commands() {
     new UserCommand("CI", "Channel/Info", showChannelInfo, anyState);
     new UserCommand("XR", "Xmodem/Receive", xmodem_receive, allowConfigStates);
     new UserCommand("XS", "Xmodem/Send", xmodem_send, notIdleOrAlarm);
+    new UserCommand("TR", "Transfer/Receive", transfer_receive, allowConfigStates);
     new UserCommand("CD", "Config/Dump", dump_config, anyState);
     new UserCommand("", "Help", show_help, anyState);
     new UserCommand("T", "State", showState, anyState);
@@ -897,6 +980,8 @@ void make_user_commands() {
 
     new UserCommand("SA", "Alarm/Send", sendAlarm, anyState);
     new UserCommand("Heap", "Heap/Show", showHeap, anyState);
+    new UserCommand("SM", "Stats/Motion", showMotionStats, anyState);
+    new UserCommand("PF", "Profile", showProfile, anyState);
     new UserCommand("SS", "Startup/Show", showStartupLog, anyState);
 
     new UserCommand("RI", "Report/Interval", setReportInterval, anyState);
@@ -948,16 +1033,14 @@ Error do_command_or_setting(const char* key, const char* value, WebUI::Authentic
     // Try to execute a command.  Commands handle values internally;
     // you cannot determine whether to set or display solely based on
     // the presence of a value.
-    for (Command* cp : Command::List) {
-        if ((strcasecmp(cp->getName(), key) == 0) || (cp->getGrblName() && strcasecmp(cp->getGrblName(), key) == 0)) {
-            if (auth_failed(cp, value, auth_level)) {
-                return Error::AuthenticationFailed;
-            }
-            if (cp->synchronous()) {
-                protocol_buffer_synchronize();
-            }
-            return cp->action(value, auth_level, out);
+    if (Command* cp = Command::find(key)) {
+        if (auth_failed(cp, value, auth_level)) {
+            return Error::AuthenticationFailed;
+        }
+        if (cp->synchronous()) {
+            protocol_buffer_synchronize();
         }
+        return cp->action(value, auth_level, out);
     }
 
     protocol_buffer_synchronize();
@@ -970,6 +1053,8 @@ Error do_command_or_setting(const char* key, const char* value, WebUI::Authentic
 
         if (rts.isHandled_) {
             if (value) {
+                Setting::changed();
+
                 // Validate only if something changed, not for display
                 try {
                     Configuration::Validator validator;
@@ -996,33 +1081,29 @@ Error do_command_or_setting(const char* key, const char* value, WebUI::Authentic
 
     // Next search the settings list by text name. If found, set a new
     // value if one is given, otherwise display the current value
-    for (Setting* s : Setting::List) {
-        if (strcasecmp(s->getName(), key) == 0) {
-            if (auth_failed(s, value, auth_level)) {
-                return Error::AuthenticationFailed;
-            }
-            if (value) {
-                return s->setStringValue(uriDecode(value));
-            } else {
-                show_setting(s->getName(), s->getStringValue(), NULL, out);
-                return Error::Ok;
-            }
+    if (Setting* s = Setting::find(key)) {
+        if (auth_failed(s, value, auth_level)) {
+            return Error::AuthenticationFailed;
+        }
+        if (value) {
+            return s->setStringValue(uriDecode(value));
+        } else {
+            show_setting(s->getName(), s->getStringValue(), NULL, out);
+            return Error::Ok;
         }
     }
 
     // Then search the setting list by compatible name.  If found, set a new
     // value if one is given, otherwise display the current value in compatible mode
-    for (Setting* s : Setting::List) {
-        if (s->getGrblName() && strcasecmp(s->getGrblName(), key) == 0) {
-            if (auth_failed(s, value, auth_level)) {
-                return Error::AuthenticationFailed;
-            }
-            if (value) {
-                return s->setStringValue(uriDecode(value));
-            } else {
-                show_setting(s->getGrblName(), s->getCompatibleValue(), NULL, out);
-                return Error::Ok;
-            }
+    if (Setting* s = Setting::findGrbl(key)) {
+        if (auth_failed(s, value, auth_level)) {
+            return Error::AuthenticationFailed;
+        }
+        if (value) {
+            return s->setStringValue(uriDecode(value));
+        } else {
+            show_setting(s->getGrblName(), s->getCompatibleValue(), NULL, out);
+            return Error::Ok;
         }
     }
 
@@ -0,0 +1,40 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Profiler.h"
+
+#include "Channel.h"
+#include "Logging.h"
+
+#include <esp32-hal.h>  // millis()
+
+Profiler::Counter Profiler::counters[Profiler::nSections];
+
+static uint32_t resetMs = 0;
+
+static const char* sectionNames[Profiler::nSections] = {
+    "gc_execute_line", "plan_buffer_line", "planner_recalculate", "prep_buffer", "status_report", "channel_poll",
+};
+
+void Profiler::reset() {
+    for (auto& c : counters) {
+        c = {};
+    }
+    resetMs = millis();
+}
+
+void Profiler::report(Channel& out) {
+    uint32_t elapsedMs = millis() - resetMs;
+    log_info_to(out, "Profile over " << elapsedMs << " ms");
+    for (int i = 0; i < nSections; i++) {
+        // Take a copy so a section that is updated by another task reports consistent numbers
+        Counter  c       = counters[i];
+        uint64_t totalUs = c.totalTicks / ticks_per_us;
+        // Share of elapsed time in tenths of a percent
+        uint32_t permille = elapsedMs ? uint32_t(totalUs / elapsedMs) : 0;
+        log_info_to(out,
+                    sectionNames[i] << " calls:" << c.calls << " total ms:" << uint32_t(totalUs / 1000)
+                                    << " avg us:" << (c.calls ? uint32_t(totalUs / c.calls) : 0) << " max us:" << c.maxTicks / ticks_per_us
+                                    << " load:" << permille / 10 << "." << permille % 10 << "%");
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+/*
+  Profiler.h - cumulative CPU time spent in the hot paths of the motion pipeline.
+
+  MotionStats says whether the segment buffer or the planner ran dry; this says
+  which stage of the pipeline was eating the time when it did.  Each profiled
+  function declares a ProfileScope on entry, which adds the elapsed CPU ticks,
+  a call count and the worst case to the counters for its section.  Times are
+  inclusive, so gc_execute_line includes the plan_buffer_line calls it makes and
+  plan_buffer_line includes planner_recalculate.
+
+  The counters are shown by $Profile and cleared by $Profile=reset.
+*/
+
+#include "Driver/delay_usecs.h"  // getCpuTicks()
+
+#include <cstdint>
+
+class Channel;
+
+enum class ProfileSection : uint8_t {
+    GCodeExecute = 0,  // gc_execute_line()
+    PlanBufferLine,    // plan_buffer_line()
+    PlanRecalculate,   // planner_recalculate()
+    PrepBuffer,        // Stepper::prep_buffer()
+    StatusReport,      // report_realtime_status()
+    ChannelPoll,       // pollChannels()
+    Count,
+};
+
+class Profiler {
+public:
+    static const int nSections = int(ProfileSection::Count);
+
+    struct Counter {
+        uint32_t calls;
+        uint32_t maxTicks;
+        uint64_t totalTicks;
+    };
+
+    static Counter counters[nSections];
+
+    static void record(ProfileSection section, int32_t startTicks) {
+        uint32_t ticks = uint32_t(getCpuTicks() - startTicks);
+        Counter& c     = counters[int(section)];
+        ++c.calls;
+        c.totalTicks += ticks;
+        if (ticks > c.maxTicks) {
+            c.maxTicks = ticks;
+        }
+    }
+
+    static void reset();
+    static void report(Channel& out);
+};
+
+// Charges the lifetime of the enclosing block to a profiler section
+class ProfileScope {
+    ProfileSection _section;
+    int32_t        _start;
+
+public:
+    explicit ProfileScope(ProfileSection section) : _section(section), _start(getCpuTicks()) {}
+    ~ProfileScope() { Profiler::record(_section, _start); }
+
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
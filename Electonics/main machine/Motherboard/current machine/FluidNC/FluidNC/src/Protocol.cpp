@@ -23,6 +23,13 @@
 #include "Config.h"
 #include "ToolCalibration.h"
 #include "WorkAreaCalibration.h"
+#include "InputQueue.h"
+#include "GCode.h"  // collapseGCode
+#include "FlowControl.h"
+#include "Macro.h"
+
+#include <atomic>
+#include <cstring>  // strpbrk
 
 volatile ExecAlarm lastAlarm;  // The most recent alarm code
 
@@ -102,14 +109,82 @@ void output_loop(void* unused) {
     }
 }
 
-Channel* activeChannel = nullptr;  // Channel associated with the input line
+// Lines travel from the polling task to the protocol task through this queue,
+// so input from files and network channels can be read, split and collapsed
+// while earlier lines are still executing.
+static InputQueue inputQueue;
 
 TaskHandle_t pollingTask = nullptr;
 
-char activeLine[Channel::maxLine];
+static bool is_alarm() {
+    return state_is(State::Alarm) || state_is(State::ConfigAlarm);
+}
+
+// $ and [ESP] commands can nest jobs, take over a channel or change settings
+// that later lines depend on, so nothing more is read until they finish.
+// O-word lines can move the job's read position.
+static bool is_barrier(const char* line) {
+    return line[0] == '$' || line[0] == '[' || is_flowcontrol(line);
+}
+
+// Collapse plain GCode lines here, off the protocol task; gc_execute_line()
+// collapses again, which is cheap on a collapsed line.  Lines with comments
+// are left alone because collapsing is what emits (MSG,...) text, which must
+// come out in order with execution, and so are lines that are echoed.
+static void precollapse(char* line) {
+    if (!gcode_echo->get() && !strpbrk(line, "(;")) {
+        collapseGCode(line);
+    }
+}
+
+// Publish the line that was just read into inputQueue.back().
+// Returns true if it is a barrier.
+static bool queue_line(Channel* channel, bool fromJob) {
+    auto& in      = inputQueue.back();
+    in.channel    = channel;
+    in.lineNumber = channel->lineNumber();
+    in.fromJob    = fromJob;
+
+    bool barrier = is_barrier(in.line);
+    if (!barrier) {
+        precollapse(in.line);
+    }
+    inputQueue.push();
+    return barrier;
+}
+
+// Job lines go through the job's flow control, which runs O-word lines and
+// passes over lines in blocks that are not taken
+static Error execute_job_line(char* line, Channel& out_channel) {
+    if (Job::active()) {
+        if (is_flowcontrol(line)) {
+            collapseGCode(line);
+            return Job::flow().execute(line);
+        }
+        if (Job::flow().skipping()) {
+            return Error::Ok;
+        }
+    }
+    return execute_line(line, out_channel, WebUI::AuthenticationLevel::LEVEL_GUEST);
+}
+
+// A macro started by an event, waiting for the polling task to nest it.
+// Events run on the protocol task, which must not change the job stack
+// while the polling task is reading from it.
+static std::atomic<Macro*> pendingMacro { nullptr };
+
+void protocol_run_macro(Macro* macro) {
+    pendingMacro.store(macro, std::memory_order_release);
+}
 
 bool pollingPaused = false;
 void polling_loop(void* unused) {
+    // drain is set when reading must wait for the protocol task to finish
+    // every queued line, jobStatus when a job channel reported EOF or an error
+    // that must be acted on only after the lines before it have executed.
+    bool  drain     = false;
+    Error jobStatus = Error::Ok;
+
     // Poll the input sources waiting for a complete line to arrive
     for (; true; /*feedLoopWDT(), */ vTaskDelay(0)) {
         // Polling is paused when xmodem is using a channel for binary upload
@@ -118,56 +193,97 @@ void polling_loop(void* unused) {
             continue;
         }
 
+        // Queued lines refer to their channels, so dead channels are
+        // deleted only when no lines are queued.
+        if (inputQueue.empty()) {
+            allChannels.reap();
+        }
+
         // Polling without an argument checks for realtime characters
         // Polling with an argument both checks for realtime characters and
         // returns a line-oriented command if one is ready.
         pollChannels();
 
-        // If activeChannel is non-null, it means that we have recieved a line
-        // but the task running protocol_main_loop() has not yet picked it up.
-        // activeChannel is thus a form of flow control between the protocol
-        // task that processes GCode lines and other events and this task that
-        // handles IO from channels.
-        if (!activeChannel) {
-            // Job channels have priority
-            if (!Job::active()) {
-                unwind_cause = nullptr;
-                // No job channel is active, so poll all of the serial-style
-                // channels to see if one has a line ready.
-                activeChannel = pollChannels(activeLine);
-            } else {
-                if (state_is(State::Alarm) || state_is(State::ConfigAlarm)) {
-                    log_debug("Unwinding from Alarm");
-                    Job::abort();
-                    unwind_cause = nullptr;
-                    continue;
-                }
-                // A job channel is active, so accept line-oriented input only
-                // from the job channel on top of the job stack.
-                auto channel = Job::channel();
-                auto status  = channel->pollLine(activeLine);
-                switch (status) {
-                    case Error::Ok:
-                        activeChannel = channel;
-                        break;
-                    case Error::NoData:
-                        break;
-                    case Error::Eof:
-                        _notifyf("Job done", "%s job sent", channel->name());
-                        log_info(channel->name() << " job sent");
-                        Job::unnest();
-                        break;
-                    default:
-                        if (Job::leader) {
-                            log_error_to(*Job::leader,
-                                         static_cast<int>(status) << " (" << errorString(status) << ") in " << channel->name()
-                                                                  << " at line " << channel->lineNumber());
-                        }
-                        Job::abort();
-                        break;
-                }
+        // The queue is a form of flow control between the protocol task that
+        // processes GCode lines and other events and this task that handles
+        // IO from channels.  When it is full, wait for the protocol task.
+        if (drain || jobStatus != Error::Ok || (Job::active() && is_alarm())) {
+            if (!inputQueue.empty()) {
+                continue;
+            }
+            drain = false;
+        }
+
+        // Nest a pending macro once the lines read before its event have
+        // executed, and read nothing in the meantime, so that it runs before
+        // anything that arrives after the event.  A job that ended or failed
+        // is unwound first, so the macro is not taken for it.
+        if (jobStatus == Error::Ok && pendingMacro.load(std::memory_order_acquire)) {
+            if (is_alarm()) {
+                pendingMacro.store(nullptr);  // It would only be unwound
+            } else if (inputQueue.empty()) {
+                pendingMacro.exchange(nullptr)->run(nullptr);
+            }
+            continue;
+        }
+
+        if (inputQueue.full()) {
+            continue;
+        }
+
+        // Job channels have priority
+        if (!Job::active()) {
+            unwind_cause = nullptr;
+            // No job channel is active, so poll all of the serial-style
+            // channels to see if one has a line ready.
+            inputQueue.back().epoch = inputQueue.epoch();
+            if (auto channel = pollChannels(inputQueue.back().line)) {
+                drain = queue_line(channel, false);
+            }
+            continue;
+        }
+
+        if (is_alarm()) {
+            // The protocol task has discarded the job lines that were queued
+            log_debug("Unwinding from Alarm");
+            Job::abort();
+            jobStatus    = Error::Ok;
+            unwind_cause = nullptr;
+            continue;
+        }
+
+        auto channel = Job::channel();
+        if (jobStatus == Error::Ok) {
+            // A job channel is active, so accept line-oriented input only
+            // from the job channel on top of the job stack.
+            auto status = channel->pollLine(inputQueue.back().line);
+            switch (status) {
+                case Error::Ok:
+                    drain = queue_line(channel, true);
+                    break;
+                case Error::NoData:
+                    break;
+                default:
+                    // Act on it once the lines before it have executed
+                    jobStatus = status;
+                    break;
             }
+            continue;
         }
+
+        if (jobStatus == Error::Eof) {
+            _notifyf("Job done", "%s job sent", channel->name());
+            log_info(channel->name() << " job sent");
+            Job::unnest();
+        } else {
+            if (Job::leader) {
+                log_error_to(*Job::leader,
+                             static_cast<int>(jobStatus) << " (" << errorString(jobStatus) << ") in " << channel->name() << " at line "
+                                                         << channel->lineNumber());
+            }
+            Job::abort();
+        }
+        jobStatus = Error::Ok;
     }
 }
 
@@ -257,24 +373,29 @@ void protocol_main_loop() {
     // This is also where the system idles while waiting for something to do.
     // ---------------------------------------------------------------------------------
     for (;; vTaskDelay(0)) {
-        if (activeChannel) {
-            // The input polling task has collected a line of input
-            if (gcode_echo->get()) {
-                report_echo_line_received(activeLine, allChannels);
-            }
+        if (auto in = inputQueue.front()) {
+            // The input polling task has collected a line of input.
+            // Lines that must not run are dropped; the polling task unwinds
+            // a stopped job once the queue is empty.
+            if (inputQueue.runnable(*in, is_alarm())) {
+                if (gcode_echo->get()) {
+                    report_echo_line_received(in->line, allChannels);
+                }
 
-            Channel* out_channel = Job::leader ? Job::leader : activeChannel;
-            Error    status_code = execute_line(activeLine, *out_channel, WebUI::AuthenticationLevel::LEVEL_GUEST);
+                Channel* out_channel = Job::leader ? Job::leader : in->channel;
+                Error    status_code = in->fromJob ? execute_job_line(in->line, *out_channel)
+                                               : execute_line(in->line, *out_channel, WebUI::AuthenticationLevel::LEVEL_GUEST);
 
-            // Tell the channel that the line has been processed.
-            // If the line was aborted, the channel could be invalid
-            if (!sys.abort) {
-                activeChannel->ack(status_code);
+                // Tell the channel that the line has been processed.
+                // If the line was aborted, the channel could be invalid
+                if (!sys.abort) {
+                    in->channel->ack(status_code, in->lineNumber);
+                }
             }
 
             // Tell the input polling task that the line has been processed,
-            // so it can give us another one when available
-            activeChannel = nullptr;
+            // so it can reuse the slot and act on job and channel changes
+            inputQueue.pop();
         }
 
         // Auto-cycle start any queued moves.
@@ -284,6 +405,8 @@ void protocol_main_loop() {
             sys.abort = false;
         }
 
+        Setting::pollNVS();  // Commit settings changes once motion allows
+
         // check to see if we should disable the stepper drivers
         // If idleEndTime is 0, no disable is pending.
 
@@ -370,6 +493,8 @@ static void protocol_run_startup_lines() {
 }
 
 static void protocol_do_restart() {
+    Setting::commitNVS();
+
     // Reset primary systems.
     system_reset();
     protocol_reset();
@@ -389,6 +514,7 @@ static void protocol_do_restart() {
     plan_sync_position();
     gc_sync_position();
     allChannels.flushRx();
+    inputQueue.discard();
     report_init_message(allChannels);
     mc_init();
 
@@ -129,6 +129,12 @@ inline void protocol_send_event(const Event* evt, int arg) {
 
 void protocol_send_event_from_ISR(const Event* evt, void* arg = 0);
 
+// Runs a macro that an event started.  It is a barrier like a $ line: the
+// lines read before the event run first, and nothing more is read until the
+// macro has been nested.
+class Macro;
+void protocol_run_macro(Macro* macro);
+
 void drain_messages();
 
 extern uint32_t heapLowWater;
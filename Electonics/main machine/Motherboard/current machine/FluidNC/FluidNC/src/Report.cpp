@@ -26,6 +26,8 @@
 #include "Limits.h"                      // limits_get_state
 #include "Planner.h"                     // plan_get_block_buffer_available
 #include "Stepper.h"                     // step_count
+#include "MotionStats.h"                 // MotionStats
+#include "Profiler.h"                    // ProfileScope
 #include "Platform.h"                    // WEAK_LINK
 #include "WebUI/NotificationsService.h"  // WebUI::notificationsService
 #include "WebUI/WifiConfig.h"            // wifi_config
@@ -402,7 +404,9 @@ void report_build_info(const char* line, Channel& channel) {
     if (!FORCE_BUFFER_SYNC_DURING_WCO_CHANGE) {
         msg += "W";  // Shown when disabled.
     }
-    log_stream(channel, "[OPT:" << msg);
+    // Grbl 1.1 appends the planner block count and the receive buffer size,
+    // which character-counting senders use to keep the input pipe full.
+    log_stream(channel, "[OPT:" << msg << "," << config->_planner_blocks - 1 << "," << channel.rx_buffer_size());
 
     log_msg_to(channel, "Machine: " << config->_name);
 
@@ -529,6 +533,9 @@ void report_realtime_debug() {}
 // requires as it minimizes the computational overhead to keep running smoothly,
 // especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
 void report_realtime_status(Channel& channel) {
+    // Declared before msg so the time to send the report is included
+    ProfileScope profile(ProfileSection::StatusReport);
+
     LogStream msg(channel, "<");
     msg << state_name();
 
@@ -623,6 +630,11 @@ void report_realtime_status(Channel& channel) {
     if (Job::active()) {
         msg << "|" << Job::channel()->_progress;
     }
+    if (bits_are_true(status_mask->get(), RtStatus::Motion)) {
+        // Segment underruns, planner starvation events, worst ISR time, worst prep_buffer time
+        msg << "|MS:" << MotionStats::segmentUnderruns << "," << MotionStats::plannerStarved << ","
+            << MotionStats::isrMaxTicks / ticks_per_us << "," << MotionStats::prepMaxUs;
+    }
 #ifdef DEBUG_STEPPER_ISR
     msg << "|ISRs:" << Stepper::isr_count;
 #endif
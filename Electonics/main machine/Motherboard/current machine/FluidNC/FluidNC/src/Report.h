@@ -19,6 +19,7 @@
 enum RtStatus {
     Position = bitnum_to_mask(0),
     Buffer   = bitnum_to_mask(1),
+    Motion   = bitnum_to_mask(2),
 };
 
 const char* errorString(Error errorNumber);
@@ -0,0 +1,97 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// RingBuffer is a fixed-size byte FIFO for channel input.  The storage is
+// allocated the first time a byte is stored, so channels that never receive
+// serial-style input - files and macros - do not pay for it, and after that
+// nothing is allocated or freed however much data passes through.
+//
+// Besides byte-at-a-time access, span() and consume() expose the contiguous
+// run of bytes at the read position so callers can scan and copy input in
+// bulk.  It is not thread-safe; all access is from the polling task.
+
+template <size_t N>
+class RingBuffer {
+    static_assert((N & (N - 1)) == 0, "RingBuffer size must be a power of 2");
+
+    uint8_t* _data = nullptr;
+    uint32_t _head = 0;  // Read position, wraps freely
+    uint32_t _tail = 0;  // Write position, wraps freely
+
+    bool allocate() {
+        if (!_data) {
+            _data = new uint8_t[N];
+        }
+        return _data != nullptr;
+    }
+
+public:
+    RingBuffer() = default;
+    ~RingBuffer() { delete[] _data; }
+
+    RingBuffer(const RingBuffer&)            = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    static constexpr size_t capacity() { return N; }
+
+    size_t size() const { return _tail - _head; }
+    size_t space() const { return N - size(); }
+    bool   empty() const { return _tail == _head; }
+    void   clear() { _head = _tail = 0; }
+
+    bool push(uint8_t c) {
+        if (!space() || !allocate()) {
+            return false;
+        }
+        _data[_tail++ & (N - 1)] = c;
+        return true;
+    }
+
+    // Stores as much of data as fits, returning the number of bytes stored
+    size_t push(const uint8_t* data, size_t length) {
+        length = std::min(length, space());
+        if (!length || !allocate()) {
+            return 0;
+        }
+        size_t offset = _tail & (N - 1);
+        size_t first  = std::min(length, N - offset);
+        memcpy(_data + offset, data, first);
+        memcpy(_data, data + first, length - first);
+        _tail += length;
+        return length;
+    }
+
+    uint8_t front() const { return _data[_head & (N - 1)]; }
+    uint8_t pop() { return _data[_head++ & (N - 1)]; }
+
+    // Removes up to length bytes into buffer, returning the number removed
+    size_t pop(uint8_t* buffer, size_t length) {
+        size_t total = 0;
+        while (length && !empty()) {
+            size_t         n;
+            const uint8_t* p = span(n);
+            n                = std::min(n, length);
+            memcpy(buffer, p, n);
+            consume(n);
+            buffer += n;
+            length -= n;
+            total += n;
+        }
+        return total;
+    }
+
+    // The contiguous bytes at the read position; length is set to how many
+    const uint8_t* span(size_t& length) const {
+        size_t offset = _head & (N - 1);
+        length        = std::min(size(), N - offset);
+        return _data + offset;
+    }
+    void consume(size_t length) { _head += length; }
+};
@@ -49,6 +49,7 @@
 #include "InputFile.h"
 #include "Main.h"        // display()
 #include "StartupLog.h"  // startupLog
+#include "Profiler.h"    // ProfileScope
 
 #include "Driver/fluidnc_gpio.h"
 
@@ -188,13 +189,15 @@ Channel* AllChannels::find(const std::string& name) {
     _mutex_general.unlock();
     return nullptr;
 }
-Channel* AllChannels::poll(char* line) {
+void AllChannels::reap() {
     Channel* deadChannel;
     while (xQueueReceive(_killQueue, &deadChannel, 0)) {
         deregistration(deadChannel);
         delete deadChannel;
     }
+}
 
+Channel* AllChannels::poll(char* line) {
     // To avoid starving other channels when one has a lot
     // of traffic, we poll the other channels before the last
     // one that returned a line.
@@ -235,6 +238,8 @@ Channel* pollChannels(char* line) {
     }
     counter = 50;
 
+    ProfileScope profile(ProfileSection::ChannelPoll);
+
     Channel* retval = allChannels.poll(line);
 
     WebUI::COMMANDS::handle();      // Handles ESP restart
@@ -35,7 +35,11 @@ class AllChannels : public Channel {
 public:
     AllChannels() : Channel("all") { _killQueue = xQueueCreate(3, sizeof(Channel*)); }
 
+    // kill() queues a channel for deletion and reap() deletes the queued
+    // channels.  reap() runs in the polling task once no input lines that
+    // refer to those channels are waiting to be executed.
     void kill(Channel* channel);
+    void reap();
 
     void registration(Channel* channel);
     void deregistration(Channel* channel);
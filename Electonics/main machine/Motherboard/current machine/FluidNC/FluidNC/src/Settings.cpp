@@ -4,13 +4,14 @@
 #include "WebUI/WifiConfig.h"   // WebUI::WiFiConfig
 #include "WebUI/Commands.h"     // WebUI::COMMANDS
 #include "System.h"             // sys
-#include "Protocol.h"           // protocol_buffer_synchronize
+#include "Planner.h"            // plan_get_current_block
 #include "Machine/MachineConfig.h"
 
 #include <map>
 #include <limits>
 #include <cstring>
 #include <vector>
+#include <mutex>
 #include <charconv>
 #include <nvs.h>
 
@@ -69,6 +70,117 @@ Setting::Setting(const char* description, type_t type, permissions_t permissions
     }
 }
 
+std::atomic<uint32_t> Setting::_generation { 0 };
+
+// An open-addressed hash table from names to Words, so that looking up
+// a $ command or setting does not compare against every name in a List.
+// The tables are built once, by index_settings() at the end of startup,
+// and only read after that, so lookups from the protocol and polling tasks
+// need no lock.  Lookups made before then, or after a List has grown,
+// search the List instead.  Where two Words share a name, the one earlier
+// in the List wins, as with a linear search.
+class NameIndex {
+    struct Slot {
+        const char* name;
+        Word*       word;
+    };
+    std::vector<Slot> _slots;
+    size_t            _indexed = 0;
+    bool              _fullNames;
+    bool              _grblNames;
+
+    static uint32_t hash(const char* name) {
+        uint32_t h = 2166136261u;  // FNV-1a
+        while (*name) {
+            h = (h ^ uint8_t(tolower(*name++))) * 16777619u;
+        }
+        return h;
+    }
+
+    bool matches(Word* word, const char* name) const {
+        return (_fullNames && strcasecmp(word->getName(), name) == 0) ||
+               (_grblNames && word->getGrblName() && strcasecmp(word->getGrblName(), name) == 0);
+    }
+
+    void add(const char* name, Word* word) {
+        if (!name) {
+            return;
+        }
+        size_t mask = _slots.size() - 1;
+        for (size_t i = hash(name) & mask;; i = (i + 1) & mask) {
+            if (!_slots[i].name) {
+                _slots[i] = { name, word };
+                return;
+            }
+            if (strcasecmp(_slots[i].name, name) == 0) {
+                return;
+            }
+        }
+    }
+
+public:
+    NameIndex(bool fullNames, bool grblNames) : _fullNames(fullNames), _grblNames(grblNames) {}
+
+    template <typename T>
+    void build(const std::vector<T*>& list) {
+        size_t n = 16;
+        while (n < 4 * list.size()) {  // Both names, at most half full
+            n *= 2;
+        }
+        _slots.assign(n, { nullptr, nullptr });
+        for (T* word : list) {
+            if (_fullNames) {
+                add(word->getName(), word);
+            }
+            if (_grblNames) {
+                add(word->getGrblName(), word);
+            }
+        }
+        _indexed = list.size();
+    }
+
+    template <typename T>
+    T* find(const std::vector<T*>& list, const char* name) const {
+        if (_indexed != list.size()) {
+            for (T* word : list) {
+                if (matches(word, name)) {
+                    return word;
+                }
+            }
+            return nullptr;
+        }
+        size_t mask = _slots.size() - 1;
+        for (size_t i = hash(name) & mask; _slots[i].name; i = (i + 1) & mask) {
+            if (strcasecmp(_slots[i].name, name) == 0) {
+                return static_cast<T*>(_slots[i].word);
+            }
+        }
+        return nullptr;
+    }
+};
+
+static NameIndex commandIndex(true, true);
+static NameIndex settingIndex(true, false);
+static NameIndex grblSettingIndex(false, true);
+
+void index_settings() {
+    commandIndex.build(Command::List);
+    settingIndex.build(Setting::List);
+    grblSettingIndex.build(Setting::List);
+}
+
+Command* Command::find(const char* name) {
+    return commandIndex.find(List, name);
+}
+
+Setting* Setting::find(const char* name) {
+    return settingIndex.find(List, name);
+}
+
+Setting* Setting::findGrbl(const char* name) {
+    return grblSettingIndex.find(List, name);
+}
+
 Error Setting::check_state() {
     if (notIdleOrAlarm()) {
         return Error::IdleError;
@@ -86,6 +198,106 @@ void Setting::init() {
     }
 }
 
+// Staged NVS writes, oldest first, at most one per key
+enum class NvsOp : uint8_t { Erase, I8, I32, Str, Blob };
+struct StagedNvs {
+    std::string          key;
+    NvsOp                op;
+    std::vector<uint8_t> data;
+};
+static std::vector<StagedNvs> staged;
+static std::mutex             stagedMutex;
+static TickType_t             lastStaged;
+
+static const TickType_t nvsSettleTicks = pdMS_TO_TICKS(250);  // Commit once writes stop for this long
+
+static void stage(const char* key, NvsOp op, const void* data = nullptr, size_t length = 0) {
+    std::lock_guard<std::mutex> lock(stagedMutex);
+    auto                        bytes = static_cast<const uint8_t*>(data);
+    for (auto& s : staged) {
+        if (s.key == key) {
+            s.op = op;
+            s.data.assign(bytes, bytes + length);
+            lastStaged = xTaskGetTickCount();
+            return;
+        }
+    }
+    staged.push_back({ key, op, std::vector<uint8_t>(bytes, bytes + length) });
+    lastStaged = xTaskGetTickCount();
+}
+
+void Setting::nvsSet(const char* key, int32_t value) {
+    stage(key, NvsOp::I32, &value, sizeof(value));
+}
+void Setting::nvsSet(const char* key, int8_t value) {
+    stage(key, NvsOp::I8, &value, sizeof(value));
+}
+void Setting::nvsSet(const char* key, const std::string& value) {
+    stage(key, NvsOp::Str, value.c_str(), value.length() + 1);
+}
+void Setting::nvsSet(const char* key, const void* data, size_t length) {
+    stage(key, NvsOp::Blob, data, length);
+}
+void Setting::nvsErase(const char* key) {
+    stage(key, NvsOp::Erase);
+}
+
+void Setting::commitNVS() {
+    std::lock_guard<std::mutex> lock(stagedMutex);
+    for (auto& s : staged) {
+        esp_err_t err;
+        switch (s.op) {
+            case NvsOp::Erase:
+                err = nvs_erase_key(_handle, s.key.c_str());
+                if (err == ESP_ERR_NVS_NOT_FOUND) {
+                    err = ESP_OK;
+                }
+                break;
+            case NvsOp::I8:
+                err = nvs_set_i8(_handle, s.key.c_str(), int8_t(s.data[0]));
+                break;
+            case NvsOp::I32: {
+                int32_t value;
+                memcpy(&value, s.data.data(), sizeof(value));
+                err = nvs_set_i32(_handle, s.key.c_str(), value);
+            } break;
+            case NvsOp::Str:
+                err = nvs_set_str(_handle, s.key.c_str(), reinterpret_cast<const char*>(s.data.data()));
+                break;
+            case NvsOp::Blob:
+                err = nvs_set_blob(_handle, s.key.c_str(), s.data.data(), s.data.size());
+                break;
+        }
+        if (err) {
+            log_error("NVS write of " << s.key << " failed with error " << err);
+        }
+    }
+    staged.clear();
+}
+
+void Setting::pollNVS() {
+    {
+        // Settings are also changed from the polling task, by web commands
+        std::lock_guard<std::mutex> lock(stagedMutex);
+        if (staged.empty() || int32_t(xTaskGetTickCount() - lastStaged) < int32_t(nvsSettleTicks)) {
+            return;
+        }
+    }
+    if (FORCE_BUFFER_SYNC_DURING_NVS_WRITE && (plan_get_current_block() || state_is(State::Cycle))) {
+        return;
+    }
+    commitNVS();
+}
+
+Error Setting::eraseNVS(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
+    {
+        std::lock_guard<std::mutex> lock(stagedMutex);
+        staged.clear();
+    }
+    nvs_erase_all(_handle);
+    return Error::Ok;
+}
+
 IntSetting::IntSetting(const char*   description,
                        type_t        type,
                        permissions_t permissions,
@@ -111,12 +323,13 @@ void IntSetting::load() {
 }
 
 void IntSetting::setDefault() {
+    changed();
     if (_currentIsNvm) {
-        nvs_erase_key(_handle, _keyName);
+        nvsErase(_keyName);
     } else {
         _currentValue = _defaultValue;
         if (_storedValue != _currentValue) {
-            nvs_erase_key(_handle, _keyName);
+            nvsErase(_keyName);
         }
     }
 }
@@ -136,6 +349,8 @@ Error IntSetting::setStringValue(std::string_view s) {
         return Error::NumberRange;
     }
 
+    changed();
+
     // If we don't see the NVM state, we have to make this the live value:
     if (!_currentIsNvm) {
         _currentValue = convertedValue;
@@ -143,11 +358,9 @@ Error IntSetting::setStringValue(std::string_view s) {
 
     if (_storedValue != convertedValue) {
         if (convertedValue == _defaultValue) {
-            nvs_erase_key(_handle, _keyName);
+            nvsErase(_keyName);
         } else {
-            if (nvs_set_i32(_handle, _keyName, convertedValue)) {
-                return Error::NvsSetFailed;
-            }
+            nvsSet(_keyName, convertedValue);
             _storedValue = convertedValue;
         }
     }
@@ -223,9 +436,10 @@ void StringSetting::load() {
 }
 
 void StringSetting::setDefault() {
+    changed();
     _currentValue = _defaultValue;
     if (_storedValue != _currentValue) {
-        nvs_erase_key(_handle, _keyName);
+        nvsErase(_keyName);
     }
 }
 
@@ -238,15 +452,14 @@ Error StringSetting::setStringValue(std::string_view s) {
         log_error("Setting length error");
         return Error::BadNumberFormat;
     }
+    changed();
     _currentValue = s;
     if (_storedValue != _currentValue) {
         if (_currentValue == _defaultValue) {
-            nvs_erase_key(_handle, _keyName);
+            nvsErase(_keyName);
             _storedValue = _defaultValue;
         } else {
-            if (nvs_set_str(_handle, _keyName, _currentValue.c_str())) {
-                return Error::NvsSetFailed;
-            }
+            nvsSet(_keyName, _currentValue);
             _storedValue = _currentValue;
         }
     }
@@ -291,9 +504,10 @@ void EnumSetting::load() {
 }
 
 void EnumSetting::setDefault() {
+    changed();
     _currentValue = _defaultValue;
     if (_storedValue != _currentValue) {
-        nvs_erase_key(_handle, _keyName);
+        nvsErase(_keyName);
     }
 }
 
@@ -334,14 +548,13 @@ Error EnumSetting::setStringValue(std::string_view s) {
             return Error::BadNumberFormat;
         }
     }
+    changed();
     _currentValue = it->second;
     if (_storedValue != _currentValue) {
         if (_currentValue == _defaultValue) {
-            nvs_erase_key(_handle, _keyName);
+            nvsErase(_keyName);
         } else {
-            if (nvs_set_i8(_handle, _keyName, _currentValue)) {
-                return Error::NvsSetFailed;
-            }
+            nvsSet(_keyName, _currentValue);
             _storedValue = _currentValue;
         }
     }
@@ -417,10 +630,7 @@ bool Coordinates::load() {
 
 void Coordinates::set(float value[MAX_N_AXIS]) {
     memcpy(&_currentValue, value, sizeof(_currentValue));
-    if (FORCE_BUFFER_SYNC_DURING_NVS_WRITE) {
-        protocol_buffer_synchronize();
-    }
-    nvs_set_blob(Setting::_handle, _name, _currentValue, sizeof(_currentValue));
+    Setting::nvsSet(_name, _currentValue, sizeof(_currentValue));
 }
 
 IPaddrSetting::IPaddrSetting(
@@ -452,9 +662,10 @@ void IPaddrSetting::load() {
 }
 
 void IPaddrSetting::setDefault() {
+    changed();
     _currentValue = _defaultValue;
     if (_storedValue != _currentValue) {
-        nvs_erase_key(_handle, _keyName);
+        nvsErase(_keyName);
     }
 }
 
@@ -468,14 +679,13 @@ Error IPaddrSetting::setStringValue(std::string_view s) {
     if (!ipaddr.fromString(str.c_str())) {
         return Error::InvalidValue;
     }
+    changed();
     _currentValue = ipaddr;
     if (_storedValue != _currentValue) {
         if (_currentValue == _defaultValue) {
-            nvs_erase_key(_handle, _keyName);
+            nvsErase(_keyName);
         } else {
-            if (nvs_set_i32(_handle, _keyName, (int32_t)_currentValue)) {
-                return Error::NvsSetFailed;
-            }
+            nvsSet(_keyName, (int32_t)_currentValue);
             _storedValue = _currentValue;
         }
     }
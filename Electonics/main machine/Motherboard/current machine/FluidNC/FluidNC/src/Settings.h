@@ -6,7 +6,9 @@
 #include "GCode.h"   // CoordIndex
 
 #include <string_view>
+#include <atomic>
 #include <map>
+#include <functional>
 #include <nvs.h>
 #include <string_view>
 
@@ -18,6 +20,10 @@ namespace Machine {
 // Initialize the configuration subsystem
 void settings_init();
 
+// Index the names of the commands and settings, once they have all been
+// made, for Command::find(), Setting::find() and Setting::findGrbl()
+void index_settings();
+
 // Define settings restore bitflags.
 enum SettingsRestore {
     Defaults     = bitnum_to_mask(0),
@@ -105,10 +111,15 @@ public:
 
     virtual Error action(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) = 0;
     bool          synchronous() { return _synchronous; }
+
+    // Finds a command by either of its names, ignoring case
+    static Command* find(const char* name);
 };
 
 class Setting : public Word {
 private:
+    static std::atomic<uint32_t> _generation;
+
 protected:
     // group_t _group;
     axis_t      _axis = NO_AXIS;
@@ -118,6 +129,15 @@ public:
     static nvs_handle _handle;
     static void       init();
 
+    // Find a setting by its full name or by its Grbl name, ignoring case
+    static Setting* find(const char* name);
+    static Setting* findGrbl(const char* name);
+
+    // Counts changes to settings and to the configuration tree, so that
+    // anything rendered from them can be cached until the count moves
+    static uint32_t generation() { return _generation; }
+    static void     changed() { ++_generation; }
+
     // Setting::List is a vector of all settings,
     // so common code can enumerate them.
     static std::vector<Setting*> List;
@@ -143,10 +163,21 @@ public:
         return Error::Ok;
     }
 
-    static Error eraseNVS(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out) {
-        nvs_erase_all(_handle);
-        return Error::Ok;
-    }
+    static Error eraseNVS(const char* value, WebUI::AuthenticationLevel auth_level, Channel& out);
+
+    // NVS writes are staged in RAM and written out together, so that a
+    // burst of changes, like the offsets set by a job header, costs one
+    // flash write per key and does not stall motion.  pollNVS() commits
+    // them from the protocol loop once they have settled and, with
+    // FORCE_BUFFER_SYNC_DURING_NVS_WRITE, motion is idle.  commitNVS()
+    // commits them now, as before a restart.
+    static void nvsSet(const char* key, int32_t value);
+    static void nvsSet(const char* key, int8_t value);
+    static void nvsSet(const char* key, const std::string& value);
+    static void nvsSet(const char* key, const void* data, size_t length);
+    static void nvsErase(const char* key);
+    static void pollNVS();
+    static void commitNVS();
 
     ~Setting() {}
     Setting(const char* description, type_t type, permissions_t permissions, const char* grblName, const char* fullName);
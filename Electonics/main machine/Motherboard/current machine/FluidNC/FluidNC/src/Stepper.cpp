@@ -11,10 +11,14 @@
 
 #include "Machine/MachineConfig.h"
 #include "MotionControl.h"
+#include "MotionStats.h"
+#include "Profiler.h"
+#include "Motors/MotorDriver.h"
 #include "Stepping.h"
 #include "StepperPrivate.h"
 #include "Planner.h"
 #include "Protocol.h"
+#include "I2SOut.h"  // i2s_out_write
 #include <esp_attr.h>  // IRAM_ATTR
 #include <cmath>
 
@@ -48,16 +52,78 @@ struct segment_t {
     uint8_t  amass_level;     // AMASS level for the ISR to execute this segment
 };
 static segment_t* segment_buffer = nullptr;
+static uint32_t   n_segments     = 0;  // Size of segment_buffer; config->_stepping->_segments unless adaptive
+
+// Adaptive segment policy state. See Stepping::_adaptiveSegments.
+static bool     adaptive_segments = false;
+static uint32_t active_segments   = 0;     // Entries prep_buffer() may fill, <= n_segments
+static float    latency_budget    = 0.0f;  // Feedhold latency budget (min)
+static float    avg_segment_dt    = 0.0f;  // Running average duration of prepped segments (min)
+
+// Flat copy of the motor configuration, built once by Stepper::init(), so that the
+// stepping ISR does not chase config->_axes->_axis[]->_motors[] on every tick. Axes
+// with no motors simply have n_motors == 0. When every motor has its step signal on
+// a plain I2SO bit, step_bit[] and step_invert[] let the ISR write those bits directly
+// instead of calling the virtual MotorDriver::step() and unstep().
+struct st_motors_t {
+    Machine::Stepping*         stepping;
+    Machine::Motor*            motor[MAX_N_AXIS][Machine::Axis::MAX_MOTORS_PER_AXIS];
+    MotorDrivers::MotorDriver* driver[MAX_N_AXIS][Machine::Axis::MAX_MOTORS_PER_AXIS];
+    pinnum_t                   step_bit[MAX_N_AXIS][Machine::Axis::MAX_MOTORS_PER_AXIS];
+    bool                       step_invert[MAX_N_AXIS][Machine::Axis::MAX_MOTORS_PER_AXIS];
+    uint8_t                    n_motors[MAX_N_AXIS];
+    bool                       direct_i2so;
+};
+static st_motors_t st_motors;
+
+static void build_motor_table() {
+    memset(&st_motors, 0, sizeof(st_motors));
+    st_motors.stepping    = config->_stepping;
+    st_motors.direct_i2so = true;
+
+    auto axes   = config->_axes;
+    auto n_axis = axes->_numberAxis;
+    for (int axis = 0; axis < n_axis; axis++) {
+        auto    a = axes->_axis[axis];
+        uint8_t n = 0;
+        for (int motor = 0; motor < Machine::Axis::MAX_MOTORS_PER_AXIS; motor++) {
+            auto m = a->_motors[motor];
+            if (!m || !m->_driver) {
+                continue;
+            }
+            st_motors.motor[axis][n]  = m;
+            st_motors.driver[axis][n] = m->_driver;
+            if (!m->_driver->i2so_step_bit(st_motors.step_bit[axis][n], st_motors.step_invert[axis][n])) {
+                st_motors.direct_i2so = false;
+            }
+            ++n;
+        }
+        st_motors.n_motors[axis] = n;
+    }
+}
+
+static bool (*pulse_impl)() = nullptr;
+static void select_pulse_impl();
 
 void Stepper::init() {
+    auto stepping     = config->_stepping;
+    adaptive_segments = stepping->_adaptiveSegments;
+    n_segments        = adaptive_segments ? Machine::Stepping::maxSegments : stepping->_segments;
+    active_segments   = stepping->_segments;
+    latency_budget    = stepping->_segments * DT_SEGMENT;
+    avg_segment_dt    = DT_SEGMENT;
+
     if (st_block_buffer) {
         delete[] st_block_buffer;
     }
-    st_block_buffer = new st_block_t[config->_stepping->_segments - 1];
+    st_block_buffer = new st_block_t[n_segments - 1];
     if (segment_buffer) {
         delete[] segment_buffer;
     }
-    segment_buffer = new segment_t[config->_stepping->_segments];
+    segment_buffer = new segment_t[n_segments];
+
+    build_motor_table();
+    select_pulse_impl();
 }
 
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
@@ -199,6 +265,62 @@ void IRAM_ATTR Stepper::stop_stepping() {
 uint32_t Stepper::isr_count;  // for debugging only
 #endif
 
+// Set the direction pins and turn on the step pulses. This is Axes::step() working
+// from the flat motor table, with the axis count fixed at compile time so the loops
+// unroll, and with the step bits written straight to the I2SO shift register when
+// every motor allows it.
+template <int N_AXIS, bool DIRECT_I2SO>
+static inline void IRAM_ATTR step_motors(uint8_t step_mask, uint8_t dir_mask) {
+    // Set the direction pins, but optimize for the common
+    // situation where the direction bits haven't changed.
+    static uint8_t previous_dir = 255;  // should never be this value
+    if (dir_mask != previous_dir) {
+        previous_dir = dir_mask;
+        for (int axis = 0; axis < N_AXIS; axis++) {
+            bool thisDir = bitnum_is_true(dir_mask, axis);
+            for (int motor = 0; motor < st_motors.n_motors[axis]; motor++) {
+                st_motors.driver[axis][motor]->set_direction(thisDir);
+            }
+        }
+        st_motors.stepping->waitDirection();
+    }
+
+    for (int axis = 0; axis < N_AXIS; axis++) {
+        if (bitnum_is_true(step_mask, axis)) {
+            bool dir = bitnum_is_true(dir_mask, axis);
+            for (int motor = 0; motor < st_motors.n_motors[axis]; motor++) {
+                auto m = st_motors.motor[axis][motor];
+                if (DIRECT_I2SO) {
+                    // Same as Motor::step(), minus the virtual driver call
+                    if (m->_blocked || m->_limited) {
+                        continue;
+                    }
+                    i2s_out_write(st_motors.step_bit[axis][motor], !st_motors.step_invert[axis][motor]);
+                    m->_steps += dir ? -1 : 1;
+                } else {
+                    m->step(dir);
+                }
+            }
+        }
+    }
+    st_motors.stepping->startPulseTimer();
+}
+
+template <int N_AXIS, bool DIRECT_I2SO>
+static inline void IRAM_ATTR unstep_motors() {
+    st_motors.stepping->waitPulse();
+    for (int axis = 0; axis < N_AXIS; axis++) {
+        for (int motor = 0; motor < st_motors.n_motors[axis]; motor++) {
+            if (DIRECT_I2SO) {
+                i2s_out_write(st_motors.step_bit[axis][motor], st_motors.step_invert[axis][motor]);
+            } else {
+                st_motors.driver[axis][motor]->unstep();
+            }
+        }
+    }
+    st_motors.stepping->finishPulse();
+}
+
 /**
  * This phase of the ISR should ONLY create the pulses for the steppers.
  * This prevents jitter caused by the interval between the start of the
@@ -206,18 +328,23 @@ uint32_t Stepper::isr_count;  // for debugging only
  * call to this method that might cause variation in the timing. The aim
  * is to keep pulse timing as regular as possible.
  * Returns true if step interrupts should continue
+ *
+ * One instance is generated for each possible axis count and for each way of
+ * driving the step pins; select_pulse_impl() picks the one matching the config.
  */
-bool IRAM_ATTR Stepper::pulse_func() {
+template <int N_AXIS, bool DIRECT_I2SO>
+static bool IRAM_ATTR pulse_func_n() {
+    int32_t isrStart = getCpuTicks();
 #ifdef DEBUG_STEPPER_ISR
-    isr_count++;
+    Stepper::isr_count++;
 #endif
     // This is a precaution in case we get a spurious interrupt
     if (!awake) {
+        MotionStats::isrDone(isrStart);
         return false;
     }
-    auto n_axis = config->_axes->_numberAxis;
 
-    config->_axes->step(st.step_outbits, st.dir_outbits);
+    step_motors<N_AXIS, DIRECT_I2SO>(st.step_outbits, st.dir_outbits);
 
     // If there is no step segment, attempt to pop one from the stepper buffer
     if (st.exec_segment == NULL) {
@@ -226,7 +353,7 @@ bool IRAM_ATTR Stepper::pulse_func() {
             // Initialize new step segment and load number of steps to execute
             st.exec_segment = &segment_buffer[segment_buffer_tail];
             // Initialize step segment timing per step and load number of steps to execute.
-            config->_stepping->setTimerPeriod(st.exec_segment->isrPeriod);
+            st_motors.stepping->setTimerPeriod(st.exec_segment->isrPeriod);
             st.step_count = st.exec_segment->n_step;  // NOTE: Can sometimes be zero when moving slow.
             // If the new segment starts a new planner block, initialize stepper variables and counters.
             // NOTE: When the segment data index changes, this indicates a new planner block.
@@ -234,19 +361,19 @@ bool IRAM_ATTR Stepper::pulse_func() {
                 st.exec_block_index = st.exec_segment->st_block_index;
                 st.exec_block       = &st_block_buffer[st.exec_block_index];
                 // Initialize Bresenham line and distance counters
-                for (int axis = 0; axis < n_axis; axis++) {
+                for (int axis = 0; axis < N_AXIS; axis++) {
                     st.counter[axis] = st.exec_block->step_event_count >> 1;
                 }
             }
 
             st.dir_outbits = st.exec_block->direction_bits;
             // Adjust Bresenham axis increment counters according to AMASS level.
-            for (int axis = 0; axis < n_axis; axis++) {
+            for (int axis = 0; axis < N_AXIS; axis++) {
                 st.steps[axis] = st.exec_block->steps[axis] >> st.exec_segment->amass_level;
             }
         } else {
             // Segment buffer empty. Shutdown.
-            stop_stepping();
+            Stepper::stop_stepping();
             if (!state_is(State::Jog)) {  // added to prevent ... jog after probing crash
                 // Ensure pwm is set properly upon completion of rate-controlled motion.
                 if (st.exec_block != NULL && st.exec_block->is_pwm_rate_adjusted) {}
@@ -254,30 +381,21 @@ bool IRAM_ATTR Stepper::pulse_func() {
 
             protocol_send_event_from_ISR(&cycleStopEvent);
             awake = false;
+            MotionStats::isrDone(isrStart);
             return false;  // Nothing to do but exit.
         }
     }
-#if 0
-    // Check probing state.
-    if (probing && config->_probe->tripped()) {
-        probing = false;
-        auto axes  = config->_axes;
-        for (int axis = 0; axis < n_axis; axis++) {
-            auto m            = axes->_axis[axis]->_motors[0];
-            probe_steps[axis] = m ? m->_steps : 0;
-        }
-        protocol_send_event_from_ISR(&motionCancelEvent);
-    }
-#endif
+
     // Reset step out bits.
     st.step_outbits = 0;
 
-    for (int axis = 0; axis < n_axis; axis++) {
+    uint32_t step_event_count = st.exec_block->step_event_count;
+    for (int axis = 0; axis < N_AXIS; axis++) {
         // Execute step displacement profile by Bresenham line algorithm
         st.counter[axis] += st.steps[axis];
-        if (st.counter[axis] > st.exec_block->step_event_count) {
+        if (st.counter[axis] > step_event_count) {
             set_bitnum(st.step_outbits, axis);
-            st.counter[axis] -= st.exec_block->step_event_count;
+            st.counter[axis] -= step_event_count;
         }
     }
 
@@ -285,13 +403,53 @@ bool IRAM_ATTR Stepper::pulse_func() {
     if (st.step_count == 0) {
         // Segment is complete. Discard current segment and advance segment indexing.
         st.exec_segment     = NULL;
-        segment_buffer_tail = segment_buffer_tail >= (config->_stepping->_segments - 1) ? 0 : segment_buffer_tail + 1;
+        segment_buffer_tail = segment_buffer_tail >= (n_segments - 1) ? 0 : segment_buffer_tail + 1;
     }
 
-    config->_axes->unstep();
+    unstep_motors<N_AXIS, DIRECT_I2SO>();
+    MotionStats::isrDone(isrStart);
     return true;
 }
 
+template <bool DIRECT_I2SO>
+static bool (*pulse_func_for(int n_axis))() {
+    switch (n_axis) {
+        case 1:
+            return pulse_func_n<1, DIRECT_I2SO>;
+        case 2:
+            return pulse_func_n<2, DIRECT_I2SO>;
+        case 3:
+            return pulse_func_n<3, DIRECT_I2SO>;
+        case 4:
+            return pulse_func_n<4, DIRECT_I2SO>;
+        case 5:
+            return pulse_func_n<5, DIRECT_I2SO>;
+        default:
+            return pulse_func_n<MAX_N_AXIS, DIRECT_I2SO>;
+    }
+}
+
+// Chooses the ISR variant for the configured axis count and step pin type.
+static void select_pulse_impl() {
+    auto n_axis = config->_axes->_numberAxis;
+    if (st_motors.direct_i2so) {
+        pulse_impl = pulse_func_for<true>(n_axis);
+    } else {
+        pulse_impl = pulse_func_for<false>(n_axis);
+    }
+    log_info("Stepper ISR: " << n_axis << " axes" << (st_motors.direct_i2so ? ", direct I2SO step bits" : ""));
+}
+
+// The ISR variant chosen by Stepper::init(). The step timer is attached to it directly;
+// pulse_func() remains the entry point for I2S streaming.
+Stepper::isr_func_t Stepper::isr_func() {
+    return pulse_impl;
+}
+
+bool IRAM_ATTR Stepper::pulse_func() {
+    return pulse_impl();
+}
+
 // enabled. Startup init and limits call this function but shouldn't start the cycle.
 void Stepper::wake_up() {
     if (awake) {
@@ -378,10 +536,32 @@ void Stepper::parking_restore_buffer() {
     pl_block = NULL;  // Set to reload next block.
 }
 
+// Number of prepped segments waiting for the stepper ISR
+static uint32_t segments_queued() {
+    return (segment_buffer_head + n_segments - segment_buffer_tail) % n_segments;
+}
+
+// Folds the duration of a newly prepped segment into the running average and, with
+// adaptive segments, resizes the usable part of the segment buffer so that the queued
+// segments add up to the feedhold latency budget.
+static void update_segment_policy(float dt) {
+    avg_segment_dt += SEGMENT_DT_SMOOTHING * (dt - avg_segment_dt);
+    if (!adaptive_segments) {
+        return;
+    }
+    uint32_t depth = uint32_t(ceilf(latency_budget / avg_segment_dt));
+    if (depth < MIN_ADAPTIVE_SEGMENTS) {
+        depth = MIN_ADAPTIVE_SEGMENTS;
+    } else if (depth > n_segments) {
+        depth = n_segments;
+    }
+    active_segments = depth;
+}
+
 // Increments the step segment buffer block data ring buffer.
 static uint8_t next_block_index(uint8_t block_index) {
     block_index++;
-    return block_index == (config->_stepping->_segments - 1) ? 0 : block_index;
+    return block_index == (n_segments - 1) ? 0 : block_index;
 }
 
 /* Prepares step segment buffer. Continuously called from main program.
@@ -397,13 +577,29 @@ static uint8_t next_block_index(uint8_t block_index) {
    Currently, the segment buffer conservatively holds roughly up to 40-50 msec of steps.
    NOTE: Computation units are in steps, millimeters, and minutes.
 */
+// Accumulates the time spent in prep_buffer() into MotionStats, whichever way it returns
+struct PrepTimer {
+    int32_t start = getCpuTicks();
+    ~PrepTimer() {
+        MotionStats::prepDone(start);
+        Profiler::record(ProfileSection::PrepBuffer, start);
+    }
+};
+
 void Stepper::prep_buffer() {
     // Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
     if (sys.step_control.endMotion) {
         return;
     }
 
+    PrepTimer timer;
+    MotionStats::segmentsQueued(segments_queued(), pl_block != NULL || plan_get_current_block() != NULL);
+
     while (segment_buffer_tail != segment_next_head) {  // Check if we need to fill the buffer.
+        // With adaptive segments, stop once the queued segments cover the latency budget.
+        if (adaptive_segments && segments_queued() >= active_segments - 1) {
+            return;
+        }
         // Determine if we need to load a new planner block or if the block needs to be recomputed.
         if (pl_block == NULL) {
             // Query planner for a queued block
@@ -411,6 +607,7 @@ void Stepper::prep_buffer() {
                 pl_block = plan_get_system_motion_block();
             } else {
                 pl_block = plan_get_current_block();
+                MotionStats::plannerEmpty(pl_block == NULL);
             }
 
             if (pl_block == NULL) {
@@ -566,7 +763,15 @@ void Stepper::prep_buffer() {
           the end of planner block (typical) or mid-block at the end of a forced deceleration,
           such as from a feed hold.
         */
-        float dt_max   = DT_SEGMENT;                                // Maximum segment time
+        float dt_segment = DT_SEGMENT;
+        // While cruising well clear of the deceleration point, a segment can cover twice the usual time
+        // without changing the velocity profile, halving the prep work for long moves.
+        if (adaptive_segments && prep.ramp_type == RAMP_CRUISE && !sys.step_control.executeHold &&
+            pl_block->millimeters - prep.maximum_speed * 2.0f * DT_SEGMENT > prep.decelerate_after) {
+            dt_segment = 2.0f * DT_SEGMENT;
+        }
+
+        float dt_max   = dt_segment;                                // Maximum segment time
         float dt       = 0.0;                                       // Initialize segment time
         float time_var = dt_max;                                    // Time worker variable
         float mm_var;                                               // mm-Distance worker variable
@@ -651,7 +856,7 @@ void Stepper::prep_buffer() {
                 if (mm_remaining > minimum_mm) {  // Check for very slow segments with zero steps.
                     // Increase segment time to ensure at least one step in segment. Override and loop
                     // through distance calculations until minimum_mm or mm_complete.
-                    dt_max += DT_SEGMENT;
+                    dt_max += dt_segment;
                     time_var = dt_max - dt;
                 } else {
                     break;  // **Complete** Exit loop. Segment execution time maxed.
@@ -695,6 +900,8 @@ void Stepper::prep_buffer() {
         // typically very small and do not adversely effect performance, but ensures that the
         // system outputs the exact acceleration and velocity profiles computed by the planner.
 
+        update_segment_policy(dt);
+
         dt += prep.dt_remainder;  // Apply previous segment partial step execute time
         // dt is in minutes so inv_rate is in minutes
         float inv_rate = dt / (last_n_steps_remaining - step_dist_remaining);  // Compute adjusted step rate inverse
@@ -720,7 +927,7 @@ void Stepper::prep_buffer() {
 
         // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
         auto lastseg        = segment_next_head;
-        segment_next_head   = segment_next_head >= (config->_stepping->_segments - 1) ? 0 : segment_next_head + 1;
+        segment_next_head   = segment_next_head >= (n_segments - 1) ? 0 : segment_next_head + 1;
         segment_buffer_head = lastseg;
 
         // Update the appropriate planner and segment data.
@@ -18,6 +18,8 @@
 // Change from namespace to class to match Planner.h declaration
 class Stepper {
 public:
+    using isr_func_t = bool (*)();
+
     static void  init();
     static bool  update_plan_block_parameters();  // Changed to return bool
     static bool  pulse_func();                    // Changed to return bool
@@ -30,5 +32,9 @@ public:
     static void  prep_buffer();
     static float get_realtime_rate();
 
+    // The pulse_func() variant specialized for the configured axis count and
+    // step pins.  Valid after init().
+    static isr_func_t isr_func();
+
     static uint32_t isr_count;
 };
@@ -6,6 +6,8 @@
 // Some useful constants.
 const float DT_SEGMENT              = (1.0f / (float(ACCELERATION_TICKS_PER_SECOND) * 60.0f));  // min/segment
 const float REQ_MM_INCREMENT_SCALAR = 1.25f;
+const int   MIN_ADAPTIVE_SEGMENTS   = 6;     // Never run with a shallower segment buffer than this
+const float SEGMENT_DT_SMOOTHING    = 0.25f;  // Weight of the newest segment in the running average
 const int   RAMP_ACCEL              = 0;
 const int   RAMP_CRUISE             = 1;
 const int   RAMP_DECEL              = 2;
@@ -20,17 +20,19 @@ namespace Machine {
         log_info("Stepping:" << stepTypes[_engine].name << " Pulse:" << _pulseUsecs << "us Dsbl Delay:" << _disableDelayUsecs
                              << "us Dir Delay:" << _directionDelayUsecs << "us Idle Delay:" << _idleMsecs << "ms");
 
+        // Stepper::init() chooses the pulse function variant for this
+        // machine, so it must run before the timer is attached.
+        Stepper::init();
+
         // Prepare stepping interrupt callbacks.  The one that is actually
         // used is determined by timerStart() and timerStop()
 
         // Setup a timer for direct stepping
-        stepTimerInit(fStepperTimer, Stepper::pulse_func);
+        stepTimerInit(fStepperTimer, Stepper::isr_func());
 
         // Register pulse_func with the I2S subsystem
         // This could be done via the linker.
         //        i2s_out_set_pulse_callback(Stepper::pulse_func);
-
-        Stepper::init();
     }
 
     void Stepping::reset() {
@@ -57,14 +59,14 @@ namespace Machine {
             _engine = I2S_STREAM;
         }
     }
-    // Called only from Axes::unstep()
+    // Called from Axes::unstep() and the stepper ISR
     void IRAM_ATTR Stepping::waitPulse() {
         if (_engine == I2S_STATIC || _engine == TIMED) {
             spinUntil(_stepPulseEndTime);
         }
     }
 
-    // Called only from Axes::step()
+    // Called from Axes::step() and the stepper ISR
     void IRAM_ATTR Stepping::waitDirection() {
         if (_directionDelayUsecs) {
             // Stepper drivers need some time between changing direction and doing a pulse.
@@ -97,7 +99,7 @@ namespace Machine {
         }
     }
 
-    // Called only from Axes::unstep()
+    // Called from Axes::unstep() and the stepper ISR
     void IRAM_ATTR Stepping::finishPulse() {
         if (_engine == stepper_id_t::I2S_STATIC) {
             i2s_out_push();
@@ -139,7 +141,8 @@ namespace Machine {
         handler.item("pulse_us", _pulseUsecs, 0, 30);
         handler.item("dir_delay_us", _directionDelayUsecs, 0, 10);
         handler.item("disable_delay_us", _disableDelayUsecs, 0, 1000000);  // max 1 second
-        handler.item("segments", _segments, 6, 20);
+        handler.item("segments", _segments, 6, maxSegments);
+        handler.item("adaptive_segments", _adaptiveSegments);
     }
 
     void Stepping::afterParse() {
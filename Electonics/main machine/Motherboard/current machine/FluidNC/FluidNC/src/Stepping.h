@@ -40,6 +40,14 @@ namespace Machine {
 
         size_t _segments = 12;
 
+        // With _adaptiveSegments, the segment buffer is allocated at maxSegments entries, but
+        // Stepper::prep_buffer() only fills as many as fit in the feedhold latency budget of
+        // _segments * 10 ms, based on the measured duration of recent segments.  Dense files
+        // with tiny blocks produce very short segments and get a deeper buffer, while long
+        // cruising moves use double-length segments and need fewer of them.
+        static const size_t maxSegments       = 20;
+        bool                _adaptiveSegments = false;
+
         uint32_t _idleMsecs           = 255;
         uint32_t _pulseUsecs          = 4;
         uint32_t _directionDelayUsecs = 0;
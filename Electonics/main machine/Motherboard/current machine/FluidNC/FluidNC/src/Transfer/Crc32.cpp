@@ -0,0 +1,31 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Crc32.h"
+
+namespace Transfer {
+    static const uint32_t* crcTable() {
+        static uint32_t table[256];
+        static bool     built = false;
+        if (!built) {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                table[i] = c;
+            }
+            built = true;
+        }
+        return table;
+    }
+
+    uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc) {
+        const uint32_t* table = crcTable();
+        crc                   = ~crc;
+        while (length--) {
+            crc = table[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+}
@@ -0,0 +1,13 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Transfer {
+    // The IEEE 802.3 CRC32 used by zip and PNG.  Pass the previous result as
+    // crc to continue a CRC across several buffers.
+    uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+}
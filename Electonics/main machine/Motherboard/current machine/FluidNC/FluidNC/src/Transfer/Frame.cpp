@@ -0,0 +1,57 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Frame.h"
+#include "Crc32.h"
+
+namespace Transfer {
+    void makeControlFrame(uint8_t* out, FrameType type, uint32_t arg) {
+        out[0] = Sync;
+        out[1] = uint8_t(type);
+        put32(out + 2, arg);
+        put32(out + 6, crc32(out + 1, 5));
+    }
+
+    size_t makeDataFrame(uint8_t* out, FrameType type, uint32_t seq, uint16_t payloadLength, uint16_t rawLength, uint8_t flags) {
+        out[0] = Sync;
+        out[1] = uint8_t(type);
+        put32(out + 2, seq);
+        put16(out + 6, payloadLength);
+        put16(out + 8, rawLength);
+        out[10]       = flags;
+        size_t length = DataHeaderSize + payloadLength;
+        put32(out + length, crc32(out + 1, length - 1));
+        return length + CrcSize;
+    }
+
+    bool ControlParser::parse(const uint8_t*& data, size_t& length, FrameType& type, uint32_t& arg) {
+        while (length) {
+            uint8_t c = *data++;
+            --length;
+            if (_length == 0 && c != Sync) {
+                continue;
+            }
+            _frame[_length++] = c;
+            if (_length < ControlFrameSize) {
+                continue;
+            }
+            _length = 0;
+            if (get32(_frame + 6) == crc32(_frame + 1, 5)) {
+                type = FrameType(_frame[1]);
+                arg  = get32(_frame + 2);
+                return true;
+            }
+            // Not a frame after all; the byte after this Sync may start one
+            for (size_t i = 1; i < ControlFrameSize; i++) {
+                if (_frame[i] == Sync) {
+                    _length = ControlFrameSize - i;
+                    for (size_t j = 0; j < _length; j++) {
+                        _frame[j] = _frame[i + j];
+                    }
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// Wire format of the windowed file transfer protocol used by $Transfer/Receive.
+//
+// The host sends the file as a numbered sequence of data frames, each holding
+// up to the negotiated frame size of file data, optionally LZ4-compressed,
+// followed by an end frame that carries the total length and CRC32 of the file.
+// Up to "window" frames may be unacknowledged at once.  The device acks
+// every frame it writes with the number of the next frame it expects; when a
+// frame is missing or damaged it sends a nak with that number and the host
+// goes back and resends from there (go-back-N).
+//
+// Host to device, all multi-byte fields little-endian:
+//
+//   Sync  Type  Seq(4)  PayloadLen(2)  RawLen(2)  Flags  Payload  CRC32(4)
+//
+//   Type 'D' data, 'E' end (payload is file length(4) and file CRC32(4)),
+//   'X' cancel.  RawLen is the decompressed length of a data frame.  The
+//   CRC32 covers everything from Type through the payload.
+//
+// Device to host:
+//
+//   Sync  Type  Arg(4)  CRC32(4)
+//
+//   Type 'H' hello (Arg is version << 24 | window << 16 | max frame size),
+//   'A' ack and 'N' nak (Arg is the next frame expected), 'K' done
+//   (Arg is the file length), 'F' failed (Arg is a FailCode).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Transfer {
+    const uint8_t Sync    = 0xA5;
+    const uint8_t Version = 1;
+
+    const uint16_t DefaultFrameSize = 4096;
+    const uint16_t MaxFrameSize     = 8192;
+    const uint8_t  DefaultWindow    = 8;
+
+    const size_t DataHeaderSize   = 11;
+    const size_t CrcSize          = 4;
+    const size_t ControlFrameSize = 10;
+    const size_t EndPayloadSize   = 8;
+
+    enum class FrameType : uint8_t {
+        Data   = 'D',
+        End    = 'E',
+        Cancel = 'X',
+        Hello  = 'H',
+        Ack    = 'A',
+        Nak    = 'N',
+        Done   = 'K',
+        Fail   = 'F',
+    };
+
+    enum FrameFlags : uint8_t {
+        Compressed = 1,
+    };
+
+    enum class FailCode : uint32_t {
+        None = 0,
+        Write,       // The file could not be written
+        Decompress,  // A frame did not decompress to its stated length
+        Length,      // The file length in the end frame does not match
+        Crc,         // The file CRC in the end frame does not match
+        Timeout,     // The host stopped sending
+        Cancelled,   // The host sent a cancel frame
+    };
+
+    inline void put16(uint8_t* p, uint16_t v) {
+        p[0] = v;
+        p[1] = v >> 8;
+    }
+    inline void put32(uint8_t* p, uint32_t v) {
+        p[0] = v;
+        p[1] = v >> 8;
+        p[2] = v >> 16;
+        p[3] = v >> 24;
+    }
+    inline uint16_t get16(const uint8_t* p) {
+        return p[0] | (p[1] << 8);
+    }
+    inline uint32_t get32(const uint8_t* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    // Builds a device-to-host frame in out, which must hold ControlFrameSize bytes
+    void makeControlFrame(uint8_t* out, FrameType type, uint32_t arg);
+
+    // Builds a host-to-device frame around payload, which must already be at
+    // out + DataHeaderSize.  Returns the total frame length.
+    size_t makeDataFrame(uint8_t* out, FrameType type, uint32_t seq, uint16_t payloadLength, uint16_t rawLength, uint8_t flags);
+
+    // Finds device-to-host frames in a byte stream, skipping anything else,
+    // such as log messages, that the channel carries
+    class ControlParser {
+        uint8_t _frame[ControlFrameSize];
+        size_t  _length = 0;
+
+    public:
+        // Consumes bytes from data; returns true when a valid frame has been
+        // found, with its type and argument.  Call again with the remaining
+        // bytes, which is length less the number consumed.
+        bool parse(const uint8_t*& data, size_t& length, FrameType& type, uint32_t& arg);
+    };
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Lz4.h"
+
+#include <cstring>
+#include <vector>
+
+namespace Transfer {
+    namespace Lz4 {
+        // Limits from the LZ4 block format: a match is at least 4 bytes, the
+        // last 5 bytes are always literals, and no match starts in the last 12.
+        const size_t MinMatch     = 4;
+        const size_t LastLiterals = 5;
+        const size_t MatchLimit   = 12;
+        const int    HashBits     = 12;
+
+        static uint32_t read32(const uint8_t* p) {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            return v;
+        }
+
+        static uint32_t hash(uint32_t v) {
+            return (v * 2654435761u) >> (32 - HashBits);
+        }
+
+        class Output {
+            uint8_t* _out;
+            size_t   _capacity;
+            size_t   _length = 0;
+
+        public:
+            bool ok = true;
+
+            Output(uint8_t* out, size_t capacity) : _out(out), _capacity(capacity) {}
+
+            void put(uint8_t b) {
+                if (_length < _capacity) {
+                    _out[_length++] = b;
+                } else {
+                    ok = false;
+                }
+            }
+            void put(const uint8_t* p, size_t n) {
+                if (_capacity - _length >= n) {
+                    memcpy(_out + _length, p, n);
+                    _length += n;
+                } else {
+                    ok = false;
+                }
+            }
+            // The bytes of a length that did not fit in its 4-bit token field
+            void putLength(size_t n) {
+                for (; n >= 255; n -= 255) {
+                    put(255);
+                }
+                put(uint8_t(n));
+            }
+            size_t length() { return _length; }
+        };
+
+        static void sequence(Output& out, const uint8_t* literals, size_t nLiterals, size_t offset, size_t matchLength) {
+            size_t  extra = matchLength ? matchLength - MinMatch : 0;
+            uint8_t token = uint8_t((nLiterals < 15 ? nLiterals : 15) << 4);
+            if (matchLength) {
+                token |= extra < 15 ? extra : 15;
+            }
+            out.put(token);
+            if (nLiterals >= 15) {
+                out.putLength(nLiterals - 15);
+            }
+            out.put(literals, nLiterals);
+            if (matchLength) {
+                out.put(uint8_t(offset));
+                out.put(uint8_t(offset >> 8));
+                if (extra >= 15) {
+                    out.putLength(extra - 15);
+                }
+            }
+        }
+
+        size_t compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+            if (length > 65535) {
+                return 0;
+            }
+            Output                o(out, capacity);
+            std::vector<uint16_t> table(1 << HashBits, 0xffff);
+
+            size_t anchor = 0;
+            if (length > MatchLimit) {
+                size_t limit    = length - MatchLimit;
+                size_t matchEnd = length - LastLiterals;
+                for (size_t ip = 0; ip < limit && o.ok;) {
+                    uint32_t v   = read32(in + ip);
+                    uint32_t h   = hash(v);
+                    size_t   ref = table[h];
+                    table[h]     = uint16_t(ip);
+                    if (ref == 0xffff || read32(in + ref) != v) {
+                        ++ip;
+                        continue;
+                    }
+                    size_t n = MinMatch;
+                    while (ip + n < matchEnd && in[ref + n] == in[ip + n]) {
+                        ++n;
+                    }
+                    sequence(o, in + anchor, ip - anchor, ip - ref, n);
+                    ip += n;
+                    anchor = ip;
+                }
+            }
+            sequence(o, in + anchor, length - anchor, 0, 0);
+            return o.ok ? o.length() : 0;
+        }
+
+        int decompress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+            size_t ip = 0;
+            size_t op = 0;
+
+            // Reads the extension bytes of a length field
+            auto extend = [&](size_t& n) {
+                uint8_t b;
+                do {
+                    if (ip >= length) {
+                        return false;
+                    }
+                    b = in[ip++];
+                    n += b;
+                } while (b == 255);
+                return true;
+            };
+
+            while (ip < length) {
+                uint8_t token     = in[ip++];
+                size_t  nLiterals = token >> 4;
+                if (nLiterals == 15 && !extend(nLiterals)) {
+                    return -1;
+                }
+                if (nLiterals > length - ip || nLiterals > capacity - op) {
+                    return -1;
+                }
+                memcpy(out + op, in + ip, nLiterals);
+                ip += nLiterals;
+                op += nLiterals;
+
+                if (ip == length) {
+                    break;  // The last sequence has no match
+                }
+                if (length - ip < 2) {
+                    return -1;
+                }
+                size_t offset = in[ip] | (in[ip + 1] << 8);
+                ip += 2;
+                if (offset == 0 || offset > op) {
+                    return -1;
+                }
+                size_t n = token & 15;
+                if (n == 15 && !extend(n)) {
+                    return -1;
+                }
+                n += MinMatch;
+                if (n > capacity - op) {
+                    return -1;
+                }
+                // Byte by byte because the match may overlap its own output
+                for (const uint8_t* from = out + op - offset; n--;) {
+                    out[op++] = *from++;
+                }
+            }
+            return int(op);
+        }
+    }
+}
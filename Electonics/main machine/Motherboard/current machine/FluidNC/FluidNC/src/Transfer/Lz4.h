@@ -0,0 +1,24 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+// LZ4 block format compression.  The decompressor is what the device uses on
+// each received frame; it checks every length and offset, so a damaged or
+// hostile frame can only fail, not overrun.  The compressor is a simple
+// greedy one for the host side, whose output any LZ4 block decoder accepts.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Transfer {
+    namespace Lz4 {
+        // Returns the compressed length, or 0 if the result would not fit in capacity.
+        // length must not exceed 65535.
+        size_t compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity);
+
+        // Returns the decompressed length, or -1 if the input is malformed or
+        // decompresses to more than capacity
+        int decompress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity);
+    }
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Receiver.h"
+#include "Crc32.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Transfer {
+    Receiver::Receiver(Output output, Sink sink, uint16_t frameSize, uint8_t window) :
+        _output(output), _sink(sink), _frameSize(std::min(frameSize, MaxFrameSize)), _window(std::max(window, uint8_t(1))) {
+        _frame.resize(DataHeaderSize + _frameSize + CrcSize);
+        _raw.resize(_frameSize);
+    }
+
+    void Receiver::control(FrameType type, uint32_t arg) {
+        uint8_t frame[ControlFrameSize];
+        makeControlFrame(frame, type, arg);
+        _output(frame, sizeof(frame));
+    }
+
+    void Receiver::hello() {
+        control(FrameType::Hello, (uint32_t(Version) << 24) | (uint32_t(_window) << 16) | _frameSize);
+    }
+
+    // Only the first nak for a missing frame is sent; the host goes back
+    // to it, and the frames already in flight behind it are discarded
+    // quietly as they arrive.
+    void Receiver::nak() {
+        if (!_nakSent) {
+            _nakSent = true;
+            control(FrameType::Nak, _next);
+        }
+    }
+
+    void Receiver::timeout() {
+        if (_state == State::Running) {
+            control(FrameType::Nak, _next);
+            _nakSent = true;
+        }
+    }
+
+    void Receiver::fail(FailCode code) {
+        _state    = State::Failed;
+        _failCode = code;
+        control(FrameType::Fail, uint32_t(code));
+    }
+
+    void Receiver::receive(const uint8_t* data, size_t length) {
+        while (length && _state != State::Failed) {
+            if (_have == 0) {
+                // Look for the start of a frame
+                auto sync = static_cast<const uint8_t*>(memchr(data, Sync, length));
+                if (!sync) {
+                    return;
+                }
+                length -= sync - data;
+                data = sync;
+            }
+            size_t n = std::min(length, _need - _have);
+            memcpy(_frame.data() + _have, data, n);
+            _have += n;
+            data += n;
+            length -= n;
+
+            if (_have == DataHeaderSize && _need == DataHeaderSize) {
+                auto   type    = FrameType(_frame[1]);
+                size_t payload = get16(_frame.data() + 6);
+                if ((type != FrameType::Data && type != FrameType::End && type != FrameType::Cancel) || payload > _frameSize) {
+                    // Not a header; start looking again
+                    _have = 0;
+                    continue;
+                }
+                _need = DataHeaderSize + payload + CrcSize;
+            }
+            if (_have == _need) {
+                frame();
+                _have = 0;
+                _need = DataHeaderSize;
+            }
+        }
+    }
+
+    void Receiver::frame() {
+        size_t length = _need - CrcSize;
+        if (get32(_frame.data() + length) != crc32(_frame.data() + 1, length - 1)) {
+            nak();
+            return;
+        }
+        _heard = true;
+
+        auto     type    = FrameType(_frame[1]);
+        uint32_t seq     = get32(_frame.data() + 2);
+        auto     payload = _frame.data() + DataHeaderSize;
+        size_t   n       = length - DataHeaderSize;
+
+        if (type == FrameType::Cancel) {
+            fail(FailCode::Cancelled);
+            return;
+        }
+        if (_state == State::Done) {
+            // The host missed the final reply
+            control(FrameType::Done, _fileLength);
+            return;
+        }
+        if (seq != _next) {
+            if (seq < _next) {
+                // A resend of a frame that was already written
+                control(FrameType::Ack, _next);
+            } else {
+                nak();
+            }
+            return;
+        }
+        if (type == FrameType::Data) {
+            data(payload, n, get16(_frame.data() + 8), _frame[10]);
+        } else {
+            end(payload, n);
+        }
+    }
+
+    void Receiver::data(const uint8_t* payload, size_t length, size_t rawLength, uint8_t flags) {
+        if (flags & Compressed) {
+            if (Lz4::decompress(payload, length, _raw.data(), _raw.size()) != int(rawLength)) {
+                fail(FailCode::Decompress);
+                return;
+            }
+            payload = _raw.data();
+            length  = rawLength;
+        } else if (length != rawLength) {
+            fail(FailCode::Decompress);
+            return;
+        }
+        if (length && !_sink(payload, length)) {
+            fail(FailCode::Write);
+            return;
+        }
+        _fileCrc = crc32(payload, length, _fileCrc);
+        _fileLength += length;
+        ++_next;
+        _nakSent = false;
+        control(FrameType::Ack, _next);
+    }
+
+    void Receiver::end(const uint8_t* payload, size_t length) {
+        if (length != EndPayloadSize || get32(payload) != _fileLength) {
+            fail(FailCode::Length);
+            return;
+        }
+        if (get32(payload + 4) != _fileCrc) {
+            fail(FailCode::Crc);
+            return;
+        }
+        ++_next;
+        _state = State::Done;
+        control(FrameType::Done, _fileLength);
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "Frame.h"
+
+#include <functional>
+#include <vector>
+
+namespace Transfer {
+    // The device end of the transfer protocol in Frame.h.  It does no I/O of
+    // its own: bytes from the host are given to receive(), replies to the
+    // host go out through the output function and file data goes to the
+    // sink, so the same code runs against a Channel on the device and
+    // against an in-memory link in the host tests.
+    class Receiver {
+    public:
+        using Output = std::function<void(const uint8_t* data, size_t length)>;
+        using Sink   = std::function<bool(const uint8_t* data, size_t length)>;  // false on write error
+
+        enum class State { Running, Done, Failed };
+
+    private:
+        Output   _output;
+        Sink     _sink;
+        uint16_t _frameSize;
+        uint8_t  _window;
+
+        std::vector<uint8_t> _frame;  // The frame being collected
+        std::vector<uint8_t> _raw;    // A decompressed frame
+        size_t               _have = 0;
+        size_t               _need = DataHeaderSize;
+
+        uint32_t _next       = 0;  // The frame number expected next
+        bool     _nakSent    = false;
+        bool     _heard      = false;
+        uint32_t _fileLength = 0;
+        uint32_t _fileCrc    = 0;
+        State    _state      = State::Running;
+        FailCode _failCode   = FailCode::None;
+
+        void control(FrameType type, uint32_t arg);
+        void frame();
+        void data(const uint8_t* payload, size_t length, size_t rawLength, uint8_t flags);
+        void end(const uint8_t* payload, size_t length);
+        void nak();
+
+    public:
+        Receiver(Output output, Sink sink, uint16_t frameSize = MaxFrameSize, uint8_t window = DefaultWindow);
+
+        // Announces the protocol and its parameters to the host
+        void hello();
+
+        void receive(const uint8_t* data, size_t length);
+
+        // Nothing has arrived for a while; ask the host to resend from the
+        // first frame that has not been received
+        void timeout();
+
+        // Gives up, telling the host why
+        void fail(FailCode code);
+
+        State    state() { return _state; }
+        FailCode failCode() { return _failCode; }
+        uint32_t fileLength() { return _fileLength; }
+
+        // True once a good frame has arrived, i.e. the host speaks this protocol
+        bool heard() { return _heard; }
+    };
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Sender.h"
+#include "Crc32.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Transfer {
+    Sender::Sender(const uint8_t* data, size_t length, Output output, bool compress, uint16_t frameSize) :
+        _data(data), _length(length), _output(output), _compress(compress), _frameSize(std::min(frameSize, MaxFrameSize)),
+        _fileCrc(crc32(data, length)) {}
+
+    void Sender::send(uint32_t seq) {
+        uint8_t* payload = _buffer.data() + DataHeaderSize;
+        size_t   frameLength;
+        if (seq < _frames) {
+            size_t         offset = size_t(seq) * _frameSize;
+            size_t         n      = std::min(size_t(_frameSize), _length - offset);
+            const uint8_t* chunk  = _data + offset;
+            // Compressed only if that makes the frame smaller
+            size_t packed = _compress && n > 1 ? Lz4::compress(chunk, n, payload, n - 1) : 0;
+            if (packed) {
+                frameLength = makeDataFrame(_buffer.data(), FrameType::Data, seq, packed, n, Compressed);
+                ++_stats.compressed;
+            } else {
+                memcpy(payload, chunk, n);
+                frameLength = makeDataFrame(_buffer.data(), FrameType::Data, seq, n, n, 0);
+            }
+        } else {
+            put32(payload, _length);
+            put32(payload + 4, _fileCrc);
+            frameLength = makeDataFrame(_buffer.data(), FrameType::End, seq, EndPayloadSize, EndPayloadSize, 0);
+        }
+        ++_stats.frames;
+        if (seq < _stats.sentThrough) {
+            ++_stats.resends;
+        } else {
+            _stats.sentThrough = seq + 1;
+        }
+        _stats.wireBytes += frameLength;
+        _output(_buffer.data(), frameLength);
+    }
+
+    void Sender::pump() {
+        while (_state == State::Running && _nextSeq <= _frames && _nextSeq < _base + _window) {
+            send(_nextSeq++);
+        }
+    }
+
+    void Sender::timeout() {
+        _nextSeq = _base;
+    }
+
+    void Sender::cancel() {
+        uint8_t frame[DataHeaderSize + CrcSize];
+        _output(frame, makeDataFrame(frame, FrameType::Cancel, 0, 0, 0, 0));
+        _state    = State::Failed;
+        _failCode = FailCode::Cancelled;
+    }
+
+    void Sender::receive(const uint8_t* data, size_t length) {
+        FrameType type;
+        uint32_t  arg;
+        while (_parser.parse(data, length, type, arg)) {
+            switch (type) {
+                case FrameType::Hello:
+                    if (_state == State::WaitingHello && (arg >> 24) == Version) {
+                        _frameSize = std::max(uint16_t(1), std::min(_frameSize, uint16_t(arg)));
+                        _window    = std::max(uint8_t(1), uint8_t(arg >> 16));
+                        _frames    = uint32_t((_length + _frameSize - 1) / _frameSize);
+                        _buffer.resize(DataHeaderSize + _frameSize + CrcSize);
+                        _state = State::Running;
+                    }
+                    break;
+                case FrameType::Ack:
+                    if (arg > _base) {
+                        _base    = std::min(arg, _frames + 1);
+                        _nextSeq = std::max(_nextSeq, _base);
+                    }
+                    break;
+                case FrameType::Nak:
+                    _base    = std::max(_base, std::min(arg, _frames));
+                    _nextSeq = _base;
+                    break;
+                case FrameType::Done:
+                    _state = State::Done;
+                    break;
+                case FrameType::Fail:
+                    _state    = State::Failed;
+                    _failCode = FailCode(arg);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
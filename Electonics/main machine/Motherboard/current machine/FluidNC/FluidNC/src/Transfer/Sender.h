@@ -0,0 +1,69 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "Frame.h"
+
+#include <functional>
+#include <vector>
+
+namespace Transfer {
+    // The host end of the transfer protocol in Frame.h - the reference
+    // implementation used by tools/TransferSend.cpp and the host tests.
+    // Like Receiver it does no I/O: replies from the device go to receive(),
+    // frames go out through the output function.
+    class Sender {
+    public:
+        using Output = std::function<void(const uint8_t* data, size_t length)>;
+
+        enum class State { WaitingHello, Running, Done, Failed };
+
+        struct Stats {
+            uint32_t frames      = 0;  // Frames sent, including resends
+            uint32_t resends     = 0;  // Frames sent more than once
+            uint32_t compressed  = 0;  // Data frames sent compressed
+            uint64_t wireBytes   = 0;  // Bytes of frames sent
+            uint64_t sentThrough = 0;  // Highest frame number sent so far, plus 1
+        };
+
+    private:
+        const uint8_t* _data;
+        size_t         _length;
+        Output         _output;
+        bool           _compress;
+        uint16_t       _frameSize;
+        uint8_t        _window = 1;
+        uint32_t       _fileCrc;
+
+        uint32_t _frames  = 0;  // Number of data frames; the end frame follows them
+        uint32_t _base    = 0;  // Oldest frame not yet acknowledged
+        uint32_t _nextSeq = 0;  // Next frame to send
+
+        State    _state    = State::WaitingHello;
+        FailCode _failCode = FailCode::None;
+        Stats    _stats;
+
+        std::vector<uint8_t> _buffer;
+        ControlParser        _parser;
+
+        void send(uint32_t seq);
+
+    public:
+        Sender(const uint8_t* data, size_t length, Output output, bool compress = true, uint16_t frameSize = DefaultFrameSize);
+
+        void receive(const uint8_t* data, size_t length);
+
+        // Sends as many frames as the window allows
+        void pump();
+
+        // Nothing has been heard for a while; resend everything unacknowledged
+        void timeout();
+
+        void cancel();
+
+        State        state() { return _state; }
+        FailCode     failCode() { return _failCode; }
+        const Stats& stats() { return _stats; }
+    };
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "Transfer.h"
+#include "Receiver.h"
+
+#include "../xmodem.h"
+#include "../Logging.h"
+
+using namespace Transfer;
+
+// The UART driver buffers Channel::rx_buffer_size() bytes (1 KiB), about
+// 90 ms of input at 115200 baud.  A window of four 2 KiB frames keeps 8 KiB
+// in flight, which covers the round trip of the acks, so a file system write
+// that stalls for longer than the driver buffer lasts can overrun it.  The
+// lost frame is then resent with the ones behind it, which costs at most
+// one window.
+static const uint16_t frameSize = 2048;
+static const uint8_t  window    = 4;
+
+static const TickType_t pollTicks   = 20;    // One read of the channel
+static const TickType_t helloTicks  = 1000;  // Waiting for the host to start
+static const int        helloTries  = 3;
+static const int        idlePolls   = 1000 / pollTicks;  // Nak after a second of silence
+static const int        maxIdleNaks = 10;                // Give up after this many
+static const int        lingerPolls = 1000 / pollTicks;  // Answer resent End frames after Done
+
+int transferReceive(Channel* serial, FileStream* outfile) {
+    Receiver rx([serial](const uint8_t* data, size_t length) { serial->write(data, length); },
+                [outfile](const uint8_t* data, size_t length) { return outfile->write(data, length) == length; },
+                frameSize,
+                window);
+
+    uint8_t buffer[256];
+    size_t  n;
+
+    for (int tries = 0; !rx.heard(); ++tries) {
+        if (tries == helloTries) {
+            // Nothing that speaks the protocol is listening
+            return xmodemReceive(serial, outfile);
+        }
+        rx.hello();
+        if ((n = serial->timedReadBytes(buffer, sizeof(buffer), helloTicks)) != 0) {
+            rx.receive(buffer, n);
+        }
+    }
+
+    int idle  = 0;
+    int naks  = 0;
+    int after = 0;
+    while (rx.state() != Receiver::State::Failed) {
+        n = serial->timedReadBytes(buffer, sizeof(buffer), pollTicks);
+        if (n) {
+            rx.receive(buffer, n);
+            idle = naks = 0;
+        } else if (rx.state() == Receiver::State::Done) {
+            if (++after == lingerPolls) {
+                break;
+            }
+        } else if (++idle == idlePolls) {
+            idle = 0;
+            if (++naks == maxIdleNaks) {
+                rx.fail(FailCode::Timeout);
+            } else {
+                rx.timeout();
+            }
+        }
+    }
+    if (rx.state() != Receiver::State::Done) {
+        log_debug("Transfer failed with code " << int(rx.failCode()));
+        return -1;
+    }
+    return rx.fileLength();
+}
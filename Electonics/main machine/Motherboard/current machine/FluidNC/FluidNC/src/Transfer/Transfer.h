@@ -0,0 +1,12 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include "../Channel.h"
+#include "../FileStream.h"
+
+// Receives a file with the windowed protocol in Frame.h, falling back to
+// XMODEM if the host does not answer the announcement.  Returns the number
+// of bytes received, or -1 on failure, like xmodemReceive().
+int transferReceive(Channel* serial, FileStream* outfile);
@@ -6,6 +6,7 @@
  */
 
 #include "Uart.h"
+#include "Channel.h"  // rx_buffer_size()
 
 #include <driver/uart.h>
 #include <esp_ipc.h>
@@ -13,8 +14,11 @@
 
 Uart::Uart(int uart_num) : _uart_num(uart_num) {}
 
+// The driver's receive buffer holds as much as a character-counting sender
+// can have in flight, so nothing is lost while the polling task is too busy
+// to move input into the channel's own buffer.
 static void uart_driver_n_install(void* arg) {
-    uart_driver_install((uart_port_t)arg, 256, 0, 0, NULL, ESP_INTR_FLAG_IRAM);
+    uart_driver_install((uart_port_t)arg, Channel::rx_buffer_size(), 0, 0, NULL, ESP_INTR_FLAG_IRAM);
 }
 
 // This version is used for the initial console UART where we do not want to change the pins
@@ -79,10 +83,17 @@ size_t Uart::write(const char* text) {
 }
 
 size_t Uart::timedReadBytes(char* buffer, size_t len, TickType_t timeout) {
+    size_t pushed = 0;
+    if (_pushback != -1 && len) {
+        *buffer++ = _pushback;
+        _pushback = -1;
+        --len;
+        pushed = 1;
+    }
     int res = uart_read_bytes(uart_port_t(_uart_num), buffer, len, timeout);
     // If res < 0, no bytes were read
 
-    return res < 0 ? 0 : res;
+    return pushed + (res < 0 ? 0 : res);
 }
 
 void Uart::forceXon() {
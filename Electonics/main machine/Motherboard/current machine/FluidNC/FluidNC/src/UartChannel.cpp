@@ -5,8 +5,10 @@
 #include "Machine/MachineConfig.h"  // config
 #include "Serial.h"                 // allChannels
 
+#include <algorithm>
+
 UartChannel::UartChannel(int num, bool addCR) : Channel("uart_channel", num, addCR) {
-    _lineedit = new Lineedit(this, _line, Channel::maxLine - 1);
+    _lineedit = new Lineedit(this, _editLine, Channel::maxLine - 1);
     _active   = false;
 }
 
@@ -73,25 +75,110 @@ int UartChannel::peek() {
     return _uart->peek();
 }
 
-int UartChannel::rx_buffer_available() {
-    return _uart->rx_buffer_available();
+int UartChannel::rx_device_pending() {
+    return _uart->available();
 }
 
 bool UartChannel::realtimeOkay(char c) {
     return _lineedit->realtime(c);
 }
 
-bool UartChannel::lineComplete(char* line, char c) {
-    if (_lineedit->step(c)) {
-        _linelen        = _lineedit->finish();
-        _line[_linelen] = '\0';
-        strcpy(line, _line);
-        _linelen = 0;
+
+size_t UartChannel::rxBytes(uint8_t* buffer, size_t length) {
+    // One driver call for everything that has arrived, instead of one per character
+    size_t n   = _uart->timedReadBytes(buffer, length, 0);
+    auto   end = std::remove(buffer, buffer + n, 0x11);
+    if (end != buffer + n) {
+        // 0x11 is XON.  If we receive that, it is a request to use software flow control
+        _uart->setSwFlowControl(true, -1, -1);
+    }
+    return end - buffer;
+}
+
+// The number of bytes before the first control character other than a line
+// ending.  Any such character can start line editing.
+static size_t plainText(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        uint32_t word;
+        memcpy(&word, data + i, 4);
+        // Nonzero if any byte is below 0x20
+        if ((word - 0x20202020u) & ~word & 0x80808080u) {
+            break;
+        }
+    }
+    for (; i < length; ++i) {
+        uint8_t c = data[i];
+        if (c < ' ' && c != '\r' && c != '\n') {
+            break;
+        }
+    }
+    return i;
+}
+
+size_t UartChannel::queueInput(const uint8_t* data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        if (!_editing) {
+            // Streamed text is queued in bulk and assembled into lines later
+            size_t n      = plainText(data + done, length - done);
+            size_t queued = Channel::queueInput(data + done, n);
+            done += queued;
+            if (queued < n || done == length) {
+                break;
+            }
+        }
+        uint8_t c = data[done++];
+        if (realtimeOkay(c) && is_realtime_command(c)) {
+            handleRealtimeCharacter(c);
+            continue;
+        }
+        if (!_editing) {
+            startEditing();
+        }
+        if (_lineedit->step(c)) {
+            queueEdited();
+            // Back to bulk input at a line boundary once ^L turns editing off
+            _editing = _lineedit->is_editing();
+        }
+    }
+    return done;
+}
+
+// Input queued in bulk has not been through the editor yet.  It goes through
+// now, ahead of the character that starts editing; the lines it finishes are
+// queued again behind the ones still waiting, so the order is kept.
+void UartChannel::startEditing() {
+    _editing = true;
+    for (size_t i = 0; i < _linelen; ++i) {
+        _lineedit->step(_line[i]);
+    }
+    _linelen = 0;
+    for (size_t n = _queue.size(); n; --n) {
+        if (_lineedit->step(_queue.pop())) {
+            queueEdited();
+        }
+    }
+}
+
+// Lines go into the history as they are assembled, so it stays in order
+// whether or not a line went through the editor
+bool UartChannel::assembleLine(char* line) {
+    if (Channel::assembleLine(line)) {
+        _lineedit->remember(line);
         return true;
     }
     return false;
 }
 
+void UartChannel::queueEdited() {
+    size_t len = _lineedit->finish(false);
+    if (_queue.space() > len) {
+        _queue.push(reinterpret_cast<const uint8_t*>(_editLine), len);
+        _queue.push('\n');
+    }
+}
+
 int UartChannel::read() {
     int c = _uart->read();
     if (c == 0x11) {
@@ -112,10 +199,9 @@ size_t UartChannel::timedReadBytes(char* buffer, size_t length, TickType_t timeo
     // used in situations where the UART is not receiving GCode commands
     // and Grbl realtime characters.
     size_t remlen = length;
-    while (remlen && _queue.size()) {
-        *buffer++ = _queue.front();
-        _queue.pop();
-    }
+    size_t queued = _queue.pop(reinterpret_cast<uint8_t*>(buffer), remlen);
+    buffer += queued;
+    remlen -= queued;
 
     int res = _uart->timedReadBytes(buffer, remlen, timeout);
     // If res < 0, no bytes were read
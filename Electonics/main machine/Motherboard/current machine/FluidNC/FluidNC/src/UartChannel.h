@@ -12,6 +12,15 @@ private:
     Lineedit* _lineedit;
     Uart*     _uart;
 
+    // While _editing, input goes through _lineedit as it arrives, so that the
+    // editor has seen everything before a character when that character is
+    // checked for realtime, and only finished lines are queued.
+    bool _editing                    = false;
+    char _editLine[Channel::maxLine] = {};
+
+    void startEditing();
+    void queueEdited();
+
     int _uart_num           = 0;
     int _report_interval_ms = 0;
 
@@ -19,6 +28,7 @@ private:
 
 public:
     UartChannel(int num, bool addCR = false);
+    ~UartChannel() { delete _lineedit; }
 
     void init();
     void init(Uart* uart);
@@ -34,12 +44,14 @@ public:
     int read() override;
 
     // Channel methods
-    int    rx_buffer_available() override;
+    int    rx_device_pending() override;
     void   flushRx() override;
     size_t timedReadBytes(char* buffer, size_t length, TickType_t timeout);
     size_t timedReadBytes(uint8_t* buffer, size_t length, TickType_t timeout) { return timedReadBytes((char*)buffer, length, timeout); };
     bool   realtimeOkay(char c) override;
-    bool   lineComplete(char* line, char c) override;
+    size_t rxBytes(uint8_t* buffer, size_t length) override;
+    size_t queueInput(const uint8_t* data, size_t length) override;
+    bool   assembleLine(char* line) override;
 
     void out(const std::string& s, const char* tag) override;
     void out_acked(const std::string& s, const char* tag) override;
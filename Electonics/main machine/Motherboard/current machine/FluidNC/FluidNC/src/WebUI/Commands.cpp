@@ -7,6 +7,7 @@
 
 #include "Authentication.h"  // MAX_LOCAL_PASSWORD_LENGTH
 #include "../Configuration/JsonGenerator.h"
+#include "../Settings.h"  // Setting::commitNVS()
 
 #include <esp_err.h>
 #include <cstring>
@@ -43,6 +44,7 @@ namespace WebUI {
     // cppcheck-suppress unusedFunction
     void COMMANDS::handle() {
         if (_restart_MCU) {
+            Setting::commitNVS();
             ESP.restart();
             while (1) {}
         }
@@ -17,7 +17,16 @@ namespace WebUI {
         count[level] = 0;
     }
 
+    JSONencoder::JSONencoder(Sink sink) : level(0), _str(&linebuf), _sink(std::move(sink)), category("nvs") {
+        count[level] = 0;
+        linebuf.reserve(chunkSize);
+    }
+
     void JSONencoder::flush() {
+        if (_sink && (*_str).length()) {
+            _sink((*_str).data(), (*_str).length());
+            (*_str).clear();
+        }
         if (_channel && (*_str).length()) {
             if (_encapsulate) {
                 // Output to channels is encapsulated in [MSG:JSON:...]
@@ -32,6 +41,8 @@ namespace WebUI {
         (*_str) += c;
         if (_channel && (*_str).length() >= 100) {
             flush();
+        } else if (_sink && (*_str).length() >= chunkSize) {
+            flush();
         }
     }
 
@@ -43,6 +54,21 @@ namespace WebUI {
         }
     }
 
+    void JSONencoder::replay(const std::string& rendered) {
+        for (auto const c : rendered) {
+            if (c != '\n') {
+                add(c);
+            } else if (!_channel) {
+                add(c);
+            } else if (!_encapsulate) {
+                // Where line() ended the line; the indent follows in rendered
+                log_stream(*_channel, *_str);
+                (*_str).clear();
+            }
+        }
+        flush();
+    }
+
     // Private function to add commas between
     // elements as needed, omitting the comma
     // before the first element in a list.
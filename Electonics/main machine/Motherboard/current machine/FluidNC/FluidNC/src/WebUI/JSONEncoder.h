@@ -2,6 +2,7 @@
 
 #include "../Channel.h"
 #include <string>
+#include <functional>
 
 // Class for creating JSON-encoded strings.
 
@@ -25,8 +26,16 @@ namespace WebUI {
 
         std::string linebuf;
 
+    public:
+        // Receives output in pieces of about chunkSize bytes
+        using Sink = std::function<void(const char* data, size_t length)>;
+
+    private:
+        static const size_t chunkSize = 512;
+
         std::string* _str     = nullptr;
         Channel*     _channel = nullptr;
+        Sink         _sink;
 
         std::string category;
 
@@ -36,6 +45,9 @@ namespace WebUI {
         // Constructor; set _encapsulate true for [MSG:JSON: ,,,] encapsulation
         JSONencoder(bool encapsulate, Channel* channel);
         explicit JSONencoder(std::string* str);
+        // Streams the output to sink as it is generated, so that the whole
+        // document never has to be held in memory
+        explicit JSONencoder(Sink sink);
 
         // begin() starts the encoding process.
         void begin();
@@ -74,6 +86,10 @@ namespace WebUI {
 
         void verbatim(const std::string& s);
 
+        // Sends text that a string encoder rendered earlier, line for line
+        // as this encoder would have sent it, so that output can be cached
+        void replay(const std::string& rendered);
+
         // The begin_webui() methods are specific to Esp3D_WebUI
         // WebUI sends JSON objects to the UI to generate configuration
         // page entries. Each object describes a named setting with a
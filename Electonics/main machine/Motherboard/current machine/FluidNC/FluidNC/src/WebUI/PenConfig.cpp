@@ -36,8 +36,8 @@ namespace WebUI {
         try {
             {  // Automatic file closure.
                 FileStream  file(configPath, "w");
-                std::string jsonStr = toJSON();
-                file.write(reinterpret_cast<const uint8_t*>(jsonStr.c_str()), jsonStr.length());
+                JSONencoder j([&file](const char* data, size_t length) { file.write(reinterpret_cast<const uint8_t*>(data), length); });
+                toJSON(j);
             }
             return true;
         } catch (const Error err) {
@@ -50,6 +50,12 @@ namespace WebUI {
     std::string PenConfig::toJSON() {
         std::string output;
         JSONencoder j(&output);
+        toJSON(j);
+        return output;
+    }
+
+    // Write the pen configuration to an encoder, which may stream it.
+    void PenConfig::toJSON(JSONencoder& j) {
         j.begin();
         j.begin_array("pens");
         for (const auto& pen : pens) {
@@ -71,7 +77,6 @@ namespace WebUI {
         }
         j.end_array();
         j.end();
-        return output;
     }
 
     // Parse the provided JSON string to update the pen list.
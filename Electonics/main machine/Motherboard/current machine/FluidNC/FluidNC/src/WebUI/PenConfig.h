@@ -47,6 +47,7 @@ namespace WebUI {
 
         // JSON conversion
         std::string toJSON();                              // Convert configurations to JSON
+        void        toJSON(JSONencoder& j);                // ... writing them to an encoder
         bool        fromJSON(const std::string& jsonStr);  // Parse configurations from JSON
 
     private:
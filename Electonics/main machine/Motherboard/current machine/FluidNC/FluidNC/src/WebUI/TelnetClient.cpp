@@ -68,8 +68,18 @@ namespace WebUI {
         return _wifiClient->available();
     }
 
-    int TelnetClient::rx_buffer_available() {
-        return WIFI_CLIENT_READ_BUFFER_SIZE - available();
+    int TelnetClient::rx_device_pending() {
+        return available();
+    }
+
+    void TelnetClient::noData() {
+        // calling _wifiClient->connected() is expensive when the client is
+        // connected because it calls recv() to double check, so we check
+        // infrequently, only after quite a few reads have returned no data
+        if (++_state >= DISCONNECT_CHECK_COUNTS) {
+            _state = 0;
+            closeOnDisconnect();  // sets _state to -1 if disconnected
+        }
     }
 
     int TelnetClient::read(void) {
@@ -78,13 +88,7 @@ namespace WebUI {
         }
         auto ret = _wifiClient->read();
         if (ret < 0) {
-            // calling _wifiClient->connected() is expensive when the client is
-            // connected because it calls recv() to double check, so we check
-            // infrequently, only after quite a few reads have returned no data
-            if (++_state >= DISCONNECT_CHECK_COUNTS) {
-                _state = 0;
-                closeOnDisconnect();  // sets _state to -1 if disconnected
-            }
+            noData();
         } else {
             // Reset the counter if we have data
             _state = 0;
@@ -92,6 +96,24 @@ namespace WebUI {
         return ret;
     }
 
+    size_t TelnetClient::rxBytes(uint8_t* buffer, size_t length) {
+        if (_state == -1) {
+            return 0;
+        }
+        int avail = _wifiClient->available();
+        if (avail <= 0) {
+            noData();
+            return 0;
+        }
+        int ret = _wifiClient->read(buffer, std::min(length, size_t(avail)));
+        if (ret <= 0) {
+            noData();
+            return 0;
+        }
+        _state = 0;
+        return ret;
+    }
+
     TelnetClient::~TelnetClient() {
         delete _wifiClient;
     }
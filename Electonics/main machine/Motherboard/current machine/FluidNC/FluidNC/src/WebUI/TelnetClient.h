@@ -13,25 +13,20 @@ namespace WebUI {
     class TelnetClient : public Channel {
         WiFiClient* _wifiClient;
 
-        // The default value of the rx buffer in WiFiClient.cpp is 1436 which is
-        // related to the network frame size minus TCP/IP header sizes.
-        // The WiFiClient API has no way to override or query it.
-        // We use a smaller value for safety.  There is little advantage
-        // to sending too many GCode lines at once, especially since the
-        // common serial communication case is typically limited to 128 bytes.
-        static const int WIFI_CLIENT_READ_BUFFER_SIZE = 1200;
-
         static const int DISCONNECT_CHECK_COUNTS = 1000;
 
         int _state = 0;
 
+        void noData();
+
     public:
         TelnetClient(WiFiClient* wifiClient);
 
-        int    rx_buffer_available() override;
+        int    rx_device_pending() override;
         size_t write(uint8_t data) override;
         size_t write(const uint8_t* buffer, size_t size) override;
         int    read(void) override;
+        size_t rxBytes(uint8_t* buffer, size_t length) override;
         int    peek(void) override;
         int    available() override;
         void   flush() override {}
@@ -37,8 +37,8 @@ namespace WebUI {
         try {
             {  // Scope for automatic file closure
                 FileStream  file(configPath, "w");
-                std::string jsonStr = toJSON();
-                file.write(reinterpret_cast<const uint8_t*>(jsonStr.c_str()), jsonStr.length());
+                JSONencoder j([&file](const char* data, size_t length) { file.write(reinterpret_cast<const uint8_t*>(data), length); });
+                toJSON(j);
             }  // File closed automatically here
             return true;
         } catch (const Error err) {
@@ -91,7 +91,11 @@ namespace WebUI {
     std::string ToolConfig::toJSON() {
         std::string output;
         JSONencoder j(&output);  // Add WebUI namespace
+        toJSON(j);
+        return output;
+    }
 
+    void ToolConfig::toJSON(JSONencoder& j) {
         j.begin();
         j.begin_array("tools");
 
@@ -107,7 +111,6 @@ namespace WebUI {
 
         j.end_array();
         j.end();
-        return output;
     }
 
     bool ToolConfig::fromJSON(const std::string& jsonStr) {
@@ -45,6 +45,7 @@ namespace WebUI {
         Tool*             getTool(int number);
         void              sortByNumber();
         std::string       toJSON();
+        void              toJSON(JSONencoder& j);
         bool              fromJSON(const std::string& jsonStr);
 
         bool getToolPosition(int toolNumber, float* position);
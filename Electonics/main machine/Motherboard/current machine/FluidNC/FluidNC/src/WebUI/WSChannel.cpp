@@ -91,6 +91,16 @@ namespace WebUI {
         return true;
     }
 
+    bool WSChannel::pushInput(const uint8_t* data, size_t length) {
+        if (push(data, length)) {
+            return true;
+        }
+        log_debug("WebSocket " << int(_clientNum) << " input buffer full; refused " << length << " bytes");
+        std::string s("{\"error\":\"input_full\",\"message\":\"Input buffer full. Send the message again after the next ok.\"}");
+        sendTXT(s);
+        return false;
+    }
+
     void WSChannel::autoReport() {
         if (!_active) {
             return;
@@ -158,7 +168,7 @@ namespace WebUI {
         }
     }
 
-    bool WSChannels::runGCode(int pageid, std::string_view cmd) {
+    WSChannels::RunResult WSChannels::runGCode(int pageid, std::string_view cmd) {
         WSChannel* wsChannel = getWSChannel(pageid);
         if (wsChannel) {
             if (cmd.length()) {
@@ -167,15 +177,20 @@ namespace WebUI {
                         wsChannel->handleRealtimeCharacter((uint8_t)c);
                     }
                 } else {
-                    wsChannel->push(cmd);
-                    if (cmd.back() != '\n') {
-                        wsChannel->push('\n');
+                    // Queue the line and its ending together so a full
+                    // buffer cannot split them
+                    std::string line(cmd);
+                    if (line.back() != '\n') {
+                        line += '\n';
+                    }
+                    if (!wsChannel->push(line)) {
+                        return RunResult::Full;
                     }
                 }
             }
-            return false;
+            return RunResult::Ok;
         }
-        return true;  // Error - no websocket
+        return RunResult::NoChannel;
     }
 
     bool WSChannels::sendError(int pageid, std::string err) {
@@ -273,7 +288,7 @@ namespace WebUI {
                             // channel->updateLastPong();
                         }
                     } else {
-                        _wsChannels.at(num)->push(payload, length);
+                        _wsChannels.at(num)->pushInput(payload, length);
                     }
                 } catch (std::out_of_range& oor) {}
                 break;
@@ -380,7 +395,7 @@ namespace WebUI {
                         std::string response("PING:60000:60000");
                         _wsChannels.at(num)->sendTXT(response);
                     } else {
-                        _wsChannels.at(num)->push(payload, length);
+                        _wsChannels.at(num)->pushInput(payload, length);
                     }
                 } catch (std::out_of_range& oor) {}
                 break;
@@ -395,7 +410,7 @@ namespace WebUI {
                 break;
             case WStype_BIN:
                 try {
-                    _wsChannels.at(num)->push(payload, length);
+                    _wsChannels.at(num)->pushInput(payload, length);
                 } catch (std::out_of_range& oor) {}
                 break;
             default:
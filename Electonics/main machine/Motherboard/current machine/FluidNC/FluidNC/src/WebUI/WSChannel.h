@@ -38,6 +38,11 @@ namespace WebUI {
 
         bool sendTXT(std::string& s);
 
+        // Queues a message from the client.  One that does not fit in the
+        // input buffer is refused whole, and the client is told to send it
+        // again once earlier lines have been acknowledged.
+        bool pushInput(const uint8_t* data, size_t length);
+
         inline size_t write(const char* s) { return write((uint8_t*)s, ::strlen(s)); }
         inline size_t write(unsigned long n) { return write((uint8_t)n); }
         inline size_t write(long n) { return write((uint8_t)n); }
@@ -48,8 +53,6 @@ namespace WebUI {
 
         int id() { return _clientNum; }
 
-        int rx_buffer_available() override { return std::max(0, 256 - int(_queue.size())); }
-
         operator bool() const;
 
         ~WSChannel();
@@ -102,7 +105,12 @@ namespace WebUI {
         static void removeChannel(WSChannel* channel);
         static void removeChannel(uint8_t num);
 
-        static bool runGCode(int pageid, std::string_view cmd);
+        enum class RunResult {
+            Ok,
+            NoChannel,  // The page has no websocket
+            Full,       // The websocket's input buffer has no room for the line
+        };
+        static RunResult runGCode(int pageid, std::string_view cmd);
         static bool sendError(int pageid, std::string error);
         static void sendPing();
         static void handleEvent(WebSocketsServer* server, uint8_t num, uint8_t type, uint8_t* payload, size_t length);
@@ -37,7 +37,10 @@
 #    include "src/WebUI/JSONEncoder.h"
 
 #    include "src/HashFS.h"
+#    include "src/DirIndex.h"
 #    include <list>
+#    include <algorithm>  // std::push_heap() etc.
+#    include <strings.h>  // strcasecmp()
 
 #    include "PenConfig.h"
 #    include "ToolConfig.h"
@@ -1098,8 +1101,19 @@ namespace WebUI {
             return;
         }
 
-        bool hasError = WSChannels::runGCode(pageid, cmd);
-        _webserver->send(hasError ? 500 : 200, "text/plain", hasError ? "WebSocket dead" : "");
+        switch (WSChannels::runGCode(pageid, cmd)) {
+            case WSChannels::RunResult::Ok:
+                _webserver->send(200, "text/plain", "");
+                break;
+            case WSChannels::RunResult::NoChannel:
+                _webserver->send(500, "text/plain", "WebSocket dead");
+                break;
+            case WSChannels::RunResult::Full:
+                // Too much input is waiting; the client should retry
+                _webserver->sendHeader("Retry-After", "1");
+                _webserver->send(503, "text/plain", "Input buffer full");
+                break;
+        }
     }
     void Web_Server::_handle_web_command(bool silent) {
         _webserver->sendHeader("Access-Control-Allow-Origin", "*");
@@ -1616,6 +1630,17 @@ namespace WebUI {
         _webserver->send(200, "application/json", s);
     }
 
+    // Sends the JSON that generate() writes as a chunked response, a piece
+    // at a time, so large listings need no more memory than small ones
+    void Web_Server::sendJSON(int code, const std::function<void(JSONencoder&)>& generate) {
+        _webserver->sendHeader("Cache-Control", "no-cache");
+        _webserver->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        _webserver->send(code, "application/json", "");
+        JSONencoder j([](const char* data, size_t length) { _webserver->sendContent(data, length); });
+        generate(j);
+        _webserver->sendContent("");  // Ends the chunked response
+    }
+
     void Web_Server::sendAuth(const char* status, const char* level, const char* user) {
         std::string s;
         JSONencoder j(&s);
@@ -1766,6 +1791,58 @@ namespace WebUI {
         }
     }
 
+    static void listEntry(JSONencoder& j, const DirIndex::Entry& entry) {
+        char      datetime[20] = "";
+        struct tm tm;
+        if (entry.mtime && gmtime_r(&entry.mtime, &tm)) {
+            strftime(datetime, sizeof(datetime), "%Y-%m-%d %H:%M:%S", &tm);
+        }
+        j.begin_object();
+        j.member("name", entry.name);
+        j.member("shortname", entry.name);
+        j.member("size", entry.size);
+        j.member("datetime", datetime);
+        j.end_object();
+    }
+
+    // Lists the entries that fall in [offset, offset+limit) of the sorted
+    // directory.  Only that many entries are held, in a heap whose top is
+    // the one that would be dropped next, so a page near the start of a
+    // large directory costs little memory.
+    static void listSorted(JSONencoder&       j,
+                           const stdfs::path& dir,
+                           bool               bySize,
+                           bool               descending,
+                           size_t             offset,
+                           size_t             limit,
+                           size_t&            count,
+                           std::error_code&   ec) {
+        auto before = [bySize, descending](const DirIndex::Entry& a, const DirIndex::Entry& b) {
+            int order = bySize && a.size != b.size ? (a.size < b.size ? -1 : 1) : strcasecmp(a.name.c_str(), b.name.c_str());
+            return descending ? order > 0 : order < 0;
+        };
+        size_t                       keep = offset + limit;
+        std::vector<DirIndex::Entry> heap;
+        DirIndex::list(
+            dir,
+            [&](const DirIndex::Entry& entry) {
+                ++count;
+                if (heap.size() < keep) {
+                    heap.push_back(entry);
+                    std::push_heap(heap.begin(), heap.end(), before);
+                } else if (before(entry, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), before);
+                    heap.back() = entry;
+                    std::push_heap(heap.begin(), heap.end(), before);
+                }
+            },
+            ec);
+        std::sort_heap(heap.begin(), heap.end(), before);
+        for (size_t i = offset; i < heap.size(); ++i) {
+            listEntry(j, heap[i]);
+        }
+    }
+
     void Web_Server::handleFileOps(const char* fs) {
         //this is only for admin and user
         if (is_authenticated() == AuthenticationLevel::LEVEL_GUEST) {
@@ -1813,6 +1890,7 @@ namespace WebUI {
                 if (stdfs::remove(fpath / filename, ec)) {
                     sstatus = filename + " deleted";
                     HashFS::delete_file(fpath / filename);
+                    DirIndex::update(fpath / filename);
                 } else {
                     sstatus = "Cannot delete ";
                     sstatus += filename + " " + ec.message();
@@ -1824,6 +1902,7 @@ namespace WebUI {
                 if (count > 0) {
                     sstatus = filename + " deleted";
                     HashFS::report_change();
+                    DirIndex::update(dirpath);
                 } else {
                     // log_debug("remove_all returned " << count);
                     sstatus = "Cannot delete ";
@@ -1833,6 +1912,7 @@ namespace WebUI {
                 if (stdfs::create_directory(fpath / filename, ec)) {
                     sstatus = filename + " created";
                     HashFS::report_change();
+                    DirIndex::update(fpath / filename);
                 } else {
                     sstatus = "Cannot create ";
                     sstatus += filename + " " + ec.message();
@@ -1849,6 +1929,7 @@ namespace WebUI {
                     } else {
                         sstatus = filename + " renamed to " + newname;
                         HashFS::rename_file(fpath / filename, fpath / newname);
+                        DirIndex::rename(fpath / filename, fpath / newname);
                     }
                 }
             }
@@ -1859,40 +1940,56 @@ namespace WebUI {
             list_files = false;
         }
 
-        std::string        s;
-        WebUI::JSONencoder j(&s);
-        j.begin();
+        // Listings can be paged with offset= and limit=, and ordered with
+        // sort=name or sort=size and order=desc.  Unsorted entries are sent
+        // in directory order as they are read.
+        size_t offset = _webserver->hasArg("offset") ? std::max(_webserver->arg("offset").toInt(), 0L) : 0;
+        size_t limit  = _webserver->hasArg("limit") ? std::max(_webserver->arg("limit").toInt(), 0L) : 0;
+        if (limit == 0 || limit > SIZE_MAX - offset) {
+            limit = SIZE_MAX - offset;
+        }
+        std::string sort(_webserver->hasArg("sort") ? _webserver->arg("sort").c_str() : "");
+        bool        descending = _webserver->hasArg("order") && _webserver->arg("order") == "desc";
 
-        if (list_files) {
-            auto iter = stdfs::directory_iterator { fpath, ec };
-            if (!ec) {
+        sendJSON(200, [&](JSONencoder& j) {
+            j.begin();
+
+            if (list_files) {
+                size_t count = 0;
                 j.begin_array("files");
-                for (auto const& dir_entry : iter) {
-                    j.begin_object();
-                    j.member("name", dir_entry.path().filename());
-                    j.member("shortname", dir_entry.path().filename());
-                    j.member("size", dir_entry.is_directory() ? -1 : dir_entry.file_size());
-                    j.member("datetime", "");
-                    j.end_object();
+                if (sort == "name" || sort == "size") {
+                    listSorted(j, fpath, sort == "size", descending, offset, limit, count, ec);
+                } else {
+                    DirIndex::list(
+                        fpath,
+                        [&](const DirIndex::Entry& entry) {
+                            if (count >= offset && count - offset < limit) {
+                                listEntry(j, entry);
+                            }
+                            ++count;
+                        },
+                        ec);
                 }
                 j.end_array();
+                if (!ec) {
+                    j.member("count", count);
+                }
             }
-        }
 
-        auto space = stdfs::space(fpath, ec);
-        totalspace = space.capacity;
-        usedspace  = totalspace - space.available;
+            auto space = stdfs::space(fpath, ec);
+            totalspace = space.capacity;
+            usedspace  = totalspace - space.available;
 
-        j.member("path", path.c_str());
-        j.member("total", formatBytes(totalspace));
-        j.member("used", formatBytes(usedspace + 1));
+            j.member("path", path.c_str());
+            j.member("total", formatBytes(totalspace));
+            j.member("used", formatBytes(usedspace + 1));
 
-        uint32_t percent = totalspace ? (usedspace * 100) / totalspace : 100;
+            uint32_t percent = totalspace ? (usedspace * 100) / totalspace : 100;
 
-        j.member("occupation", percent);
-        j.member("status", sstatus);
-        j.end();
-        sendJSON(200, s);
+            j.member("occupation", percent);
+            j.member("status", sstatus);
+            j.end();
+        });
     }
 
     void Web_Server::handle_direct_SDFileList() {
@@ -2021,6 +2118,7 @@ namespace WebUI {
                 _uploadFile = nullptr;
                 stdfs::remove(filepath, error_code);
                 HashFS::rehash_file(filepath);
+                DirIndex::update(filepath);
             }
         }
     }
@@ -2246,7 +2344,7 @@ namespace WebUI {
 
         PenConfig& config = PenConfig::getInstance();
         config.loadConfig();
-        _webserver->send(200, "application/json", config.toJSON().c_str());
+        sendJSON(200, [&config](JSONencoder& j) { config.toJSON(j); });
     }
 
     void Web_Server::handleSetPenConfig() {
@@ -2313,7 +2411,7 @@ namespace WebUI {
 
         ToolConfig& config = ToolConfig::getInstance();
         config.loadConfig();  // Load latest config from file
-        _webserver->send(200, "application/json", config.toJSON().c_str());
+        sendJSON(200, [&config](JSONencoder& j) { config.toJSON(j); });
     }
 
     // POST /toolconfig
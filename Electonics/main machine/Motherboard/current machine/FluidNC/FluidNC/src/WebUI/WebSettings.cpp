@@ -22,11 +22,14 @@
 #include "WifiConfig.h"
 
 #include "src/HashFS.h"
+#include "src/DirIndex.h"
 
 #include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <charconv>
+#include <memory>
+#include <mutex>
 
 namespace WebUI {
 
@@ -329,8 +332,7 @@ namespace WebUI {
     }
 
     // Used by js/setting.js
-    static Error listSettingsJSON(const char* parameter, AuthenticationLevel auth_level, Channel& out) {  // ESP400
-        JSONencoder j(false, &out);
+    static void renderSettingsJSON(JSONencoder& j) {
         j.begin();
         j.member("cmd", "400");
         j.member("status", "ok");
@@ -349,19 +351,9 @@ namespace WebUI {
 
         j.end_array();
         j.end();
-
-        return Error::Ok;
     }
 
-    static Error listSettings(const char* parameter, AuthenticationLevel auth_level, Channel& out) {  // ESP400
-        if (parameter != NULL) {
-            if (strstr(parameter, "json=yes") != NULL) {
-                return listSettingsJSON(parameter, auth_level, out);
-            }
-        }
-
-        JSONencoder j(false, &out);
-
+    static void renderSettings(JSONencoder& j) {
         j.begin();
         j.begin_array("EEPROM");
 
@@ -378,6 +370,45 @@ namespace WebUI {
 
         j.end_array();
         j.end();
+    }
+
+    static Error listSettings(const char* parameter, AuthenticationLevel auth_level, Channel& out) {  // ESP400
+        bool json = parameter != NULL && strstr(parameter, "json=yes") != NULL;
+
+        // WebUI clients poll this, so the listing is rendered once per
+        // change to the settings and sent from RAM until the next one.
+        // ESP400 also runs on the protocol task, so each rendering is a
+        // snapshot that is never changed once published, and only the
+        // pointers are locked.
+        struct Rendered {
+            uint32_t    generation;
+            std::string text;
+        };
+        static std::shared_ptr<const Rendered> cache[2];  // Plain, JSON
+        static std::mutex                      cacheMutex;
+
+        std::shared_ptr<const Rendered> rendered;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            rendered = cache[json];
+        }
+        uint32_t generation = Setting::generation();
+        if (!rendered || rendered->generation != generation) {
+            auto fresh        = std::make_shared<Rendered>();
+            fresh->generation = generation;
+            JSONencoder r(&fresh->text);
+            if (json) {
+                renderSettingsJSON(r);
+            } else {
+                renderSettings(r);
+            }
+            rendered = fresh;
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            cache[json] = rendered;
+        }
+
+        JSONencoder j(false, &out);
+        j.replay(rendered->text);
 
         return Error::Ok;
     }
@@ -666,6 +697,7 @@ namespace WebUI {
                 stdfs::remove(fpath);
             }
             HashFS::delete_file(fpath);
+            DirIndex::update(fpath);
         } catch (std::filesystem::filesystem_error const& ex) {
             log_error_to(out, ex.what());
             return Error::FsFailedDelFile;
@@ -839,6 +871,7 @@ namespace WebUI {
             FluidPath outPath { opath, fs };
             std::filesystem::rename(inPath, outPath);
             HashFS::rename_file(inPath, outPath, true);
+            DirIndex::rename(inPath, outPath);
         } catch (std::filesystem::filesystem_error const& ex) {
             log_error_to(out, ex.what());
             return Error::FsFailedRenameFile;
@@ -883,6 +916,7 @@ namespace WebUI {
 
             if (outDir.hasTail()) {
                 stdfs::create_directory(outDir, ec);
+                DirIndex::update(outDir);
                 if (ec) {
                     log_error_to(out, "Cannot create " << oDir);
                     return Error::FsFailedOpenDir;
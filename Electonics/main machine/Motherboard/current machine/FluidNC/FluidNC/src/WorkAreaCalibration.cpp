@@ -8,7 +8,7 @@
 #include "Machine/MachineConfig.h"
 #include "FluidError.hpp"
 #include "FileStream.h"
-#include "SettingsDefinitions.h" // config_filename
+#include "Limits.h"  // limitsMinPosition(), limitsMaxPosition()
 #include "WebUI/Commands.h"
 #include "GCode.h"  // gc_sync_position
 
@@ -193,7 +193,7 @@ namespace {
         pass1x = PassData{}; pass1y = PassData{}; pass2x = PassData{}; pass2y = PassData{};
     }
 
-    void commitConfigAndRestart() {
+    void commitWorkArea() {
         auto axX = config->_axes->_axis[X_AXIS];
         auto axY = config->_axes->_axis[Y_AXIS];
 
@@ -282,7 +282,7 @@ namespace {
         AxisResult xr = computeAxis(pass1x, pass2x, axX);
         AxisResult yr = computeAxis(pass1y, pass2y, axY);
 
-        // Report measured inputs and both raw/rounded results per axis before writing & restart
+        // Report measured inputs and both raw/rounded results per axis before applying them
         log_info("WorkAreaCalibration: X inputs: L=" << xr.L
                  << ", starts=[" << xr.start1 << ", " << xr.start2 << "]"
                  << ", pulloff=" << xr.pulloff
@@ -303,179 +303,21 @@ namespace {
                  << "] Y[min,max,origin]="
                  << "[" << yr.min << ", " << yr.max << ", " << yr.origin << "]");
 
-        // Write YAML atomically: read current config, replace or insert work_area fields
-        std::string cfgPath = config_filename->get();
-        if (cfgPath.empty()) {
-            log_error("No config filename set; cannot persist work_area");
-            return;
-        }
-        // Read YAML
-        FileStream inFile(cfgPath.c_str(), "r", "");
-        if (!inFile) {
-            log_error("Failed opening config for read: " << cfgPath);
-            return;
-        }
-        size_t size = inFile.size();
-        std::string yaml(size, '\0');
-        inFile.read(yaml.data(), size);
-        // Ensure work_area section exists and keys use colon-form format
-        auto ensureWorkArea = [&]() {
-            size_t wa = yaml.find("work_area:");
-            if (wa == std::string::npos) {
-                // Append a well-formed work_area block
-                std::string block;
-                block += "\nwork_area:\n";
-                block += "  enabled: true\n";
-                block += "  move_to_origin: true\n";
-                yaml += block;
-                wa = yaml.find("work_area:");
-            }
-            return wa;
-        };
-        size_t waPos = ensureWorkArea();
-
-        // Remove any duplicate work_area blocks beyond the first to avoid ambiguity
-        auto eraseBlockAt = [&](size_t startPos) {
-            // find end of line
-            size_t waLineEnd2 = yaml.find('\n', startPos);
-            if (waLineEnd2 == std::string::npos) waLineEnd2 = yaml.size();
-            size_t blkStart2 = waLineEnd2 + 1;
-            size_t blkEnd2   = blkStart2;
-            while (blkEnd2 < yaml.size()) {
-                size_t ls = blkEnd2;
-                size_t nl = yaml.find('\n', ls);
-                size_t le = (nl == std::string::npos) ? yaml.size() : nl + 1;
-                size_t i  = ls;
-                while (i < le && (yaml[i] == ' ' || yaml[i] == '\t')) i++;
-                if (i == ls || ls >= yaml.size()) break; // new top-level or EOF
-                blkEnd2 = le;
-                if (nl == std::string::npos) break;
-            }
-            yaml.erase(startPos, blkEnd2 - startPos);
-        };
-
-        // Look for additional "work_area:" occurrences after the first and remove them
-        size_t searchPos = waPos + 1;
-        while (true) {
-            size_t dup = yaml.find("work_area:", searchPos);
-            if (dup == std::string::npos) break;
-            eraseBlockAt(dup);
-            searchPos = dup; // continue searching from here in case of adjacent blocks
-        }
-
-        // Determine the work_area block range [blockStart, blockEnd)
-        size_t waLineStart = yaml.rfind('\n', waPos);
-        if (waLineStart == std::string::npos) waLineStart = 0; else waLineStart += 1;
-        size_t waLineEnd = yaml.find('\n', waPos);
-        if (waLineEnd == std::string::npos) waLineEnd = yaml.size();
-        size_t blockStart = waLineEnd + 1; // first line after 'work_area:'
-        // block ends at next line that starts at column 0 (non-space) or end of file
-        size_t blockEnd = blockStart;
-        while (blockEnd < yaml.size()) {
-            size_t lineStart = blockEnd;
-            size_t nl        = yaml.find('\n', lineStart);
-            size_t lineEnd   = (nl == std::string::npos) ? yaml.size() : nl + 1;
-            // count leading spaces
-            size_t i = lineStart;
-            while (i < lineEnd && (yaml[i] == ' ' || yaml[i] == '\t')) i++;
-            if (i == lineStart || lineStart >= yaml.size()) {
-                // starts at column 0 => new top-level block
-                break;
-            }
-            blockEnd = lineEnd;
-            if (nl == std::string::npos) break;
-        }
-        // Helper to find existing indent within the block
-        auto detectIndent = [&]() -> std::string {
-            size_t p = blockStart;
-            while (p < blockEnd) {
-                size_t ls = p;
-                size_t nl = yaml.find('\n', ls);
-                size_t le = (nl == std::string::npos) ? yaml.size() : nl + 1;
-                size_t i  = ls;
-                while (i < le && (yaml[i] == ' ' || yaml[i] == '\t')) i++;
-                if (i > ls) {
-                    return yaml.substr(ls, i - ls);
-                }
-                p = le;
-                if (nl == std::string::npos) break;
-            }
-            return std::string("  ");
-        };
-        const std::string indent = detectIndent();
-
-        auto replaceKeyInBlock = [&](const char* key, float val) {
-            // Search line by line for ^\s*key:
-            size_t p = blockStart;
-            while (p < blockEnd) {
-                size_t ls = p;
-                size_t nl = yaml.find('\n', ls);
-                size_t le = (nl == std::string::npos) ? yaml.size() : nl + 1;
-                // compute leading whitespace
-                size_t i = ls;
-                while (i < le && (yaml[i] == ' ' || yaml[i] == '\t')) i++;
-                // match key
-                const size_t keyLen = ::strlen(key);
-                if (i + keyLen + 1 <= le && yaml.compare(i, keyLen, key) == 0 && (i + keyLen < le) && yaml[i + keyLen] == ':') {
-                    // replace entire line
-                    char line[96];
-                    snprintf(line, sizeof(line), "%s%s: %.1f\n", indent.c_str(), key, val);
-                    yaml.replace(ls, le - ls, line);
-                    // adjust blockEnd due to size change
-                    size_t delta = ::strlen(line) - (le - ls);
-                    blockEnd += delta;
-                    return;
-                }
-                p = le;
-                if (nl == std::string::npos) break;
-            }
-            // Not found: insert at blockStart with detected indent
-            char line[96];
-            snprintf(line, sizeof(line), "%s%s: %.1f\n", indent.c_str(), key, val);
-            yaml.insert(blockStart, line);
-            blockEnd += ::strlen(line);
-        };
+        // Let queued motion finish so no planned move was checked against the old limits
+        protocol_buffer_synchronize();
+        config->_workArea->update(xr.min, xr.max, xr.origin, yr.min, yr.max, yr.origin);
 
-        replaceKeyInBlock("min_x", xr.min);
-        replaceKeyInBlock("max_x", xr.max);
-        replaceKeyInBlock("origin_x", xr.origin);
-        replaceKeyInBlock("min_y", yr.min);
-        replaceKeyInBlock("max_y", yr.max);
-        replaceKeyInBlock("origin_y", yr.origin);
-
-        // Update in-memory config
-        if (config->_workArea) {
-            config->_workArea->_minX = xr.min;
-            config->_workArea->_maxX = xr.max;
-            config->_workArea->_originX = xr.origin;
-            config->_workArea->_minY = yr.min;
-            config->_workArea->_maxY = yr.max;
-            config->_workArea->_originY = yr.origin;
-        }
+        // Keep parser and planner in sync with the machine position
+        gc_sync_position();
+        plan_sync_position();
 
-        // Write back in-place to the existing config.yaml
-        // Clean up any stale temp file from older firmware versions
-        {
-            std::string tmpPath = cfgPath + ".new";
-            std::remove(tmpPath.c_str());
-        }
-        {
-            FileStream outFile(cfgPath.c_str(), "w", "");
-            if (!outFile) {
-                log_error("Failed opening config for write: " << cfgPath);
-                return;
-            }
-            auto n = outFile.write((const uint8_t*)yaml.data(), yaml.size());
-            if (n != yaml.size()) {
-                log_error("Short write updating config.yaml: wrote " << n << " of " << yaml.size());
-                return;
+        float* mpos = get_mpos();
+        for (size_t axis = X_AXIS; axis <= Y_AXIS; axis++) {
+            if (mpos[axis] < limitsMinPosition(axis) || mpos[axis] > limitsMaxPosition(axis)) {
+                log_warn("WorkAreaCalibration: " << Axes::_names[axis] << " is outside the new work area");
             }
         }
-
-        log_info("WorkAreaCalibration: updated work_area in-place: " << cfgPath << "; restarting MCU");
-
-        // Request restart
-        WebUI::COMMANDS::restart_MCU();
+        log_info("WorkAreaCalibration: work_area applied and saved");
     }
 }
 
@@ -484,7 +326,7 @@ namespace WorkAreaCalibration {
         if (pass == 3) {
             // Commit command
             loadCalibrationState();
-            commitConfigAndRestart();
+            commitWorkArea();
             return;
         }
 
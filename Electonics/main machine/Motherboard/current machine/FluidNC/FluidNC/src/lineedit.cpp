@@ -414,13 +414,20 @@ void Lineedit::show_realtime_command(const char* s) {
 // public
 
 // cppcheck-suppress unusedFunction
-int Lineedit::finish() {
+int Lineedit::finish(bool remember) {
     int length = (int)(endaddr - startaddr);
-    add_to_history(startaddr, length);
+    if (remember) {
+        add_to_history(startaddr, length);
+    }
     restart();
     return (length);
 }
 
+// Adds a line that was collected elsewhere to the history
+void Lineedit::remember(const char* line) {
+    add_to_history(const_cast<char*>(line), strlen(line));
+}
+
 // Special handling for realtime characters.
 // In the middle of a SPECIAL_DELETE sequence, we treat ~ as part
 // of that sequence, instead of as a realtime character.
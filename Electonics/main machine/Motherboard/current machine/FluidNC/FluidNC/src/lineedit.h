@@ -85,7 +85,9 @@ public:
     Lineedit(Print* out, char* line, int linelen);
 
     void start(char* addr, int count);
-    int  finish();
+    int  finish(bool remember = true);
     bool step(int c);
     bool realtime(int c);
+    bool is_editing() { return editing; }
+    void remember(const char* line);
 };
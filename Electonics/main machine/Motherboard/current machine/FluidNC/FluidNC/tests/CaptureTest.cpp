@@ -0,0 +1,154 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "gtest/gtest.h"
+#include "../../X86TestSupport/TestSupport/Capture.h"
+#include "../../X86TestSupport/TestSupport/esp32-hal-gpio.h"
+
+#include <sstream>
+#include <string>
+
+// Capture is one store for the whole program, and IDs stay interned across
+// tests, so each test uses IDs of its own and resets the events.
+
+TEST(Capture, InternsIdsOnce) {
+    auto& capture = Capture::instance();
+    auto  a       = capture.intern("intern.a");
+    auto  b       = capture.intern("intern.b");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, capture.intern("intern.a"));
+    EXPECT_EQ("intern.b", capture.name(b));
+}
+
+TEST(Capture, StoresEventsWithData) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    capture.write("store.x", 5, 10);
+    capture.write("store.x", 6, 11, std::vector<uint32_t> { 1, 2, 3 });
+    capture.write("store.y", 7, 12);
+
+    ASSERT_EQ(3u, capture.size());
+    auto first = capture.event(0);
+    EXPECT_EQ(10u, first.time);
+    EXPECT_EQ(5u, first.value);
+    EXPECT_EQ(0u, first.size);
+
+    auto second = capture.event(1);
+    EXPECT_EQ(first.id, second.id);
+    ASSERT_EQ(3u, second.size);
+    EXPECT_EQ(1u, second.data[0]);
+    EXPECT_EQ(3u, second.data[2]);
+
+    auto third = capture.event(2);
+    EXPECT_EQ("store.y", capture.name(third.id));
+    EXPECT_EQ(0u, third.size);
+}
+
+TEST(Capture, ExportsCsv) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    capture.write("csv.plain", 1, 3);
+    capture.write("csv,quoted", 2, 4, std::vector<uint32_t> { 7, 8 });
+
+    std::ostringstream out;
+    capture.exportTo(out, Capture::Format::Csv);
+    EXPECT_EQ("time,id,value,data\n3,csv.plain,1,\n4,\"csv,quoted\",2,7 8\n", out.str());
+}
+
+TEST(Capture, ExportsVcd) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    auto pin = capture.intern("vcd.pin", 1);
+    auto bus = capture.intern("vcd.bus");
+    capture.write(pin, 1, 0);
+    capture.write(bus, 5, 0);
+    capture.write(pin, 0, 2);
+    capture.write(pin, 1, 2);
+
+    std::ostringstream out;
+    capture.exportTo(out, Capture::Format::Vcd);
+    auto text = out.str();
+
+    // The codes are what the IDs were interned as
+    std::string p = text.substr(text.find(" vcd.pin $end") - 1, 1);
+    std::string b = text.substr(text.find(" vcd.bus $end") - 1, 1);
+    EXPECT_NE(std::string::npos, text.find("$var wire 1 " + p + " vcd.pin $end\n"));
+    EXPECT_NE(std::string::npos, text.find("$var wire 32 " + b + " vcd.bus $end\n"));
+    EXPECT_NE(std::string::npos, text.find("$enddefinitions $end\n#0\n1" + p + "\nb101 " + b + "\n#2\n0" + p + "\n1" + p + "\n"));
+}
+
+TEST(Capture, StreamsInChunks) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    auto id = capture.intern("stream.step", 1);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        capture.write(id, i & 1, i);
+    }
+    std::ostringstream whole;
+    capture.exportTo(whole, Capture::Format::Csv);
+    capture.reset();
+
+    std::ostringstream streamed;
+    capture.streamTo(streamed, Capture::Format::Csv, 64);
+    size_t held = 0;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        capture.write(id, i & 1, i);
+        held = std::max(held, capture.size());
+    }
+    EXPECT_EQ(0u, capture.endStream());
+
+    EXPECT_LT(held, 64u);
+    EXPECT_EQ(0u, capture.size());
+    EXPECT_EQ(whole.str(), streamed.str());
+}
+
+TEST(Capture, StreamsBinary) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    std::ostringstream out;
+    capture.streamTo(out, Capture::Format::Binary, 1);
+    capture.write("binary.only", 0x01020304, 0x10, std::vector<uint32_t> { 9 });
+    capture.endStream();
+
+    auto text = out.str();
+    ASSERT_EQ(0u, text.find("FNCCAP1\n"));
+
+    // Every ID interned so far is named before the event, which is the last 21 bytes
+    auto name  = text.find("binary.only");
+    auto event = text.size() - 21;
+    ASSERT_NE(std::string::npos, name);
+    EXPECT_LT(name, event);
+    EXPECT_EQ(std::string("\x02\x10\0\0\0", 5), text.substr(event, 5));
+    EXPECT_EQ(std::string("\x04\x03\x02\x01\x01\0\0\0\x09\0\0\0", 12), text.substr(event + 9));
+}
+
+TEST(Capture, VcdLeavesOutLateIds) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    auto early = capture.intern("late.early", 1);
+
+    std::ostringstream out;
+    capture.streamTo(out, Capture::Format::Vcd, 1);
+    capture.write(early, 1, 0);
+    capture.write("late.late", 1, 1);
+    capture.write(early, 0, 2);
+    EXPECT_EQ(1u, capture.endStream());
+    EXPECT_EQ(std::string::npos, out.str().find("late.late"));
+}
+
+// Pin writes would fill memory on a long job, so they are only kept while streaming
+TEST(Capture, GpioOnlyWhileStreaming) {
+    auto& capture = Capture::instance();
+    capture.reset();
+    __digitalWrite(40, 1);
+    EXPECT_EQ(0u, capture.size());
+
+    std::ostringstream out;
+    capture.streamTo(out, Capture::Format::Csv, 16);
+    __digitalWrite(40, 0);
+    ASSERT_EQ(1u, capture.size());
+    EXPECT_EQ("gpio.40", capture.name(capture.event(0).id));
+    EXPECT_EQ(0u, capture.event(0).value);
+    capture.endStream();
+    EXPECT_NE(std::string::npos, out.str().find(",gpio.40,0,"));
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "gtest/gtest.h"
+#include "FlowControlStubs.h"
+
+#include "src/Expression.h"
+
+#include <string>
+
+// Evaluates text, which must be all expression
+static Error eval(const std::string& text, float& value) {
+    size_t pos    = 0;
+    Error  status = expression(text.c_str(), &pos, value);
+    if (status == Error::Ok) {
+        EXPECT_EQ(text.length(), pos) << text;
+    }
+    return status;
+}
+
+static float eval(const std::string& text) {
+    float value = 0.0f;
+    EXPECT_EQ(Error::Ok, eval(text, value)) << text;
+    return value;
+}
+
+static Error evalError(const std::string& text) {
+    float value;
+    return eval(text, value);
+}
+
+TEST(Expression, Precedence) {
+    EXPECT_FLOAT_EQ(14.0f, eval("[2+3*4]"));
+    EXPECT_FLOAT_EQ(10.0f, eval("[2*3+4]"));
+    EXPECT_FLOAT_EQ(50.0f, eval("[2+3*4**2]"));
+    EXPECT_FLOAT_EQ(20.0f, eval("[[2+3]*4]"));
+    EXPECT_FLOAT_EQ(1.0f, eval("[1+2LT4]"));
+    EXPECT_FLOAT_EQ(0.0f, eval("[1+4LT4]"));
+
+    // Logical operators bind loosest
+    EXPECT_FLOAT_EQ(1.0f, eval("[1LT2AND3GT2]"));
+    EXPECT_FLOAT_EQ(0.0f, eval("[1EQ1XOR2EQ2]"));
+}
+
+TEST(Expression, LeftAssociative) {
+    EXPECT_FLOAT_EQ(3.0f, eval("[10-4-3]"));
+    EXPECT_FLOAT_EQ(2.0f, eval("[16/4/2]"));
+    EXPECT_FLOAT_EQ(64.0f, eval("[2**3**2]"));
+}
+
+TEST(Expression, Operators) {
+    EXPECT_FLOAT_EQ(-5.0f, eval("[-[2+3]]"));
+    EXPECT_FLOAT_EQ(4.0f, eval("[-2**2]"));
+    EXPECT_FLOAT_EQ(2.0f, eval("[-7MOD3]"));
+    EXPECT_FLOAT_EQ(1.0f, eval("[1XOR0]"));
+    EXPECT_FLOAT_EQ(0.0f, eval("[1XOR1]"));
+    EXPECT_FLOAT_EQ(1.0f, eval("[2NE3]"));
+    EXPECT_FLOAT_EQ(1.0f, eval("[3GE3]"));
+    EXPECT_FLOAT_EQ(0.0f, eval("[3LE2]"));
+}
+
+TEST(Expression, Functions) {
+    EXPECT_FLOAT_EQ(4.0f, eval("[SQRT[16]]"));
+    EXPECT_FLOAT_EQ(3.0f, eval("[ABS[-3]]"));
+    EXPECT_FLOAT_EQ(45.0f, eval("[ATAN[1]/[1]]"));
+    EXPECT_FLOAT_EQ(-3.0f, eval("[FIX[-2.5]]"));
+    EXPECT_FLOAT_EQ(3.0f, eval("[FUP[2.1]]"));
+    EXPECT_FLOAT_EQ(3.0f, eval("[ROUND[2.5]]"));
+    EXPECT_FLOAT_EQ(9.0f, eval("[1+SQRT[4]**3]"));
+}
+
+TEST(Expression, Parameters) {
+    TestParams::reset();
+    TestParams::setNumbered(1, 3.0f);
+    TestParams::setNumbered(2, 1.0f);
+    TestParams::setNumbered(5000, 2.5f);
+    EXPECT_FLOAT_EQ(6.0f, eval("[#1*2]"));
+    EXPECT_FLOAT_EQ(3.0f, eval("[##2]"));
+    EXPECT_FLOAT_EQ(3.0f, eval("[#[#2]]"));
+    EXPECT_FLOAT_EQ(2.5f, eval("[#5000]"));
+
+    set_named_param("width", 4.0f);
+    EXPECT_FLOAT_EQ(8.0f, eval("[#<width>*2]"));
+    EXPECT_FLOAT_EQ(1.0f, eval("[EXISTS[#<width>]]"));
+    EXPECT_FLOAT_EQ(0.0f, eval("[EXISTS[#<height>]]"));
+
+    // A parameter with no value cannot be used
+    EXPECT_EQ(Error::BadNumberFormat, evalError("[#5001]"));
+}
+
+// Expressions are compiled once, but their parameters are read each time
+TEST(Expression, CompiledFormReadsParametersAgain) {
+    TestParams::reset();
+    TestParams::setNumbered(1, 1.0f);
+    EXPECT_FLOAT_EQ(11.0f, eval("[#1+10]"));
+    TestParams::setNumbered(1, 2.0f);
+    EXPECT_FLOAT_EQ(12.0f, eval("[#1+10]"));
+
+    Expression expr;
+    size_t     pos = 0;
+    ASSERT_EQ(Error::Ok, expr.compile("[#1*#1]", &pos));
+    float value;
+    ASSERT_EQ(Error::Ok, expr.evaluate(value));
+    EXPECT_FLOAT_EQ(4.0f, value);
+    TestParams::setNumbered(1, 3.0f);
+    ASSERT_EQ(Error::Ok, expr.evaluate(value));
+    EXPECT_FLOAT_EQ(9.0f, value);
+}
+
+TEST(Expression, StopsAfterTheBracket) {
+    std::string line = "[1+2]X5";
+    size_t      pos  = 0;
+    float       value;
+    ASSERT_EQ(Error::Ok, expression(line.c_str(), &pos, value));
+    EXPECT_FLOAT_EQ(3.0f, value);
+    EXPECT_EQ(5u, pos);
+}
+
+TEST(Expression, Errors) {
+    EXPECT_EQ(Error::ExpressionDivideByZero, evalError("[1/0]"));
+    EXPECT_EQ(Error::ExpressionArgumentOutOfRange, evalError("[SQRT[-1]]"));
+    EXPECT_EQ(Error::ExpressionArgumentOutOfRange, evalError("[ACOS[2]]"));
+    EXPECT_EQ(Error::ExpressionArgumentOutOfRange, evalError("[LN[0]]"));
+    EXPECT_EQ(Error::ExpressionInvalidArgument, evalError("[-2**0.5]"));
+    EXPECT_EQ(Error::ExpressionUnknownOp, evalError("[FOO[1]]"));
+    EXPECT_EQ(Error::ExpressionUnknownOp, evalError("[1Q2]"));
+    EXPECT_EQ(Error::ExpressionSyntaxError, evalError("[1+2"));
+    EXPECT_EQ(Error::ExpressionSyntaxError, evalError("[ATAN[1]]"));
+    EXPECT_EQ(Error::ExpressionSyntaxError, evalError("[SIN 1]"));
+    EXPECT_EQ(Error::BadNumberFormat, evalError("[1+]"));
+    EXPECT_EQ(Error::GcodeUnsupportedCommand, evalError("1+2"));
+
+    std::string deep = "[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+[1+1]]]]]]]]]]]]]]]]]";
+    EXPECT_EQ(Error::ExpressionSyntaxError, evalError(deep));
+}
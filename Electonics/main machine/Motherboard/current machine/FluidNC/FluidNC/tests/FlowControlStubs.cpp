@@ -0,0 +1,231 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+/*
+  FlowControlStubs.cpp - link seams for the FlowControl, Expression and
+  channel tests.
+
+  The tests link the real flow control, expression, job and channel sources.
+  The parameter store is replaced by a plain one that the tests can look
+  into, log messages and realtime commands are kept instead of acted on, and
+  everything else that the channel code reaches - reports, the machine
+  state - is the smallest stand-in that links.
+*/
+
+#include "FlowControlStubs.h"
+
+#include "src/Channel.h"
+#include "src/Error.h"
+#include "src/Logging.h"
+#include "src/Parameters.h"
+#include "src/Probe.h"
+#include "src/Protocol.h"
+#include "src/Report.h"
+#include "src/Serial.h"
+#include "src/System.h"
+#include "src/Uart.h"
+#include "src/Machine/MachineConfig.h"
+
+#include <map>
+#include <vector>
+
+// Parameters.  #1-#30 are the call arguments; named parameters get slots in
+// the order in which they are first seen.
+
+float call_params[n_call_params];
+
+static std::vector<std::string>   slotNames;
+static std::vector<param_value_t> namedValues;
+static std::map<int, float>       numberedValues;
+
+void TestParams::reset() {
+    std::fill(call_params, call_params + n_call_params, 0.0f);
+    namedValues.assign(namedValues.size(), param_value_t());
+    numberedValues.clear();
+}
+
+float TestParams::named(const std::string& name) {
+    return namedValues[param_slot(name)].value;
+}
+
+void TestParams::setNumbered(int id, float value) {
+    if (id >= 1 && id <= n_call_params) {
+        call_params[id - 1] = value;
+    } else {
+        numberedValues[id] = value;
+    }
+}
+
+int param_slot(const std::string& name) {
+    for (size_t slot = 0; slot < slotNames.size(); ++slot) {
+        if (slotNames[slot] == name) {
+            return slot;
+        }
+    }
+    slotNames.push_back(name);
+    namedValues.resize(slotNames.size());
+    return slotNames.size() - 1;
+}
+
+bool get_param(const param_ref_t& param_ref, float& result) {
+    if (param_ref.name.length()) {
+        result = namedValues[param_ref.slot].value;
+        return true;
+    }
+    if (param_ref.id >= 1 && param_ref.id <= n_call_params) {
+        result = call_params[param_ref.id - 1];
+        return true;
+    }
+    auto it = numberedValues.find(param_ref.id);
+    if (it == numberedValues.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+void set_named_param(const std::string& name, float value) {
+    namedValues[param_slot(name)] = { value, true };
+}
+
+// As EXISTS[#<name>] passes it
+bool named_param_exists(std::string& name) {
+    if (name.length() > 3 && name[0] == '#' && name[1] == '<' && name.back() == '>') {
+        return namedValues[param_slot(name.substr(2, name.length() - 3))].set;
+    }
+    return namedValues[param_slot(name)].set;
+}
+
+// Logging.  Errors are kept so that a test can check what was reported.
+
+std::string TestLog::last;
+
+bool atMsgLevel(MsgLevel level) {
+    return level <= MsgLevelError;
+}
+
+LogStream::LogStream(Channel& channel, MsgLevel level) : _channel(channel), _level(level) {
+    _line = new std::string();
+}
+LogStream::LogStream(Channel& channel, MsgLevel level, const char* name) : LogStream(channel, level) {
+    print(name);
+}
+LogStream::LogStream(Channel& channel, const char* name) : LogStream(channel, MsgLevelNone, name) {}
+LogStream::LogStream(MsgLevel level, const char* name) : LogStream(allChannels, level, name) {}
+
+size_t LogStream::write(uint8_t c) {
+    *_line += char(c);
+    return 1;
+}
+
+LogStream::~LogStream() {
+    TestLog::last = *_line;
+    delete _line;
+}
+
+// Channels
+
+AllChannels allChannels;
+
+void AllChannels::notifyWco() {}
+void AllChannels::notifyNgc(CoordIndex coord) {}
+void AllChannels::notifyOvr() {}
+
+size_t AllChannels::write(uint8_t data) {
+    return 1;
+}
+size_t AllChannels::write(const uint8_t* buffer, size_t length) {
+    return length;
+}
+void AllChannels::print_msg(MsgLevel level, const char* msg) {}
+void AllChannels::flushRx() {}
+void AllChannels::registration(Channel* channel) {}
+
+const EnumItem messageLevels2[] = { { MsgLevelNone, "None" }, EnumItem(MsgLevelNone) };
+
+// A UART that has received nothing and keeps what is written to it.  Its
+// pins are never set up.
+
+Pins::PinDetail* Pin::undefinedPin = nullptr;
+Pin::~Pin() {}
+
+std::string TestUart::output;
+
+Uart::Uart(int uart_num) : _uart_num(uart_num) {}
+void Uart::begin(unsigned long baud, UartData dataBits, UartStop stopBits, UartParity parity) {}
+
+int Uart::peek() {
+    return -1;
+}
+int Uart::available() {
+    return 0;
+}
+int Uart::read() {
+    return -1;
+}
+size_t Uart::write(uint8_t data) {
+    TestUart::output += char(data);
+    return 1;
+}
+size_t Uart::write(const uint8_t* buffer, size_t length) {
+    TestUart::output.append(reinterpret_cast<const char*>(buffer), length);
+    return length;
+}
+void   Uart::flushRx() {}
+size_t Uart::timedReadBytes(char* buffer, size_t len, TickType_t timeout) {
+    return 0;
+}
+void Uart::setSwFlowControl(bool on, int rx_threshold, int tx_threshold) {}
+
+// Setting names for line completion; there are none
+int num_initial_matches(const char* key, int keylen, int matchnum, char* matchname) {
+    return 0;
+}
+
+TaskHandle_t outputTask    = nullptr;
+xQueueHandle message_queue = nullptr;
+
+std::string TestRealtime::commands;
+
+// As in RealtimeCmd.cpp
+bool is_realtime_command(uint8_t data) {
+    if (data >= 0x80) {
+        return true;
+    }
+    auto cmd = static_cast<Cmd>(data);
+    return cmd == Cmd::Reset || cmd == Cmd::StatusReport || cmd == Cmd::CycleStart || cmd == Cmd::FeedHold;
+}
+void execute_realtime_command(Cmd command, Channel& channel) {
+    TestRealtime::commands += char(command);
+}
+
+void protocol_execute_realtime() {}
+void protocol_exec_rt_system() {}
+
+// Reports and machine state
+
+Counter     report_ovr_counter = 0;
+Counter     report_wco_counter = 0;
+std::string report_pin_string;
+
+void report_realtime_status(Channel& channel) {}
+void report_ngc_coord(CoordIndex coord, Channel& channel) {}
+void report_gcode_modes(Channel& channel) {}
+void report_recompute_pin_string() {}
+
+const char* errorString(Error errorNumber) {
+    return "error";
+}
+
+MachineConfig* config = nullptr;
+parser_state_t gc_state;
+gc_modal_t     modal_defaults = {};
+system_t       sys;
+
+bool state_is(State state) {
+    return state == State::Idle;
+}
+
+bool Probe::get_state() {
+    return false;
+}
@@ -0,0 +1,32 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#pragma once
+
+#include <string>
+
+// The parameter store behind the FlowControl and Expression tests
+class TestParams {
+public:
+    static void  reset();
+    static float named(const std::string& name);
+    static void  setNumbered(int id, float value);
+};
+
+// The text of the last message logged
+class TestLog {
+public:
+    static std::string last;
+};
+
+// The realtime commands that channels have acted on, in order
+class TestRealtime {
+public:
+    static std::string commands;
+};
+
+// Everything written to a Uart
+class TestUart {
+public:
+    static std::string output;
+};
@@ -0,0 +1,262 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "gtest/gtest.h"
+#include "FlowControlStubs.h"
+
+#include "src/Channel.h"
+#include "src/Expression.h"
+#include "src/FlowControl.h"
+#include "src/Job.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// A job read from a list of collapsed lines.  The read position is the
+// index of the next line.
+class ProgramChannel : public Channel {
+    std::vector<std::string> _lines;
+    size_t                   _position = 0;
+
+public:
+    ProgramChannel(const std::vector<std::string>& lines) : Channel("program"), _lines(lines) {}
+
+    bool next(std::string& line) {
+        if (_position == _lines.size()) {
+            return false;
+        }
+        line = _lines[_position++];
+        ++_line_number;
+        return true;
+    }
+
+    size_t write(uint8_t c) override { return 1; }
+
+    bool   seekable() override { return true; }
+    size_t tell() override { return _position; }
+    void   seek(size_t position, size_t lineNumber) override {
+        _position    = position;
+        _line_number = lineNumber;
+    }
+};
+
+struct Run {
+    Error                    status = Error::Ok;
+    std::vector<std::string> executed;  // The lines that were neither O-words nor passed over
+};
+
+// Runs lines as a job would.  O-word lines go to the job's FlowControl,
+// #n=[...] assignments are made here, and every other line is recorded.
+// A program that does not end within maxLines lines fails.
+static Run run(const std::vector<std::string>& lines, size_t maxLines = 1000) {
+    TestParams::reset();
+    auto channel = new ProgramChannel(lines);
+    Job::nest(channel, nullptr);
+
+    Run         result;
+    std::string line;
+    for (size_t n = 0; channel->next(line); ++n) {
+        if (n == maxLines) {
+            ADD_FAILURE() << "The program did not end";
+            break;
+        }
+        if (is_flowcontrol(line.c_str())) {
+            result.status = Job::flow().execute(line.c_str());
+            if (result.status != Error::Ok) {
+                break;
+            }
+        } else if (Job::flow().skipping()) {
+            continue;
+        } else if (line[0] == '#') {
+            char*  end;
+            int    id  = strtol(line.c_str() + 1, &end, 10);
+            size_t pos = end + 1 - line.c_str();
+            float  value;
+            result.status = expression(line.c_str(), &pos, value);
+            if (result.status != Error::Ok) {
+                break;
+            }
+            TestParams::setNumbered(id, value);
+        } else {
+            result.executed.push_back(line);
+        }
+    }
+    Job::abort();
+    return result;
+}
+
+using Lines = std::vector<std::string>;
+
+TEST(FlowControl, IfTakesTheFirstTrueBranch) {
+    auto r = run({ "#1=[2]", "O1IF[#1EQ1]", "A", "O1ELSEIF[#1EQ2]", "B", "O1ELSEIF[#1GT0]", "C", "O1ELSE", "D", "O1ENDIF", "E" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "B", "E" }), r.executed);
+
+    r = run({ "O1IF[0]", "A", "O1ELSE", "B", "O1ENDIF" });
+    EXPECT_EQ(Lines({ "B" }), r.executed);
+}
+
+TEST(FlowControl, WhileTestsFirst) {
+    auto r = run({ "O2WHILE[#1LT3]", "X", "#1=[#1+1]", "O2ENDWHILE", "Y" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X", "X", "X", "Y" }), r.executed);
+
+    r = run({ "O2WHILE[0]", "X", "O2ENDWHILE", "Y" });
+    EXPECT_EQ(Lines({ "Y" }), r.executed);
+}
+
+TEST(FlowControl, DoTestsLast) {
+    auto r = run({ "O3DO", "X", "O3WHILE[0]", "Y" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X", "Y" }), r.executed);
+
+    r = run({ "O3DO", "X", "#1=[#1+1]", "O3WHILE[#1LT2]" });
+    EXPECT_EQ(Lines({ "X", "X" }), r.executed);
+}
+
+TEST(FlowControl, RepeatCounts) {
+    auto r = run({ "O4REPEAT[3]", "X", "O4ENDREPEAT", "Y" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X", "X", "X", "Y" }), r.executed);
+
+    r = run({ "O4REPEAT[0]", "X", "O4ENDREPEAT", "Y" });
+    EXPECT_EQ(Lines({ "Y" }), r.executed);
+}
+
+TEST(FlowControl, BreakAndContinue) {
+    // Inner blocks are dropped on the way out of the loop
+    auto r = run({ "O5WHILE[1]",
+                   "#1=[#1+1]",
+                   "O6IF[#1EQ2]",
+                   "O5CONTINUE",
+                   "O6ENDIF",
+                   "O7IF[#1EQ4]",
+                   "O5BREAK",
+                   "O7ENDIF",
+                   "X",
+                   "O5ENDWHILE",
+                   "Y" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X", "X", "Y" }), r.executed);
+
+    r = run({ "O5DO", "#1=[#1+1]", "O5CONTINUE", "X", "O5WHILE[#1LT3]", "Y" });
+    EXPECT_EQ(Lines({ "Y" }), r.executed);
+
+    r = run({ "O5REPEAT[5]", "X", "O5BREAK", "O5ENDREPEAT", "Y" });
+    EXPECT_EQ(Lines({ "X", "Y" }), r.executed);
+
+    // A continue on the last pass ends the loop
+    r = run({ "O5REPEAT[2]", "X", "O5CONTINUE", "Z", "O5ENDREPEAT", "Y" });
+    EXPECT_EQ(Lines({ "X", "X", "Y" }), r.executed);
+}
+
+TEST(FlowControl, CallPassesArgumentsAndRestoresThem) {
+    auto r = run({ "#1=[7]",
+                   "O10SUB",
+                   "S",
+                   "#2=[#1*2]",
+                   "O10RETURN[#1+#2]",
+                   "T",
+                   "O10ENDSUB",
+                   "O10CALL[5]",
+                   "O11IF[#1EQ7]",
+                   "RESTORED",
+                   "O11ENDIF" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "S", "RESTORED" }), r.executed);
+    EXPECT_EQ(15.0f, TestParams::named("_VALUE"));
+}
+
+TEST(FlowControl, CallReturnsFromNestedBlocks) {
+    auto r = run({ "O10SUB", "O12REPEAT[3]", "X", "O10RETURN", "O12ENDREPEAT", "O10ENDSUB", "O10CALL", "O10CALL", "Y" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X", "X", "Y" }), r.executed);
+}
+
+// Lines passed over are read the first time; later passes seek past them
+TEST(FlowControl, SkipsKnownBlocksByTheirEnds) {
+    auto r = run({ "O9REPEAT[3]", "O1WHILE[0]", "A", "O1ENDWHILE", "O2IF[1]", "B", "O2ELSE", "C", "O2ENDIF", "O9ENDREPEAT", "D" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "B", "B", "B", "D" }), r.executed);
+}
+
+// A label used again for a later block must not take the earlier block's end
+TEST(FlowControl, ReusedLabelsSkipTheirOwnBlocks) {
+    auto r = run({ "O9REPEAT[2]",
+                   "O1WHILE[0]",
+                   "A",
+                   "O1ENDWHILE",
+                   "P",
+                   "O1WHILE[0]",
+                   "B",
+                   "C",
+                   "O1ENDWHILE",
+                   "Q",
+                   "O1IF[1]",
+                   "R",
+                   "O1ELSE",
+                   "S",
+                   "O1ENDIF",
+                   "O9ENDREPEAT",
+                   "Z" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "P", "Q", "R", "P", "Q", "R", "Z" }), r.executed);
+}
+
+TEST(FlowControl, SubIsDefinedOnce) {
+    // Reading the same definition again in a loop is fine
+    auto r = run({ "O9REPEAT[2]", "O10SUB", "X", "O10ENDSUB", "O9ENDREPEAT", "O10CALL" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X" }), r.executed);
+
+    r = run({ "O10SUB", "X", "O10ENDSUB", "O10SUB", "Y", "O10ENDSUB", "O10CALL" });
+    EXPECT_EQ(Error::FlowControlSyntaxError, r.status);
+    EXPECT_NE(std::string::npos, TestLog::last.find("O10 sub is already defined"));
+}
+
+// CAM programs often start with a program number.  It is reported as an
+// unsupported command, as before, which does not stop a job.
+TEST(FlowControl, ProgramNumberIsNotFlowControl) {
+    EXPECT_TRUE(is_program_number("O1000"));
+    EXPECT_TRUE(is_program_number("O<part>"));
+    EXPECT_FALSE(is_program_number("O1000SUB"));
+    EXPECT_FALSE(is_program_number("O<part"));
+    EXPECT_FALSE(is_program_number("G1X1"));
+
+    EXPECT_EQ(Error::GcodeUnsupportedCommand, run({ "O1000", "X" }).status);
+
+    auto r = run({ "O1IF[0]", "O1000", "A", "O1ENDIF", "B" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "B" }), r.executed);
+}
+
+TEST(FlowControl, NamedLabels) {
+    auto r = run({ "O<loop>REPEAT[2]", "X", "O<loop>ENDREPEAT" });
+    EXPECT_EQ(Error::Ok, r.status);
+    EXPECT_EQ(Lines({ "X", "X" }), r.executed);
+}
+
+TEST(FlowControl, Errors) {
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1FOO" }).status);
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O<open" }).status);
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1ENDWHILE" }).status);
+    EXPECT_NE(std::string::npos, TestLog::last.find("O1 ENDWHILE does not match an open block"));
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1WHILE[1]", "O1ENDREPEAT" }).status);
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1IF[1]", "O2ENDIF" }).status);
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1BREAK" }).status);
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1CALL" }).status);
+    EXPECT_EQ(Error::FlowControlSyntaxError, run({ "O1RETURN" }).status);
+    EXPECT_EQ(Error::ExpressionDivideByZero, run({ "O1IF[1/0]", "O1ENDIF" }).status);
+
+    Lines deep;
+    for (int i = 0; i < 20; ++i) {
+        deep.push_back("O" + std::to_string(i) + "DO");
+    }
+    EXPECT_EQ(Error::FlowControlStackOverflow, run(deep).status);
+}
+
+TEST(FlowControl, NeedsAJob) {
+    FlowControl flow;
+    EXPECT_EQ(Error::FlowControlNotExecutingMacro, flow.execute("O1IF[1]"));
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "gtest/gtest.h"
+
+#include "src/InputQueue.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// A job channel that ends itself on M2, as gc_execute_line() does through
+// Job::channel()->end()
+class EndingChannel : public Channel {
+public:
+    EndingChannel() : Channel("job") {}
+
+    size_t write(uint8_t c) override { return 1; }
+
+    void execute(const char* line) {
+        if (strcmp(line, "M2") == 0) {
+            end();
+        }
+    }
+};
+
+// Reads every line ahead, as the polling task may, then runs the queue as
+// the protocol task does.  Returns the lines that were executed.
+static std::vector<std::string> runAhead(InputQueue& queue, EndingChannel& channel, const std::vector<std::string>& lines, bool alarm = false) {
+    for (auto& line : lines) {
+        auto& in   = queue.back();
+        in.channel = &channel;
+        in.fromJob = true;
+        strcpy(in.line, line.c_str());
+        queue.push();
+    }
+
+    std::vector<std::string> executed;
+    while (auto in = queue.front()) {
+        if (queue.runnable(*in, alarm)) {
+            executed.push_back(in->line);
+            channel.execute(in->line);
+        }
+        queue.pop();
+    }
+    return executed;
+}
+
+TEST(InputQueue, RunsJobLinesInOrder) {
+    InputQueue    queue;
+    EndingChannel channel;
+    EXPECT_EQ(std::vector<std::string>({ "G1X1", "G1X2" }), runAhead(queue, channel, { "G1X1", "G1X2" }));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(InputQueue, DropsLinesReadAheadOfM2) {
+    InputQueue    queue;
+    EndingChannel channel;
+    EXPECT_EQ(std::vector<std::string>({ "G1X1", "M2" }), runAhead(queue, channel, { "G1X1", "M2", "G1X2", "G1X3" }));
+    EXPECT_TRUE(channel.stopped());
+}
+
+TEST(InputQueue, DropsJobLinesInAlarm) {
+    InputQueue    queue;
+    EndingChannel channel;
+    EXPECT_TRUE(runAhead(queue, channel, { "G1X1" }, true).empty());
+}
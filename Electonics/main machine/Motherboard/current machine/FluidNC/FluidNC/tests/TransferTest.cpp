@@ -0,0 +1,223 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "gtest/gtest.h"
+#include "src/Transfer/Crc32.h"
+#include "src/Transfer/Lz4.h"
+#include "src/Transfer/Receiver.h"
+#include "src/Transfer/Sender.h"
+
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Transfer;
+
+// Text that looks like G-code, so that it compresses like a real job
+static std::vector<uint8_t> gcode(size_t length) {
+    std::vector<uint8_t> data;
+    std::mt19937         rng(1);
+    while (data.size() < length) {
+        std::string line = "G1 X" + std::to_string(rng() % 30000 / 100.0) + " Y" + std::to_string(rng() % 30000 / 100.0) + " F3000\n";
+        data.insert(data.end(), line.begin(), line.end());
+    }
+    data.resize(length);
+    return data;
+}
+
+static std::vector<uint8_t> noise(size_t length) {
+    std::vector<uint8_t> data(length);
+    std::mt19937         rng(2);
+    for (auto& b : data) {
+        b = uint8_t(rng());
+    }
+    return data;
+}
+
+// Connects a Sender and a Receiver through two byte queues.  Each call to
+// the damage function may alter a chunk on its way to the receiver.
+struct Link {
+    std::deque<std::vector<uint8_t>> toDevice;
+    std::deque<std::vector<uint8_t>> toHost;
+    std::vector<uint8_t>             file;
+
+    Receiver rx;
+    Sender   tx;
+
+    std::function<void(std::vector<uint8_t>&)> damage;
+
+    Link(const std::vector<uint8_t>& data, bool compress = true, uint16_t frameSize = 512, uint8_t window = 4) :
+        rx([this](const uint8_t* d, size_t n) { toHost.emplace_back(d, d + n); },
+           [this](const uint8_t* d, size_t n) {
+               file.insert(file.end(), d, d + n);
+               return true;
+           },
+           frameSize,
+           window),
+        tx(data.data(), data.size(), [this](const uint8_t* d, size_t n) { toDevice.emplace_back(d, d + n); }, compress) {}
+
+    // Runs until both ends finish or the link stalls too often
+    void run() {
+        rx.hello();
+        for (int stalls = 0; stalls < 50;) {
+            tx.pump();
+            if (toDevice.empty() && toHost.empty()) {
+                if (tx.state() == Sender::State::Done || tx.state() == Sender::State::Failed) {
+                    return;
+                }
+                // Both ends are waiting; let their timers fire
+                ++stalls;
+                rx.timeout();
+                tx.timeout();
+                continue;
+            }
+            while (!toDevice.empty()) {
+                auto chunk = toDevice.front();
+                toDevice.pop_front();
+                if (damage) {
+                    damage(chunk);
+                }
+                rx.receive(chunk.data(), chunk.size());
+            }
+            while (!toHost.empty()) {
+                auto chunk = toHost.front();
+                toHost.pop_front();
+                tx.receive(chunk.data(), chunk.size());
+            }
+        }
+    }
+};
+
+TEST(Transfer, Crc32) {
+    const char* check = "123456789";
+    EXPECT_EQ(crc32(reinterpret_cast<const uint8_t*>(check), 9), 0xCBF43926u);
+
+    // Incremental use gives the same result
+    uint32_t crc = crc32(reinterpret_cast<const uint8_t*>(check), 4);
+    EXPECT_EQ(crc32(reinterpret_cast<const uint8_t*>(check) + 4, 5, crc), 0xCBF43926u);
+}
+
+TEST(Transfer, Lz4RoundTrip) {
+    for (auto& data : { gcode(4096), noise(4096), std::vector<uint8_t>(4096, 'x'), gcode(7) }) {
+        std::vector<uint8_t> packed(data.size() * 2 + 16);
+        size_t               n = Lz4::compress(data.data(), data.size(), packed.data(), packed.size());
+        ASSERT_NE(n, 0u);
+
+        std::vector<uint8_t> unpacked(data.size());
+        ASSERT_EQ(Lz4::decompress(packed.data(), n, unpacked.data(), unpacked.size()), int(data.size()));
+        EXPECT_EQ(unpacked, data);
+    }
+}
+
+TEST(Transfer, Lz4CompressesGCode) {
+    auto                 data = gcode(4096);
+    std::vector<uint8_t> packed(data.size());
+    size_t               n = Lz4::compress(data.data(), data.size(), packed.data(), packed.size());
+    ASSERT_NE(n, 0u);
+    EXPECT_LT(n, data.size() * 3 / 4);
+}
+
+TEST(Transfer, Lz4RejectsBadInput) {
+    auto                 data = gcode(1024);
+    std::vector<uint8_t> packed(2048);
+    size_t               n = Lz4::compress(data.data(), data.size(), packed.data(), packed.size());
+    ASSERT_NE(n, 0u);
+
+    // Too little room for the output
+    std::vector<uint8_t> unpacked(data.size());
+    EXPECT_EQ(Lz4::decompress(packed.data(), n, unpacked.data(), data.size() - 1), -1);
+
+    // Truncated input
+    EXPECT_EQ(Lz4::decompress(packed.data(), n / 2, unpacked.data(), unpacked.size()), -1);
+}
+
+TEST(Transfer, RoundTrip) {
+    for (size_t length : { size_t(0), size_t(1), size_t(511), size_t(512), size_t(20000) }) {
+        auto data = gcode(length);
+        Link link(data);
+        link.run();
+        EXPECT_EQ(link.tx.state(), Sender::State::Done) << length;
+        EXPECT_EQ(link.rx.state(), Receiver::State::Done) << length;
+        EXPECT_EQ(link.rx.fileLength(), length);
+        EXPECT_EQ(link.file, data) << length;
+    }
+}
+
+TEST(Transfer, CompressesOnTheWire) {
+    auto data = gcode(20000);
+    Link link(data);
+    link.run();
+    ASSERT_EQ(link.file, data);
+    EXPECT_GT(link.tx.stats().compressed, 0u);
+    EXPECT_LT(link.tx.stats().wireBytes, data.size());
+}
+
+TEST(Transfer, IncompressibleDataIsSentRaw) {
+    auto data = noise(5000);
+    Link link(data);
+    link.run();
+    ASSERT_EQ(link.file, data);
+    EXPECT_EQ(link.tx.stats().compressed, 0u);
+}
+
+TEST(Transfer, RecoversFromLossAndCorruption) {
+    auto data = gcode(30000);
+    Link link(data);
+
+    std::mt19937 rng(3);
+    link.damage = [&rng](std::vector<uint8_t>& chunk) {
+        switch (rng() % 8) {
+            case 0:
+                chunk.clear();  // Lost
+                break;
+            case 1:
+                chunk[rng() % chunk.size()] ^= 0x10;  // Corrupted
+                break;
+            case 2:
+                chunk.resize(chunk.size() / 2);  // Cut short
+                break;
+        }
+    };
+    link.run();
+    EXPECT_EQ(link.tx.state(), Sender::State::Done);
+    EXPECT_EQ(link.file, data);
+    EXPECT_GT(link.tx.stats().resends, 0u);
+}
+
+TEST(Transfer, Cancel) {
+    auto data = gcode(20000);
+    Link link(data);
+    link.rx.hello();
+    link.tx.receive(link.toHost.front().data(), link.toHost.front().size());
+    link.toHost.clear();
+    link.tx.cancel();
+    for (auto& chunk : link.toDevice) {
+        link.rx.receive(chunk.data(), chunk.size());
+    }
+    EXPECT_EQ(link.rx.state(), Receiver::State::Failed);
+    EXPECT_EQ(link.rx.failCode(), FailCode::Cancelled);
+}
+
+TEST(Transfer, WriteErrorIsReported) {
+    auto                             data = gcode(5000);
+    std::deque<std::vector<uint8_t>> toDevice, toHost;
+    Receiver rx([&](const uint8_t* d, size_t n) { toHost.emplace_back(d, d + n); }, [](const uint8_t*, size_t) { return false; });
+    Sender   tx(data.data(), data.size(), [&](const uint8_t* d, size_t n) { toDevice.emplace_back(d, d + n); });
+
+    rx.hello();
+    for (int i = 0; i < 10 && tx.state() != Sender::State::Failed; i++) {
+        for (auto& chunk : toHost) {
+            tx.receive(chunk.data(), chunk.size());
+        }
+        toHost.clear();
+        tx.pump();
+        for (auto& chunk : toDevice) {
+            rx.receive(chunk.data(), chunk.size());
+        }
+        toDevice.clear();
+    }
+    EXPECT_EQ(tx.state(), Sender::State::Failed);
+    EXPECT_EQ(tx.failCode(), FailCode::Write);
+}
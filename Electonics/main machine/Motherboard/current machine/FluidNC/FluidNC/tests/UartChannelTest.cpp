@@ -0,0 +1,75 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+#include "gtest/gtest.h"
+#include "FlowControlStubs.h"
+
+#include "src/UartChannel.h"
+
+#include <string>
+#include <vector>
+
+// Input is given to queueInput() as if it had just been read from the UART,
+// and the lines are then collected as pollLine() would
+class UartInput {
+    Uart        _uart { 1 };
+    UartChannel _channel { 1 };
+
+public:
+    UartInput() {
+        _channel.init(&_uart);
+        TestRealtime::commands.clear();
+    }
+
+    void receive(const std::string& data) {
+        _channel.queueInput(reinterpret_cast<const uint8_t*>(data.data()), data.length());
+    }
+
+    std::vector<std::string> lines() {
+        std::vector<std::string> result;
+        char                     line[Channel::maxLine];
+        while (_channel.assembleLine(line)) {
+            result.push_back(line);
+        }
+        return result;
+    }
+};
+
+using Lines = std::vector<std::string>;
+
+TEST(UartChannel, StreamsLinesAndRealtimeCommands) {
+    UartInput in;
+    in.receive("G1X1\nG1X2!\r\nG1");
+    in.receive("X3?\n");
+    EXPECT_EQ(Lines({ "G1X1", "G1X2", "G1X3" }), in.lines());
+    EXPECT_EQ("!?", TestRealtime::commands);
+}
+
+// The ~ that ends the Delete key's escape sequence is not CycleStart, even
+// when the sequence arrives together with the text before it
+TEST(UartChannel, DeleteKeyIsNotCycleStart) {
+    UartInput in;
+    in.receive("G1X12\x1b[D\x1b[3~\r");
+    EXPECT_EQ(Lines({ "G1X1" }), in.lines());
+    EXPECT_EQ("", TestRealtime::commands);
+
+    in.receive("~");
+    EXPECT_EQ("~", TestRealtime::commands);
+}
+
+// Text queued before editing starts is edited first, so lines stay in order
+TEST(UartChannel, EditingKeepsQueuedLinesInOrder) {
+    UartInput in;
+    in.receive("G1X1\nG1X2");
+    in.receive("\b3\nG1X4\n");
+    EXPECT_EQ(Lines({ "G1X1", "G1X3", "G1X4" }), in.lines());
+}
+
+// ^L turns editing off, and input is queued in bulk again
+TEST(UartChannel, CtrlLReturnsToStreaming) {
+    UartInput in;
+    in.receive("\bG1X1\n\x0c");
+    in.receive("G1X2~\n");
+    EXPECT_EQ(Lines({ "G1X1", "G1X2" }), in.lines());
+    EXPECT_EQ("~", TestRealtime::commands);
+}
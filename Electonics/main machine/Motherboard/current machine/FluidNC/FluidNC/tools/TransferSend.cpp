@@ -0,0 +1,186 @@
+// Copyright (c) 2026 - FabLab Kerala MTM team
+// Use of this source code is governed by a GPLv3 license that can be found in the LICENSE file.
+
+// Host side of $Transfer/Receive: sends a file to the controller over a
+// serial port with the windowed protocol in src/Transfer/Frame.h.
+//
+//   TransferSend [-r] <port> <baud> <file> [<destination>]
+//
+//   -r  send frames uncompressed
+//
+// Build with
+//   pio run -e transfer_send
+// or directly, from the FluidNC directory
+//   g++ -std=c++17 -O2 -I. tools/TransferSend.cpp src/Transfer/{Frame,Crc32,Lz4,Sender}.cpp -o TransferSend
+
+#include "src/Transfer/Sender.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Transfer;
+
+static speed_t baudCode(long baud) {
+    switch (baud) {
+        case 9600:
+            return B9600;
+        case 19200:
+            return B19200;
+        case 38400:
+            return B38400;
+        case 57600:
+            return B57600;
+        case 115200:
+            return B115200;
+        case 230400:
+            return B230400;
+#ifdef B460800
+        case 460800:
+            return B460800;
+#endif
+#ifdef B921600
+        case 921600:
+            return B921600;
+#endif
+        default:
+            return 0;
+    }
+}
+
+static int openPort(const char* path, long baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct termios tio;
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, baudCode(baud));
+    cfsetospeed(&tio, baudCode(baud));
+    tcsetattr(fd, TCSANOW, &tio);
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static void writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length) {
+        ssize_t n = write(fd, data, length);
+        if (n <= 0) {
+            perror("write");
+            exit(1);
+        }
+        data += n;
+        length -= n;
+    }
+}
+
+// Waits up to ms milliseconds for input, returning the number of bytes read
+static size_t readSome(int fd, uint8_t* buffer, size_t length, int ms) {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    struct timeval tv = { ms / 1000, (ms % 1000) * 1000 };
+    if (select(fd + 1, &fds, nullptr, nullptr, &tv) <= 0) {
+        return 0;
+    }
+    ssize_t n = read(fd, buffer, length);
+    return n > 0 ? n : 0;
+}
+
+static std::vector<uint8_t> readFile(const char* path) {
+    std::vector<uint8_t> data;
+    FILE*                f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    uint8_t buffer[4096];
+    size_t  n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char** argv) {
+    bool compress = true;
+    if (argc > 1 && strcmp(argv[1], "-r") == 0) {
+        compress = false;
+        --argc;
+        ++argv;
+    }
+    if (argc < 4) {
+        fprintf(stderr, "Usage: TransferSend [-r] <port> <baud> <file> [<destination>]\n");
+        return 2;
+    }
+    long baud = strtol(argv[2], nullptr, 10);
+    if (!baudCode(baud)) {
+        fprintf(stderr, "Unsupported baud rate %ld\n", baud);
+        return 2;
+    }
+    auto        data        = readFile(argv[3]);
+    std::string destination = argc > 4 ? argv[4] : argv[3];
+    if (auto slash = destination.find_last_of('/'); argc <= 4 && slash != std::string::npos) {
+        destination = destination.substr(slash + 1);
+    }
+
+    int fd = openPort(argv[1], baud);
+    if (fd < 0) {
+        return 1;
+    }
+
+    Sender tx(data.data(), data.size(), [fd](const uint8_t* d, size_t n) { writeAll(fd, d, n); }, compress);
+
+    std::string command = "$Transfer/Receive=" + destination + "\n";
+    writeAll(fd, reinterpret_cast<const uint8_t*>(command.data()), command.size());
+
+    auto    start = std::chrono::steady_clock::now();
+    int     idle  = 0;
+    uint8_t buffer[256];
+    while (tx.state() == Sender::State::WaitingHello || tx.state() == Sender::State::Running) {
+        tx.pump();
+        size_t n = readSome(fd, buffer, sizeof(buffer), 100);
+        if (n) {
+            tx.receive(buffer, n);
+            idle = 0;
+        } else if (++idle % 10 == 0) {
+            // A second without a reply; resend what is outstanding
+            if (idle == 150) {
+                fprintf(stderr, "No response from the controller\n");
+                tx.cancel();
+                break;
+            }
+            tx.timeout();
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto&  stats   = tx.stats();
+    if (tx.state() != Sender::State::Done) {
+        fprintf(stderr, "Transfer failed with code %u\n", unsigned(tx.failCode()));
+        return 1;
+    }
+    printf("Sent %zu bytes as %llu in %.1f s (%.0f bytes/s), %u frames, %u resent, %u compressed\n",
+           data.size(),
+           (unsigned long long)stats.wireBytes,
+           seconds,
+           data.size() / seconds,
+           stats.frames,
+           stats.resends,
+           stats.compressed);
+    close(fd);
+    return 0;
+}
@@ -6,6 +6,8 @@
 #include <chrono>
 #include <thread>
 
+HardwareSerial Serial;
+
 int64_t esp_timer_get_time() {
     return Capture::instance().current();
 }
@@ -40,6 +42,23 @@ extern "C" void __pinMode(uint8_t pin, uint8_t mode) {
 }
 
 extern "C" void __digitalWrite(uint8_t pin, uint8_t val) {
+    // Step and direction pins write often, so their capture IDs are interned once. The IDs are interned
+    // whether or not the writes are captured, so a VCD stream started later declares them.
+    static int32_t captureIds[256];
+    static bool    interned = false;
+    if (!interned) {
+        for (int i = 0; i < 256; ++i) {
+            captureIds[i] = -1;
+        }
+        interned = true;
+    }
+    if (captureIds[pin] < 0) {
+        captureIds[pin] = Capture::instance().intern("gpio." + std::to_string(pin), 1);
+    }
+    if (Capture::instance().streaming()) {
+        Capture::instance().write(uint32_t(captureIds[pin]), val ? 1 : 0);
+    }
+
     auto& io = SoftwareGPIO::instance();
     return io.writeOutput(pin, val ? true : false);
 }
@@ -25,3 +25,5 @@ int64_t esp_timer_get_time();
 // ESP...
 
 #include "Esp.h"
+
+#include "HardwareSerial.h"
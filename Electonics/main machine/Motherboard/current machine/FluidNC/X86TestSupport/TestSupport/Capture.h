@@ -3,6 +3,7 @@
 #include <string>
 #include <cstdint>
 #include <vector>
+#include <ostream>
 #include <unordered_map>
 
 // Capture here defines everything that we want to know. Specifically, we want to capture per ID:
@@ -10,18 +11,205 @@
 // 2. Data. This can be a simple '1' or '0', or a character stream. For simplicity, we store a vector of integers.
 //
 // An ID itself is a string. This can be a pin ID (gpio.1), an uart (uart.0), an ledc, or whatever.
+//
+// Long simulated jobs write millions of events, so they are stored by column: a time, an id and a value
+// per event, with any further data words in a shared pool. ID strings are interned once; callers that
+// write often can intern up front and write by number. With streamTo(), events are written out in chunks
+// as they come in, so a run of any length fits in memory. GPIO writes are only captured while streaming,
+// as there are too many of them to hold. Formats:
+//
+//   Csv     time,id,value,data - data words separated by spaces
+//   Vcd     Value Change Dump, for waveform viewers such as GTKWave. IDs are declared in the header, so
+//           when streaming, intern every ID before the first chunk is written; events of IDs interned
+//           later are left out. Times must not go backwards, and data words are left out.
+//   Binary  "FNCCAP1\n", then little-endian records:
+//             1, id:u32, width:u8, length:u16, name   - before the first event of each ID
+//             2, time:u32, id:u32, value:u32, count:u32, count x data:u32
 
 struct CaptureEvent {
-    uint32_t              time = 0;
-    std::string           id;
-    std::vector<uint32_t> data;
+    uint32_t        time  = 0;
+    uint32_t        id    = 0;
+    uint32_t        value = 0;
+    const uint32_t* data  = nullptr;  // Further data words, valid until the next write
+    size_t          size  = 0;
 };
 
 class Capture {
+public:
+    enum class Format { Csv, Vcd, Binary };
+
+private:
     Capture() = default;
 
-    std::vector<CaptureEvent> events;
-    uint32_t                  currentTime = 0;
+    // One entry per event
+    std::vector<uint32_t> times;
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> values;
+    std::vector<uint32_t> dataEnds;  // End of the event's words in dataPool
+    std::vector<uint32_t> dataPool;
+
+    // One entry per ID
+    std::vector<std::string>                  names;
+    std::vector<uint8_t>                      widths;  // Bits, for VCD
+    std::unordered_map<std::string, uint32_t> index;
+
+    // What has been written to an output so far
+    struct Writer {
+        Format   format;
+        bool     started  = false;
+        uint32_t declared = 0;  // IDs named in the output
+        bool     timed    = false;
+        uint32_t lastTime = 0;
+        size_t   skipped  = 0;  // VCD events of undeclared IDs
+    };
+
+    std::ostream* sink       = nullptr;
+    size_t        chunkSize  = 0;
+    std::string   timescale  = "1 ms";
+    Writer        sinkWriter = { Format::Csv };
+
+    uint32_t currentTime = 0;
+
+    static void put(std::ostream& out, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.put(char(value >> (8 * i)));
+        }
+    }
+
+    static void putCsvField(std::ostream& out, const std::string& field) {
+        if (field.find_first_of(",\"\n") == std::string::npos) {
+            out << field;
+            return;
+        }
+        out << '"';
+        for (char c : field) {
+            out << c;
+            if (c == '"') {
+                out << '"';
+            }
+        }
+        out << '"';
+    }
+
+    // VCD identifier codes: base 94 in the printable characters
+    static std::string vcdCode(uint32_t id) {
+        std::string code;
+        do {
+            code += char('!' + id % 94);
+            id /= 94;
+        } while (id);
+        return code;
+    }
+
+    static void putVcdValue(std::ostream& out, uint32_t value, uint8_t width, uint32_t id) {
+        if (width == 1) {
+            out << (value ? '1' : '0') << vcdCode(id) << '\n';
+            return;
+        }
+        out << 'b';
+        int bit = 31;
+        while (bit > 0 && !(value >> bit & 1)) {
+            --bit;
+        }
+        for (; bit >= 0; --bit) {
+            out << ((value >> bit & 1) ? '1' : '0');
+        }
+        out << ' ' << vcdCode(id) << '\n';
+    }
+
+    void writeHeader(std::ostream& out, Writer& w) {
+        switch (w.format) {
+            case Format::Csv:
+                out << "time,id,value,data\n";
+                break;
+            case Format::Binary:
+                out << "FNCCAP1\n";
+                break;
+            case Format::Vcd:
+                out << "$timescale " << timescale << " $end\n";
+                out << "$scope module capture $end\n";
+                for (uint32_t id = 0; id < names.size(); ++id) {
+                    std::string name = names[id];
+                    for (auto& c : name) {
+                        if (c == ' ') {
+                            c = '_';
+                        }
+                    }
+                    out << "$var wire " << int(widths[id]) << ' ' << vcdCode(id) << ' ' << name << " $end\n";
+                }
+                out << "$upscope $end\n$enddefinitions $end\n";
+                w.declared = uint32_t(names.size());
+                break;
+        }
+        w.started = true;
+    }
+
+    // Writes the held events
+    void writeEvents(std::ostream& out, Writer& w) {
+        if (!w.started) {
+            writeHeader(out, w);
+        }
+        if (w.format == Format::Binary) {
+            for (; w.declared < names.size(); ++w.declared) {
+                auto& name = names[w.declared];
+                put(out, 1, 1);
+                put(out, w.declared, 4);
+                put(out, widths[w.declared], 1);
+                put(out, uint32_t(name.size()), 2);
+                out.write(name.data(), name.size());
+            }
+        }
+
+        for (size_t i = 0; i < size(); ++i) {
+            auto evt = event(i);
+            switch (w.format) {
+                case Format::Csv:
+                    out << evt.time << ',';
+                    putCsvField(out, names[evt.id]);
+                    out << ',' << evt.value << ',';
+                    for (size_t j = 0; j < evt.size; ++j) {
+                        out << (j ? " " : "") << evt.data[j];
+                    }
+                    out << '\n';
+                    break;
+
+                case Format::Binary:
+                    put(out, 2, 1);
+                    put(out, evt.time, 4);
+                    put(out, evt.id, 4);
+                    put(out, evt.value, 4);
+                    put(out, uint32_t(evt.size), 4);
+                    for (size_t j = 0; j < evt.size; ++j) {
+                        put(out, evt.data[j], 4);
+                    }
+                    break;
+
+                case Format::Vcd:
+                    if (evt.id >= w.declared) {
+                        ++w.skipped;
+                        break;
+                    }
+                    if (!w.timed || evt.time > w.lastTime) {
+                        out << '#' << evt.time << '\n';
+                        w.lastTime = evt.time;
+                        w.timed    = true;
+                    }
+                    putVcdValue(out, evt.value, widths[evt.id], evt.id);
+                    break;
+            }
+        }
+    }
+
+    void append(uint32_t id, uint32_t value, uint32_t time, const uint32_t* data, size_t count) {
+        times.push_back(time);
+        ids.push_back(id);
+        values.push_back(value);
+        dataPool.insert(dataPool.end(), data, data + count);
+        dataEnds.push_back(uint32_t(dataPool.size()));
+        if (sink && times.size() >= chunkSize) {
+            flush();
+        }
+    }
 
 public:
     static Capture& instance() {
@@ -29,42 +217,92 @@ public:
         return instance;
     }
 
-    void reset() { events.clear(); }
+    // Drops the held events. IDs stay interned, so numbers held by callers stay valid.
+    void reset() {
+        times.clear();
+        ids.clear();
+        values.clear();
+        dataEnds.clear();
+        dataPool.clear();
+    }
 
-    void write(const std::string& id, uint32_t value) {
-        CaptureEvent evt;
-        evt.time = currentTime;
-        evt.id   = id;
-        evt.data.reserve(1);
-        evt.data.push_back(value);
-        events.push_back(evt);
+    // The number of an ID, interning it on first use. width is the ID's bit width in VCD output.
+    uint32_t intern(const std::string& id, uint8_t width = 32) {
+        auto it = index.find(id);
+        if (it != index.end()) {
+            return it->second;
+        }
+        uint32_t number = uint32_t(names.size());
+        names.push_back(id);
+        widths.push_back(width);
+        index.emplace(id, number);
+        return number;
     }
 
-    void write(const std::string& id, uint32_t value, uint32_t time) {
-        CaptureEvent evt;
-        evt.time = time;
-        evt.id   = id;
-        evt.data.reserve(1);
-        evt.data.push_back(value);
-        events.push_back(evt);
+    const std::string& name(uint32_t id) const { return names[id]; }
+
+    void write(uint32_t id, uint32_t value) { append(id, value, currentTime, nullptr, 0); }
+    void write(uint32_t id, uint32_t value, uint32_t time) { append(id, value, time, nullptr, 0); }
+
+    void write(const std::string& id, uint32_t value) { write(intern(id), value); }
+    void write(const std::string& id, uint32_t value, uint32_t time) { write(intern(id), value, time); }
+
+    void write(const std::string& id, uint32_t value, const std::vector<uint32_t>& data) {
+        append(intern(id), value, currentTime, data.data(), data.size());
     }
 
-    void write(const std::string& id, uint32_t value, std::vector<uint32_t> data) {
-        CaptureEvent evt;
-        evt.time = currentTime;
-        evt.id   = id;
-        evt.data = data;
-        events.push_back(evt);
+    void write(const std::string& id, uint32_t value, uint32_t time, const std::vector<uint32_t>& data) {
+        append(intern(id), value, time, data.data(), data.size());
     }
 
-    void write(const std::string& id, uint32_t value, uint32_t time, std::vector<uint32_t> data) {
+    // The events held, which while streaming are those not yet written out
+    size_t size() const { return times.size(); }
+
+    CaptureEvent event(size_t i) const {
         CaptureEvent evt;
-        evt.time = time;
-        evt.id   = id;
-        evt.data = data;
-        events.push_back(evt);
+        evt.time      = times[i];
+        evt.id        = ids[i];
+        evt.value     = values[i];
+        uint32_t from = i ? dataEnds[i - 1] : 0;
+        evt.data      = dataPool.data() + from;
+        evt.size      = dataEnds[i] - from;
+        return evt;
+    }
+
+    // Writes the held events as a complete file
+    void exportTo(std::ostream& out, Format format) {
+        Writer w = { format };
+        writeEvents(out, w);
+    }
+
+    // From now on, writes events to out each time chunk of them are held, and then drops them. The
+    // events already held go out with the first chunk. out must outlive the stream.
+    void streamTo(std::ostream& out, Format format, size_t chunk = 65536) {
+        sink       = &out;
+        chunkSize  = chunk;
+        sinkWriter = { format };
     }
 
+    bool streaming() const { return sink != nullptr; }
+
+    // Writes out the held events when streaming
+    void flush() {
+        if (sink) {
+            writeEvents(*sink, sinkWriter);
+            reset();
+        }
+    }
+
+    // Writes out the rest and stops streaming. Returns the number of VCD events that were left out.
+    size_t endStream() {
+        flush();
+        sink = nullptr;
+        return sinkWriter.skipped;
+    }
+
+    // The VCD $timescale of one time unit
+    void setTimescale(const std::string& scale) { timescale = scale; }
+
     uint32_t current() { return currentTime; }
     void     wait(uint32_t delay) { currentTime += delay; }
     void     waitUntil(uint32_t value) {
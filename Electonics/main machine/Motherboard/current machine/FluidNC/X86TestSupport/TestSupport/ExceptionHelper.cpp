@@ -208,6 +208,15 @@ std::exception CreateException(const char* condition, const char* msg) {
 
 #else
 
+#    include <sstream>
+#    include <stdexcept>
+#    include <string>
+
+// Stack walking is only implemented for Windows
+void DumpStackTrace(std::ostringstream& builder) {
+    builder << "(no stack trace)";
+}
+
 std::exception CreateException(const char* condition, const char* msg) {
     static std::string container;  // Exception data _must_ be stored in a static string!
     std::ostringstream oss;
@@ -215,7 +224,7 @@ std::exception CreateException(const char* condition, const char* msg) {
     oss << "Error: " << condition << " failed: " << msg << " at: " << std::endl;
 
     container = oss.str();
-    return std::exception(container.c_str()); /* this is usually where you want a breakpoint. */
+    return std::runtime_error(container); /* this is usually where you want a breakpoint. */
 }
 
 #endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Stream.h"
+
+#include <cstdio>
+
+// The Arduino core's Serial object.  A few debug prints in FluidNC still write to
+// it directly; on the host they go to stdout.
+class HardwareSerial : public Stream {
+public:
+    int    available() override { return 0; }
+    int    read() override { return -1; }
+    int    peek() override { return -1; }
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+};
+
+extern HardwareSerial Serial;
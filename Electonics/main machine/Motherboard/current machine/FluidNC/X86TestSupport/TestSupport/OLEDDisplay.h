@@ -0,0 +1,70 @@
+#pragma once
+
+// Enough of the ThingPulse SSD1306 library's OLEDDisplay for OLED.h and
+// SSD1306_I2C.h to compile on the host.  Nothing is drawn.
+
+#include <cstdint>
+
+enum OLEDDISPLAY_GEOMETRY { GEOMETRY_128_64 = 0, GEOMETRY_128_32 = 1, GEOMETRY_64_48 = 2, GEOMETRY_64_32 = 3, GEOMETRY_RAWMODE = 4 };
+
+enum OLEDDISPLAY_TEXT_ALIGNMENT { TEXT_ALIGN_LEFT = 0, TEXT_ALIGN_RIGHT = 1, TEXT_ALIGN_CENTER = 2, TEXT_ALIGN_CENTER_BOTH = 3 };
+
+enum OLEDDISPLAY_COLOR { BLACK = 0, WHITE = 1, INVERSE = 2 };
+
+#define COLUMNADDR 0x21
+#define PAGEADDR 0x22
+
+inline void yield() {}
+
+class OLEDDisplay {
+protected:
+    uint16_t _width  = 128;
+    uint16_t _height = 64;
+
+    virtual int getBufferOffset() { return 0; }
+
+public:
+    uint8_t*             buffer            = nullptr;
+    uint8_t*             buffer_back       = nullptr;
+    uint16_t             displayBufferSize = 0;
+    OLEDDISPLAY_GEOMETRY geometry          = GEOMETRY_128_64;
+
+    virtual ~OLEDDisplay() {}
+
+    void     setGeometry(OLEDDISPLAY_GEOMETRY g) { geometry = g; }
+    uint16_t width() { return _width; }
+    uint16_t height() { return _height; }
+
+    virtual void display() {}
+    virtual void sendCommand(uint8_t command) {}
+
+    bool init() { return true; }
+    void end() {}
+    void resetDisplay() {}
+    void clear() {}
+    void flipScreenVertically() {}
+    void mirrorScreen() {}
+    void displayOn() {}
+    void displayOff() {}
+    void setContrast(uint8_t contrast, uint8_t precharge = 241, uint8_t comdetect = 64) {}
+    void setBrightness(uint8_t brightness) {}
+    void setColor(OLEDDISPLAY_COLOR color) {}
+    void setFont(const uint8_t* fontData) {}
+    void setTextAlignment(OLEDDISPLAY_TEXT_ALIGNMENT textAlignment) {}
+
+    void setPixel(int16_t x, int16_t y) {}
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {}
+    void drawRect(int16_t x, int16_t y, int16_t width, int16_t height) {}
+    void fillRect(int16_t x, int16_t y, int16_t width, int16_t height) {}
+    void drawProgressBar(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t progress) {}
+    void drawXbm(int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t* xbm) {}
+
+    template <typename S>
+    uint16_t drawString(int16_t x, int16_t y, const S& text) {
+        return 0;
+    }
+    template <typename S>
+    uint16_t getStringWidth(const S& text) {
+        return 0;
+    }
+};
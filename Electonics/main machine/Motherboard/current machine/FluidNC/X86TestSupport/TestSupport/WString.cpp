@@ -3,12 +3,21 @@
 #include <iomanip>
 #include <sstream>
 
-#pragma warning(disable : 4996)  // itoa
-
+// Same result as itoa(), which is not available everywhere: only base 10 is signed
 std::string String::ValueToString(int value, int base) {
-    char        buffer[100] = { 0 };
-    int         number_base = 10;
-    std::string output      = itoa(value, buffer, base);
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    bool         negative = value < 0 && base == 10;
+    unsigned int v        = negative ? 0u - unsigned(value) : unsigned(value);
+    std::string  output;
+    do {
+        output.insert(output.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"[v % base]);
+        v /= base;
+    } while (v);
+    if (negative) {
+        output.insert(output.begin(), '-');
+    }
     return output;
 }
 
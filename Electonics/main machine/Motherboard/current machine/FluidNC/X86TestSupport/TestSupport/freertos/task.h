@@ -4,6 +4,8 @@
 #include "FreeRTOS.h"
 #include "FreeRTOSTypes.h"
 
+#include <climits>  // INT_MAX
+
 void vTaskDelay(const TickType_t xTicksToDelay);
 
 #define CONFIG_ARDUINO_RUNNING_CORE 0
@@ -35,6 +37,7 @@ TickType_t xTaskGetTickCount(void);
 #define configTICK_RATE_HZ (CONFIG_FREERTOS_HZ)
 #define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
 #define portTICK_RATE_MS portTICK_PERIOD_MS
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
 
 #define portMUX_FREE_VAL 0xB33FFFFF
 
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <string>
+#include <cstring>  // memcpy
 #include "esp_err.h"
 
 class NvsEmulator {
@@ -9,35 +9,156 @@ bool _ackwait = false;
 int _ack_time_limit = 0;
 bool _machine_ready = false; // Flag to detect when machine is ready
 
+// Transmit ring; the indices run freely and are masked on use
+static uint8_t _tx[TX_BUFFER_LEN];
+static uint16_t _tx_head = 0;
+static uint16_t _tx_tail = 0;
+static bool _tx_mid_line = false;  // Part of a line has gone out
+
+// Lines sent and not yet acked, oldest first
+static uint8_t _pending_len[MAX_PENDING_LINES];
+static unsigned long _pending_deadline[MAX_PENDING_LINES];
+static uint8_t _pending_first = 0;
+static uint8_t _pending_count = 0;
+static size_t _pending_bytes = 0;
+
+// Lines that timed out but may still be acked, as $H is only once homing
+// is done.  They are older than any pending line, so the next acks are
+// theirs.  An ack lost on the wire would leave one owed forever, so the
+// count is dropped when FluidNC is plainly done with every line.
+static int _overdue = 0;
+static uint8_t _idle_reports = 0;  // Idle reports in a row with nothing pending
+
+// Jog lines sent before a jog cancel but not yet acked may still be in
+// FluidNC's input, and would start a new jog once parsed.  So the cancel
+// is sent again when all of them are acked, and no line goes out until then.
+static bool _cancel_owed = false;
+
+static size_t tx_free() {
+    return TX_BUFFER_LEN - (uint16_t)(_tx_head - _tx_tail);
+}
+
+// Hand queued chars to the UART, only as many as it can take now
+static void tx_drain() {
+    int room = fnc_tx_room();
+    while (room-- > 0 && _tx_tail != _tx_head) {
+        uint8_t c = _tx[_tx_tail++ & (TX_BUFFER_LEN - 1)];
+        fnc_putchar(c);
+        _tx_mid_line = c != '\n' && c != JogCancel;
+    }
+}
+
+// The oldest line has been acked, or has timed out
+static void ack_pop() {
+    if (_pending_count == 0) return;
+    _pending_bytes -= _pending_len[_pending_first];
+    _pending_first = (_pending_first + 1) % MAX_PENDING_LINES;
+    _pending_count--;
+    _ackwait = _pending_count > 0;
+    if (_ackwait) {
+        _ack_time_limit = _pending_deadline[_pending_first];
+    }
+}
+
+// The oldest line has timed out
+static void ack_expire() {
+    ack_pop();
+    _overdue++;
+}
+
+// An ok or error: goes to the oldest line that still has one coming
+static void ack_received() {
+    if (_overdue) {
+        _overdue--;
+    } else {
+        ack_pop();
+    }
+}
+
+bool fnc_can_send(size_t len) {
+    len++;  // The newline
+    return !_cancel_owed && len <= tx_free() && _pending_count < MAX_PENDING_LINES && _pending_bytes + len <= RX_WINDOW;
+}
+
+int fnc_pending() {
+    return _pending_count;
+}
+
 // Core communication functions
 void fnc_send_line(const char* line, int timeout_ms) {
-    // Wait for previous command acknowledgment
+    size_t len = strlen(line);
+    if (len + 1 > TX_BUFFER_LEN) return;  // Could never fit
+
+    // Wait for room in the window.  If FluidNC stops answering, give up
+    // on the lines it has not acked rather than waiting forever.
     unsigned long start = millis();
-    while (_ackwait) {
+    while (!fnc_can_send(len)) {
         if ((millis() - start) >= timeout_ms) {
-            _ackwait = false;  // Force clear if timeout
-            break;
+            while (_pending_count) {
+                ack_expire();
+            }
+            if (_cancel_owed) {
+                fnc_realtime(JogCancel);
+                _cancel_owed = false;
+            }
         }
         fnc_poll();
     }
 
-    // Send the command
-    const char* p = line;
-    while (*p) {
-        fnc_putchar(*p++);
-        delay(1);  // Add small delay between characters
+    // Queue the command
+    for (size_t i = 0; i < len; i++) {
+        _tx[_tx_head++ & (TX_BUFFER_LEN - 1)] = line[i];
     }
-    fnc_putchar('\n');
+    _tx[_tx_head++ & (TX_BUFFER_LEN - 1)] = '\n';
 
-    // Set acknowledgment timeout
-    _ack_time_limit = millis() + timeout_ms;
+    // Track it until it is acked or times out
+    uint8_t slot = (_pending_first + _pending_count) % MAX_PENDING_LINES;
+    _pending_len[slot] = len + 1;
+    _pending_deadline[slot] = millis() + timeout_ms;
+    _pending_bytes += len + 1;
+    if (_pending_count++ == 0) {
+        _ack_time_limit = _pending_deadline[slot];
+    }
     _ackwait = true;
+
+    tx_drain();
 }
 
+// Realtime chars skip the queue; FluidNC picks them out even mid-line
 void fnc_realtime(realtime_cmd_t c) {
     fnc_putchar((uint8_t)c);
 }
 
+// A jog cancel must not be followed by jog lines that were queued before
+// it, or they would start a new jog.  Lines that have not started to go
+// out are dropped; one that has is finished, and the cancel follows it.
+// Lines already sent cannot be dropped, so the cancel is owed again once
+// FluidNC has acked them.
+void fnc_jog_cancel() {
+    uint16_t keep = _tx_tail;
+    if (_tx_mid_line) {
+        while (keep != _tx_head && _tx[keep++ & (TX_BUFFER_LEN - 1)] != '\n') {}
+    }
+
+    // Forget the dropped lines, which are the newest pending ones
+    for (uint16_t i = keep; i != _tx_head; i++) {
+        if (_tx[i & (TX_BUFFER_LEN - 1)] == '\n' && _pending_count) {
+            _pending_count--;
+            _pending_bytes -= _pending_len[(_pending_first + _pending_count) % MAX_PENDING_LINES];
+        }
+    }
+    _ackwait = _pending_count > 0;
+    _tx_head = keep;
+
+    if (_tx_tail == _tx_head) {
+        fnc_realtime(JogCancel);
+    } else {
+        _tx[_tx_head++ & (TX_BUFFER_LEN - 1)] = JogCancel;
+        tx_drain();
+    }
+    _cancel_owed = _pending_count > 0 || _overdue > 0;
+}
+
 // Message parsing
 static void parse_state(const char* state) {
     show_state(state);
@@ -48,11 +169,21 @@ static void parse_report() {
 
     // Handle acknowledgment
     if (strcmp(_report, "ok") == 0) {
-        _ackwait = false;
+        ack_received();
         show_ok();
         return;
     }
 
+    // FluidNC has restarted and dropped its input, so no acks are coming
+    if (strncmp(_report, "Grbl ", 5) == 0) {
+        while (_pending_count) {
+            ack_pop();
+        }
+        _overdue = 0;
+        _cancel_owed = false;
+        return;
+    }
+
     // Check for READY message
     if (strcmp(_report, "READY") == 0) {
         _machine_ready = true;  // <-- Updated here when literal "READY" message is received
@@ -68,6 +199,16 @@ static void parse_report() {
             // If state is "Idle", consider machine ready
             if (strcmp(_report + 1, "Idle") == 0) {
                 _machine_ready = true;  // <-- Also updated here when Idle state is detected
+
+                // The ok for a line that ends in Idle, like $H, can follow
+                // the first Idle report, but not the second
+                if (_pending_count) {
+                    _idle_reports = 0;
+                } else if (++_idle_reports >= 2) {
+                    _overdue = 0;
+                }
+            } else {
+                _idle_reports = 0;
             }
             
             parse_state(_report + 1);  // Send state string to callback
@@ -83,7 +224,7 @@ static void parse_report() {
 
     // Handle errors
     if (strncmp(_report, "error:", 6) == 0) {
-        _ackwait = false;
+        ack_received();
         show_error(atoi(_report + 6));
         return;
     }
@@ -114,9 +255,18 @@ void collect(uint8_t data) {
 void fnc_poll() {
     static unsigned long last_status_request = 0;
     unsigned long now = millis();
-    
-    // Request status every 50ms if not waiting for ack
-    if (!_ackwait && (now - last_status_request >= 50)) {
+
+    tx_drain();
+
+    // Stop waiting for a line that was not acked in time, so the window
+    // does not stay closed
+    if (_pending_count && (long)(now - _pending_deadline[_pending_first]) >= 0) {
+        ack_expire();
+    }
+
+    // Request status every 50ms.  FluidNC takes ? even in the middle of a
+    // line, so pending lines do not hold it up.
+    if (now - last_status_request >= 50) {
         fnc_realtime(StatusReport);
         last_status_request = now;
     }
@@ -127,6 +277,13 @@ void fnc_poll() {
         if (c < 0) break;  // No more data
         collect(c);
     }
+
+    // Every line sent before the jog cancel has been parsed, so the jog
+    // they may have started can now be cancelled
+    if (_cancel_owed && _pending_count == 0 && _overdue == 0 && _tx_tail == _tx_head) {
+        fnc_realtime(JogCancel);
+        _cancel_owed = false;
+    }
 }
 
 void fnc_wait_ready() {
@@ -141,6 +298,7 @@ void fnc_wait_ready() {
             if (c >= 0) {
                 collect(c);
             }
+            show_waiting();
             delay(1);
         }
         
@@ -150,7 +308,10 @@ void fnc_wait_ready() {
         }
         
         if (!machine_ready) {
-            delay(100);
+            for (int i = 0; i < 100; i++) {
+                show_waiting();
+                delay(1);
+            }
         }
     }
 }
@@ -160,3 +321,4 @@ void __attribute__((weak)) show_state(const char* state) {}
 void __attribute__((weak)) show_error(int error) {}
 void __attribute__((weak)) show_alarm(int alarm) {}
 void __attribute__((weak)) show_ok() {}
+void __attribute__((weak)) show_waiting() {}
@@ -12,6 +12,14 @@ extern "C" {
 
 #define REPORT_BUFFER_LEN 128  // Reduced buffer size
 
+// Transmit pipelining.  Lines are queued in a ring that fnc_poll() drains
+// as fast as the UART takes them, so fnc_send_line() does not wait for the
+// bytes to go out.  Up to MAX_PENDING_LINES lines, and no more than
+// RX_WINDOW bytes of them, may be sent before FluidNC acks the first one.
+#define TX_BUFFER_LEN 64      // Must be a power of 2
+#define MAX_PENDING_LINES 4
+#define RX_WINDOW 128         // FluidNC's serial line buffer is larger; this keeps latency down
+
 // Axis definitions
 #define MAX_N_AXIS 6
 #define X_AXIS 0
@@ -65,10 +73,14 @@ void fnc_wait_ready();
 void fnc_poll();
 void fnc_send_line(const char* line, int timeout_ms);
 void fnc_realtime(realtime_cmd_t c);  // This now uses realtime_cmd_t from Realtime.h
+bool fnc_can_send(size_t len);        // True if a line of len chars can be queued without waiting
+int  fnc_pending();                   // Lines sent and not yet acked
+void fnc_jog_cancel();                // Jog cancel that also drops queued lines
 
 // Required implementations
 extern int fnc_getchar();
 extern void fnc_putchar(uint8_t ch);
+extern int fnc_tx_room();  // How many chars fnc_putchar() can take without blocking
 
 // Optional debug
 
@@ -77,10 +89,11 @@ extern void show_state(const char* state);
 extern void show_error(int error);
 extern void show_alarm(int alarm);
 extern void show_ok();
+extern void show_waiting();  // Called every ms while fnc_wait_ready() waits
 
 // Add these extern declarations
-extern bool _ackwait;
-extern int _ack_time_limit;
+extern bool _ackwait;        // Some line has not been acked
+extern int _ack_time_limit;  // When the oldest unacked line times out
 extern bool _alarm14;
 extern bool _machine_ready; // New flag to detect READY message
 
@@ -12,15 +12,14 @@ namespace LEDControl
     //---------------------------------------------------------------
     //              Static Member Initialization
     //---------------------------------------------------------------
-    // Color definitions - initialized in init()
-    uint32_t LedColors::COLOR_RED;
-    uint32_t LedColors::COLOR_GREEN;
-    uint32_t LedColors::COLOR_ORANGE;
-    uint32_t LedColors::COLOR_OFF;
-    uint32_t LedColors::Color1;
-    uint32_t LedColors::Color2;
-    uint32_t LedColors::Color3;
-    uint32_t LedColors::lastColor;
+    // Color definitions, for when one is used as an object
+    constexpr uint32_t LedColors::COLOR_RED;
+    constexpr uint32_t LedColors::COLOR_GREEN;
+    constexpr uint32_t LedColors::COLOR_ORANGE;
+    constexpr uint32_t LedColors::COLOR_OFF;
+    constexpr uint32_t LedColors::COLOR_AMBER;
+    constexpr uint32_t LedColors::COLOR_MAGENTA;
+    constexpr uint32_t LedColors::COLOR_CYAN;
 
     // Animation state variables
     // bool LedColors::inHomingMode = false; 
@@ -29,7 +28,6 @@ namespace LEDControl
     int8_t LedColors::fadeStep = 5;
     unsigned long LedColors::lastAnimationUpdate = 0;
     unsigned long LedColors::flickerTimer = 0;
-    unsigned long LedColors::previousMillis = 0;
     bool LedColors::isHomed = false;
     uint16_t LedColors::step = 0;
 
@@ -40,6 +38,17 @@ namespace LEDControl
     // NeoPixel reference
     Adafruit_NeoPixel *LedColors::pixelsPtr = nullptr;
 
+    // Animation engine
+    const LedColors::Keyframe *LedColors::frames = nullptr;
+    uint8_t LedColors::frameCount = 0;
+    int8_t LedColors::frameLoop = NO_LOOP;
+    uint8_t LedColors::frameIndex = 0;
+    unsigned long LedColors::frameStart = 0;
+    uint32_t LedColors::fromColors[NUM_PIXELS];
+    const LedColors::Keyframe *LedColors::nextFrames = nullptr;
+    uint8_t LedColors::nextCount = 0;
+    int8_t LedColors::nextLoop = NO_LOOP;
+
     /**
      * Interpolate between two colors by given step value
      * Used for smooth transitions between colors
@@ -65,11 +74,135 @@ namespace LEDControl
         return pixelsPtr->Color(r, g, b);
     }
 
+    //---------------------------------------------------------------
+    //                   Animation Engine
+    //---------------------------------------------------------------
+    void LedColors::play(const Keyframe *newFrames, uint8_t count, int8_t loopFrom)
+    {
+        for (int i = 0; i < NUM_PIXELS; i++)
+        {
+            fromColors[i] = pixelsPtr->getPixelColor(i);
+        }
+        frames = newFrames;
+        frameCount = count;
+        frameLoop = loopFrom;
+        frameIndex = 0;
+        frameStart = millis();
+        lastAnimationUpdate = frameStart - FRAME_INTERVAL_MS; // Draw on the next animate()
+    }
+
+    void LedColors::playLoop(const Keyframe *newFrames, uint8_t count, int8_t loopFrom)
+    {
+        if (frames == newFrames || nextFrames == newFrames)
+        {
+            return;
+        }
+        if (frames && frameLoop == NO_LOOP)
+        {
+            // Let the transition finish first
+            nextFrames = newFrames;
+            nextCount = count;
+            nextLoop = loopFrom;
+            return;
+        }
+        play(newFrames, count, loopFrom);
+    }
+
+    void LedColors::endLoop()
+    {
+        nextFrames = nullptr;
+        if (frames && frameLoop != NO_LOOP)
+        {
+            frames = nullptr;
+        }
+    }
+
+    /**
+     * How long a keyframe lasts.  One with no fade and no hold still takes
+     * 1 ms, so a loop of them cannot keep animate() from returning.
+     */
+    static unsigned long frameMs(const LedColors::Keyframe &frame)
+    {
+        unsigned long ms = (unsigned long)frame.fadeMs + frame.holdMs;
+        return ms ? ms : 1;
+    }
+
+    /**
+     * Advance the animation that is playing to the present time
+     * Keyframes whose time has passed are skipped over, so a late
+     * call catches up instead of slowing the animation down
+     */
+    bool LedColors::animate()
+    {
+        if (!frames)
+        {
+            return false;
+        }
+
+        unsigned long now = millis();
+        if (now - lastAnimationUpdate < FRAME_INTERVAL_MS)
+        {
+            return true;
+        }
+        lastAnimationUpdate = now;
+
+        // Move on to the keyframe that is current now
+        while (now - frameStart >= frameMs(frames[frameIndex]))
+        {
+            const Keyframe &done = frames[frameIndex];
+            frameStart += frameMs(done);
+            for (int i = 0; i < NUM_PIXELS; i++)
+            {
+                fromColors[i] = done.color;
+            }
+
+            if (++frameIndex == frameCount)
+            {
+                if (frameLoop != NO_LOOP)
+                {
+                    frameIndex = frameLoop;
+                }
+                else
+                {
+                    // Show the final color, then start what was waiting
+                    for (int i = 0; i < NUM_PIXELS; i++)
+                    {
+                        pixelsPtr->setPixelColor(i, done.color);
+                    }
+                    pixelsPtr->show();
+                    frames = nullptr;
+                    if (nextFrames)
+                    {
+                        play(nextFrames, nextCount, nextLoop);
+                        nextFrames = nullptr;
+                        return true;
+                    }
+                    return false;
+                }
+            }
+        }
+
+        const Keyframe &frame = frames[frameIndex];
+        unsigned long t = now - frameStart;
+        uint8_t p = t < frame.fadeMs ? (t * 255) / frame.fadeMs : 255;
+        for (int i = 0; i < NUM_PIXELS; i++)
+        {
+            pixelsPtr->setPixelColor(i, interpolateColor(fromColors[i], frame.color, p));
+        }
+        pixelsPtr->show();
+        return true;
+    }
+
     /**
-     * Initialize LED system and play startup animation
+     * Initialize LED system and start the startup animation
      */
     void LedColors::init(Adafruit_NeoPixel &pixels)
     {
+        // Fade from black to red, then hold red briefly
+        static const Keyframe startup[] = {
+            {COLOR_RED, 86 * TRANSITION_INTERVAL, HOLD_TIME},
+        };
+
         // Store reference to NeoPixel object
         pixelsPtr = &pixels;
 
@@ -79,55 +212,11 @@ namespace LEDControl
         pixels.clear();
         pixels.show();
 
-        // Define standard colors
-        COLOR_RED = pixels.Color(255, 0, 0);      // Full red
-        COLOR_GREEN = pixels.Color(0, 255, 0);    // Full green
-        COLOR_ORANGE = pixels.Color(255, 100, 0); // Bright orange
-        COLOR_OFF = pixels.Color(0, 0, 0);        // Off
-
-        // Define animation colors
-        Color1 = pixels.Color(255, 165, 0); // Orange
-        Color2 = pixels.Color(255, 0, 255); // Magenta
-        Color3 = pixels.Color(0, 255, 255); // Cyan
-
         // Run startup animation only once
         if (!initAnimationComplete)
         {
-            // Phase 1: Fade from black to red
-            for (int j = 0; j <= 255; j += 3)
-            {
-                uint32_t interpolatedColor = interpolateColor(COLOR_OFF, COLOR_RED, j);
-                for (int i = 0; i < NUM_PIXELS; i++)
-                {
-                    pixelsPtr->setPixelColor(i, interpolatedColor);
-                }
-                pixelsPtr->show();
-                delay(TRANSITION_INTERVAL);
-            }
-            delay(HOLD_TIME); // Hold red briefly
-
-            // // Phase 2: Transition from red to orange
-            // for (int j = 0; j <= 255; j += 3)
-            // {
-            //     uint32_t interpolatedColor = interpolateColor(COLOR_RED, Color1, j);
-            //     for (int i = 0; i < NUM_PIXELS; i++)
-            //     {
-            //         pixelsPtr->setPixelColor(i, interpolatedColor);
-            //     }
-            //     pixelsPtr->show();
-            //     delay(TRANSITION_INTERVAL);
-            // }
-            // delay(HOLD_TIME); // Hold orange briefly
-
-            // // Set first homing color to ensure smooth transition to homing animation
-            // for (int i = 0; i < NUM_PIXELS; i++)
-            // {
-            //     pixelsPtr->setPixelColor(i, Color1);
-            // }
-            // pixelsPtr->show();
-            // lastColor = Color1;
-
-            initAnimationComplete = true; // Mark as complete
+            play(startup, 1);
+            initAnimationComplete = true; // Mark as started
         }
         // Don't clear LEDs - let homing animation take over seamlessly
     }
@@ -138,91 +227,18 @@ namespace LEDControl
      */
     void LedColors::homingAnimation()
     {
-        // Static variables maintain state between calls
-        static uint8_t currentColor = 1;     // Current color in the cycle (1-3)
-        static bool isTransitioning = false; // Whether we're between colors
-        static uint16_t transitionStep = 0;  // Current step in transition (0-255)
+        // Fade orange -> magenta -> cyan -> orange, holding each color
+        static const Keyframe homing[] = {
+            {COLOR_MAGENTA, 86 * TRANSITION_INTERVAL, HOLD_TIME},
+            {COLOR_CYAN, 86 * TRANSITION_INTERVAL, HOLD_TIME},
+            {COLOR_AMBER, 86 * TRANSITION_INTERVAL, HOLD_TIME},
+        };
 
         // Only run if we're in HOMING state and not already homed
         if (currentState != HOMING || isHomed)
             return;
 
-        // Time-based animation
-        unsigned long currentMillis = millis();
-        if (currentMillis - previousMillis >= TRANSITION_INTERVAL)
-        {
-            previousMillis = currentMillis;
-
-            if (isTransitioning)
-            {
-                // Transitioning between colors
-                uint32_t fromColor, toColor;
-
-                // Select source and target colors based on current position
-                switch (currentColor)
-                {
-                case 1: // Orange to Magenta
-                    fromColor = Color1;
-                    toColor = Color2;
-                    break;
-                case 2: // Magenta to Cyan
-                    fromColor = Color2;
-                    toColor = Color3;
-                    break;
-                default: // Cyan back to Orange
-                    fromColor = Color3;
-                    toColor = Color1;
-                    break;
-                }
-
-                // Calculate intermediate color and update all LEDs
-                uint32_t interpolatedColor = interpolateColor(fromColor, toColor, transitionStep);
-                for (int i = 0; i < NUM_PIXELS; i++)
-                {
-                    pixelsPtr->setPixelColor(i, interpolatedColor);
-                }
-                pixelsPtr->show();
-
-                // Increment step and check for completion
-                transitionStep += 3;
-                if (transitionStep > 255)
-                {
-                    // Transition complete, move to next solid color
-                    transitionStep = 0;
-                    isTransitioning = false;
-                    currentColor = (currentColor >= 3) ? 1 : currentColor + 1;
-                    delay(HOLD_TIME); // Hold at target color
-                }
-            }
-            else
-            {
-                // Display solid color before starting next transition
-                uint32_t solidColor;
-                switch (currentColor)
-                {
-                case 1:
-                    solidColor = Color1;
-                    break; // Orange
-                case 2:
-                    solidColor = Color2;
-                    break; // Magenta
-                default:
-                    solidColor = Color3;
-                    break; // Cyan
-                }
-
-                // Set all LEDs to solid color
-                for (int i = 0; i < NUM_PIXELS; i++)
-                {
-                    pixelsPtr->setPixelColor(i, solidColor);
-                }
-                pixelsPtr->show();
-                isTransitioning = true; // Begin transition on next update
-            }
-
-            // Store current color for future transitions
-            lastColor = pixelsPtr->getPixelColor(0);
-        }
+        playLoop(homing, 3, 0);
     }
 
     /**
@@ -319,43 +335,21 @@ namespace LEDControl
      */
     void LedColors::transitionToGreen()
     {
+        // Fade to green, pause, then blink 3 times to confirm completion
+        static const Keyframe toGreen[] = {
+            {COLOR_GREEN, 512, 800},
+            {COLOR_OFF, 0, 200},
+            {COLOR_GREEN, 0, 200},
+            {COLOR_OFF, 0, 200},
+            {COLOR_GREEN, 0, 200},
+            {COLOR_OFF, 0, 200},
+            {COLOR_GREEN, 0, 200},
+        };
+
         // Set homed flag to prevent re-entry and stop homing animation
         isHomed = true;
-
-        // Phase 1: Smooth transition to green
-        for (int j = 0; j <= 255; j++)
-        {
-            uint32_t interpolatedColor = interpolateColor(lastColor, COLOR_GREEN, j);
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                pixelsPtr->setPixelColor(i, interpolatedColor);
-            }
-            pixelsPtr->show();
-            delay(2); // Fast but smooth transition
-        }
-
-        // Pause at green before blinking
-        delay(800);
-
-        // Phase 2: Blink green 3 times to confirm completion
-        for (int blinkCount = 0; blinkCount < 3; blinkCount++)
-        {
-            // Off phase
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                pixelsPtr->setPixelColor(i, COLOR_OFF);
-            }
-            pixelsPtr->show();
-            delay(200);
-
-            // On phase
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                pixelsPtr->setPixelColor(i, COLOR_GREEN);
-            }
-            pixelsPtr->show();
-            delay(200);
-        }
+        endLoop();
+        play(toGreen, sizeof(toGreen) / sizeof(toGreen[0]));
     }
 
     /**
@@ -364,47 +358,16 @@ namespace LEDControl
      */
     void LedColors::transitionToOrange()
     {
-        // Capture current LED colors for smooth transition
-        uint32_t currentColors[NUM_PIXELS];
-        for (int i = 0; i < NUM_PIXELS; i++)
-        {
-            currentColors[i] = pixelsPtr->getPixelColor(i);
-        }
-
-        // Phase 1: Smooth transition to orange
-        for (int j = 0; j <= 255; j += 3)
-        {
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                uint32_t interpolatedColor = interpolateColor(currentColors[i], COLOR_ORANGE, j);
-                pixelsPtr->setPixelColor(i, interpolatedColor);
-            }
-            pixelsPtr->show();
-            delay(2);
-        }
-
-        // Brief pause at orange
-        delay(200);
-
-        // Phase 2: Flash orange twice to indicate action
-        for (int flash = 0; flash < 2; flash++)
-        {
-            // Off phase
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                pixelsPtr->setPixelColor(i, COLOR_OFF);
-            }
-            pixelsPtr->show();
-            delay(150);
-
-            // On phase
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                pixelsPtr->setPixelColor(i, COLOR_ORANGE);
-            }
-            pixelsPtr->show();
-            delay(150);
-        }
+        // Fade each LED to orange, pause, then flash twice to indicate action
+        static const Keyframe toOrange[] = {
+            {COLOR_ORANGE, 170, 200},
+            {COLOR_OFF, 0, 150},
+            {COLOR_ORANGE, 0, 150},
+            {COLOR_OFF, 0, 150},
+            {COLOR_ORANGE, 0, 150},
+        };
+
+        play(toOrange, sizeof(toOrange) / sizeof(toOrange[0]));
     }
 
     /**
@@ -413,108 +376,32 @@ namespace LEDControl
      */
     void LedColors::breathingRedAnimation()
     {
-        // Static variables for animation state
-        static unsigned long lastUpdate = 0;
-        static uint8_t brightness = 255; // Start from FULL brightness (255)
-        static int8_t step = -2; // Faster initial fade-down step
-        static bool initialized = false;
-        static bool initialFadeDone = false; // Tracks completion of initial fade to DEFAULT_BRIGHTNESS
-        
-        // Initialize on first call
-        if (!initialized) {
-            // Set all LEDs to red with FULL brightness
-            uint32_t startRed = pixelsPtr->Color(255, 0, 0);
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                pixelsPtr->setPixelColor(i, startRed);
-            }
-            pixelsPtr->show();
-            lastColor = startRed;
-            initialized = true;
-        }
-        
-        // Time-based breathing effect
-        unsigned long currentMillis = millis();
-        if (currentMillis - lastUpdate >= 10) { // Update every 10ms for smooth breathing
-            lastUpdate = currentMillis;
-
-            // First phase: Initial fade from full brightness to DEFAULT_BRIGHTNESS
-            if (!initialFadeDone) {
-                // Update brightness with faster step for initial fade
-                brightness += step;
-                
-                // When we reach DEFAULT_BRIGHTNESS, switch to regular breathing
-                if (brightness <= DEFAULT_BRIGHTNESS) {
-                    brightness = DEFAULT_BRIGHTNESS;
-                    initialFadeDone = true;
-                    step = -1; // Switch to regular step size for breathing
-                }
-            }
-            // Second phase: Regular breathing animation between DEFAULT_BRIGHTNESS and minimum
-            else {
-                // Update brightness with direction
-                brightness += step;
-                
-                // Reverse direction at limits with some delay at max/min
-                if (brightness >= DEFAULT_BRIGHTNESS) { // Cap maximum brightness at DEFAULT_BRIGHTNESS
-                    brightness = DEFAULT_BRIGHTNESS;
-                    step = -step;
-                } else if (brightness <= 5) { // Keep a minimum glow
-                    brightness = 5;
-                    step = -step;
-                }
-            }
-
-            // Apply brightness to create the red glow
-            uint32_t dimRed = pixelsPtr->Color(brightness, 0, 0);
-            
-            // Apply to all LEDs
-            for (int i = 0; i < NUM_PIXELS; i++) {
-                pixelsPtr->setPixelColor(i, dimRed);
-            }
-            pixelsPtr->show();
-            
-            // Store last color for future transitions
-            lastColor = dimRed;
-        }
+        // Fade from full red down to DEFAULT_BRIGHTNESS, then breathe
+        // between there and a minimum glow
+        static const Keyframe breathing[] = {
+            {COLOR_RED, 0, 0},
+            {rgb(DEFAULT_BRIGHTNESS, 0, 0), (255 - DEFAULT_BRIGHTNESS) / 2 * 10, 0},
+            {rgb(5, 0, 0), (DEFAULT_BRIGHTNESS - 5) * 10, 0},
+            {rgb(DEFAULT_BRIGHTNESS, 0, 0), (DEFAULT_BRIGHTNESS - 5) * 10, 0},
+        };
+
+        playLoop(breathing, 4, 2);
     }
 
     /**
      * Transition from breathing red to homing animation start color
-     * Creates a smooth transition from current red to Color1 (orange)
+     * Creates a smooth transition from current red to COLOR_AMBER
      */
     void LedColors::transitionToHoming()
     {
-        // Capture current red color (from breathing animation)
-        uint32_t startColor = lastColor;
-        
-        // Smoothly transition to Color1 (orange)
-        for (int j = 0; j <= 255; j += 3)
-        {
-            uint32_t interpolatedColor = interpolateColor(startColor, Color1, j);
-            for (int i = 0; i < NUM_PIXELS; i++)
-            {
-                pixelsPtr->setPixelColor(i, interpolatedColor);
-            }
-            pixelsPtr->show();
-            delay(2); // Fast but smooth transition
-        }
-        
-        // Brief flash to indicate homing is starting
-        for (int i = 0; i < NUM_PIXELS; i++)
-        {
-            pixelsPtr->setPixelColor(i, COLOR_OFF);
-        }
-        pixelsPtr->show();
-        delay(100);
-        
-        // Set all LEDs to Color1 (first color of homing sequence)
-        for (int i = 0; i < NUM_PIXELS; i++)
-        {
-            pixelsPtr->setPixelColor(i, Color1);
-        }
-        pixelsPtr->show();
-        
-        // Make sure lastColor is updated
-        lastColor = Color1;
+        // Fade to orange, then a brief flash to indicate homing is starting
+        static const Keyframe toHoming[] = {
+            {COLOR_AMBER, 170, 0},
+            {COLOR_OFF, 0, 100},
+            {COLOR_AMBER, 0, 0},
+        };
+
+        endLoop();
+        play(toHoming, sizeof(toHoming) / sizeof(toHoming[0]));
     }
 }
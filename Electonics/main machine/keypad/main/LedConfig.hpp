@@ -9,6 +9,14 @@
  */
 namespace LEDControl
 {
+    /**
+     * Packs a color the way Adafruit_NeoPixel::Color() does, for tables
+     */
+    constexpr uint32_t rgb(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
     /**
      * LedColors class handles LED animations and color transitions
      * for different machine states (idle, running, paused, etc)
@@ -57,6 +65,47 @@ namespace LEDControl
         static uint32_t interpolateColor(uint32_t color1, uint32_t color2, uint16_t step);
 
     public:
+        //---------------------------------------------------------------
+        // Animation Engine
+        //---------------------------------------------------------------
+        // Animations are tables of keyframes that animate() plays a little
+        // at a time from loop(), so nothing waits for an animation to end.
+        // A one-shot animation (a transition) starts at once; a looping one
+        // (a state animation) waits for a one-shot that is playing to end.
+
+        struct Keyframe
+        {
+            uint32_t color;  // Shown on all LEDs
+            uint16_t fadeMs; // Fade from the previous colors over this long
+            uint16_t holdMs; // Then hold it this long; with no fade either, 1 ms
+        };
+        static const int8_t NO_LOOP = -1;
+
+        /**
+         * Starts a one-shot animation, or a looping one at once
+         * @param frames Keyframe table, fading from the colors now showing
+         * @param count Number of keyframes
+         * @param loopFrom Keyframe to go back to after the last, or NO_LOOP
+         */
+        static void play(const Keyframe *frames, uint8_t count, int8_t loopFrom = NO_LOOP);
+
+        /**
+         * Starts a looping animation after any one-shot that is playing.
+         * Does nothing if it is already playing or queued.
+         */
+        static void playLoop(const Keyframe *frames, uint8_t count, int8_t loopFrom);
+
+        /**
+         * Ends a looping animation, playing or queued.  A one-shot finishes.
+         */
+        static void endLoop();
+
+        /**
+         * Advances the animation; call often, as from loop()
+         * @return True while an animation owns the LEDs
+         */
+        static bool animate();
+
         // Add missing static member declaration
         static bool initAnimationComplete; // Tracks if startup animation has run
 
@@ -98,6 +147,7 @@ namespace LEDControl
         // Animation Timing Constants
         //---------------------------------------------------------------
         static const uint16_t TRANSITION_DURATION = 300;   // Duration for state transitions (ms)
+        static const uint16_t FRAME_INTERVAL_MS = 10;      // Fastest animation update rate (ms)
         static const uint16_t BLINK_INTERVAL_MS = 333;     // Blink speed for alarm state (ms)
         static const uint16_t FADE_INTERVAL_MS = 10;       // Speed of fade animation (ms)
         static const uint16_t HOMING_UPDATE_INTERVAL = 25; // Update rate for homing animation (ms)
@@ -107,15 +157,14 @@ namespace LEDControl
         //---------------------------------------------------------------
         // Color Definitions
         //---------------------------------------------------------------
-        static uint32_t COLOR_RED;    // Red color for alarm states
-        static uint32_t COLOR_GREEN;  // Green color for idle state
-        static uint32_t COLOR_ORANGE; // Orange color for running state
-        static uint32_t COLOR_OFF;    // LEDs off
-        // Animation colors
-        static uint32_t Color1;    // Orange
-        static uint32_t Color2;    // Magenta
-        static uint32_t Color3;    // Cyan
-        static uint32_t lastColor; // Tracks last displayed color for transitions
+        static constexpr uint32_t COLOR_RED = rgb(255, 0, 0);      // Red color for alarm states
+        static constexpr uint32_t COLOR_GREEN = rgb(0, 255, 0);    // Green color for idle state
+        static constexpr uint32_t COLOR_ORANGE = rgb(255, 100, 0); // Orange color for running state
+        static constexpr uint32_t COLOR_OFF = rgb(0, 0, 0);        // LEDs off
+        // Homing animation colors
+        static constexpr uint32_t COLOR_AMBER = rgb(255, 165, 0); // Homing starts and ends on it
+        static constexpr uint32_t COLOR_MAGENTA = rgb(255, 0, 255);
+        static constexpr uint32_t COLOR_CYAN = rgb(0, 255, 255);
 
         //---------------------------------------------------------------
         // Animation State Variables
@@ -125,9 +174,19 @@ namespace LEDControl
         static int8_t fadeStep;                   // Direction and amount of fade steps
         static unsigned long lastAnimationUpdate; // Timing for animation updates
         static unsigned long flickerTimer;        // Timing for flicker effects
-        static unsigned long previousMillis;      // Previous millis for time-based animations
         static uint16_t step;                     // Current step in animations
 
+        // Animation engine state
+        static const Keyframe *frames;      // Playing animation, or nullptr
+        static uint8_t frameCount;
+        static int8_t frameLoop;            // Where it loops back to, or NO_LOOP
+        static uint8_t frameIndex;          // Keyframe now playing
+        static unsigned long frameStart;    // When that keyframe started
+        static uint32_t fromColors[];       // Colors the keyframe fades from
+        static const Keyframe *nextFrames;  // Looping animation to play next, or nullptr
+        static uint8_t nextCount;
+        static int8_t nextLoop;
+
         // State flags
         static bool inHomingMode; // Whether we're in homing mode
         static bool isHomed;      // Whether homing is complete
@@ -136,13 +195,13 @@ namespace LEDControl
         // Public Functions
         //---------------------------------------------------------------
         /**
-         * Initialize the LED controller
+         * Initialize the LED controller and start the startup animation
          * @param pixels Reference to NeoPixel object
          */
         static void init(Adafruit_NeoPixel &pixels);
 
         /**
-         * Animation for homing state - cycles through colors
+         * Animation for homing state - cycles through colors until homed
          */
         static void homingAnimation();
 
@@ -176,13 +235,13 @@ namespace LEDControl
 
         /**
          * Breathing red animation during startup
-         * Used while waiting for alarm detection
+         * Used while waiting for alarm detection; runs until endLoop()
          */
         static void breathingRedAnimation();
 
         /**
          * Transition from breathing red animation to homing animation
-         * Creates a smooth transition from red to orange (Color1)
+         * Creates a smooth transition from red to COLOR_AMBER
          */
         static void transitionToHoming();
     };
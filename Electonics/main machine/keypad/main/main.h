@@ -10,7 +10,13 @@
 
 // Jog distances
 #define SHORT_JOG_DISTANCE 1 // mm
-#define LONG_JOG_DISTANCE 1000 // mm
+
+// Continuous jogging.  While a button is held, jog segments of
+// JOG_SEGMENT_MS worth of motion are sent so that about JOG_LEAD_MS of
+// motion is always planned ahead - enough to accelerate to full speed,
+// little enough that JogCancel on release has almost nothing to discard.
+#define JOG_SEGMENT_MS 40
+#define JOG_LEAD_MS 160
 
 // Button timing
 #define BUTTON_HOLD_DELAY 750    // ms - reduced from original if needed
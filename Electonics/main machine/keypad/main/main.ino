@@ -20,9 +20,12 @@
 
 // Forward declarations
 struct ButtonState;
+struct JogButton;
 void updateButtonState(ButtonState &btn, bool currentRead);
 void handleButtons();
+void handleJogButton(JogButton &jog);
 void updateLEDs();
+void pollFor(unsigned long ms);
 
 //---------------------------------------------------------------
 //                      Configuration
@@ -74,12 +77,20 @@ int fnc_getchar()
 }
 
 /**
- * Send a character to serial with a small delay
+ * Send a character to serial.  GrblParserC only sends as many as
+ * fnc_tx_room() allows, so this does not block.
  */
 void fnc_putchar(uint8_t ch)
 {
     Serial.write(ch);
-    delay(1); // Small delay to ensure reliable transmission
+}
+
+/**
+ * Space left in the serial transmit buffer
+ */
+int fnc_tx_room()
+{
+    return Serial.availableForWrite();
 }
 
 //---------------------------------------------------------------
@@ -104,6 +115,22 @@ ButtonState downButton;
 ButtonState leftButton;
 ButtonState playPauseButton;
 
+// Direction buttons and the jog each one makes
+struct JogButton
+{
+    ButtonState &button;
+    char axis;
+    bool negative;
+    uint32_t streamStart; // When the current hold started streaming
+    uint32_t queuedMs;    // Motion sent during the hold, in ms from streamStart
+};
+JogButton jogButtons[] = {
+    {upButton, 'Y', false, 0, 0},
+    {rightButton, 'X', false, 0, 0},
+    {downButton, 'Y', true, 0, 0},
+    {leftButton, 'X', true, 0, 0},
+};
+
 //---------------------------------------------------------------
 //                          Setup
 //---------------------------------------------------------------
@@ -119,14 +146,14 @@ void waitForMachineReady()
     // Request status report
     fnc_realtime(StatusReport);
     
-    // Keep running breathing animation while waiting
+    // Show breathing red animation during this waiting phase
+    LEDControl::LedColors::breathingRedAnimation();
     unsigned long lastStatusRequest = 0;
     
     // Wait until machine leaves ALARM state (e.g., starts homing)
     while (machineState == ALARM)
     {
-        // Show breathing red animation during this waiting phase
-        LEDControl::LedColors::breathingRedAnimation();
+        LEDControl::LedColors::animate();
         
         // Request status periodically
         unsigned long currentTime = millis();
@@ -170,7 +197,7 @@ void setup()
     fnc_wait_ready();
     // Set a more frequent status report interval
     fnc_send_line("$Report/Interval=50", 100);
-    delay(200);
+    pollFor(200);
     
     // Reset _machine_ready flag before waiting for it
     _machine_ready = false;
@@ -182,7 +209,7 @@ void setup()
     LEDControl::LedColors::transitionToHoming();
     
     // Send homing command with delay to ensure it's sent properly
-    delay(100); // Make sure any previous commands have been processed
+    pollFor(100); // Make sure any previous commands have been processed
     Serial.flush(); // Flush any pending serial data
     
     // Update state to HOMING - this will trigger the homing animation
@@ -191,6 +218,28 @@ void setup()
     LEDControl::LedColors::updateMachineState(LEDControl::LedColors::HOMING);
 }
 
+/**
+ * Wait without stopping serial processing or LED animation
+ * @param ms How long to wait
+ */
+void pollFor(unsigned long ms)
+{
+    unsigned long start = millis();
+    while (millis() - start < ms)
+    {
+        fnc_poll();
+        LEDControl::LedColors::animate();
+    }
+}
+
+/**
+ * Keeps the startup animation going while fnc_wait_ready() waits
+ */
+void show_waiting()
+{
+    LEDControl::LedColors::animate();
+}
+
 //---------------------------------------------------------------
 //                          Main Loop
 //---------------------------------------------------------------
@@ -258,15 +307,16 @@ void updateButtonState(ButtonState &btn, bool currentRead)
                     btn.longPressCommandSent = true;
                 }
                 
+                // Stop a continuous jog when its button is released.  A short
+                // press jog is left to finish.
+                if (!isPlayPauseButton && btn.isHeld)
+                {
+                    fnc_jog_cancel();
+                }
+
                 // Reset button state
                 btn.isHeld = false;
                 btn.isPressed = false;
-                
-                // Cancel jogging when direction buttons are released
-                if (!isPlayPauseButton)
-                {
-                    fnc_realtime(JogCancel);
-                }
             }
         }
 
@@ -353,99 +403,59 @@ void handleButtons()
     //---------------------------------------------------------------
     if (machineState != PAUSED)
     {
-        static uint32_t lastJogTime = 0;
-        char jogCommand[32];
-
-        // Add a small delay between jogs to prevent overwhelming the machine
-        if ((millis() - lastJogTime) > 50)
-        { // 50ms minimum between jogs
-            
-            // Handle directional buttons for jogging
-            // Each one follows the same pattern:
-            // 1. Check if button is pressed (short press) or held (long press)
-            // 2. Send appropriate jog command
-            // 3. Reset flags to prevent repeated commands
-            // 4. Update lastJogTime to enforce minimum interval between commands
-
-            // UP button
-            if (upButton.isPressed && !upButton.isHeld && !upButton.longPressCommandSent)
-            {
-                // Short press - jog a short distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 Y%d F%d",
-                         SHORT_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                upButton.isPressed = false;
-                lastJogTime = millis();
-            }
-            else if (upButton.isHeld && !upButton.longPressCommandSent)
-            {
-                // Long press - jog a longer distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 Y%d F%d",
-                         LONG_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                upButton.longPressCommandSent = true;
-                lastJogTime = millis();
-            }
+        for (JogButton &jog : jogButtons)
+        {
+            handleJogButton(jog);
+        }
+    }
+}
 
-            // RIGHT button
-            if (rightButton.isPressed && !rightButton.isHeld && !rightButton.longPressCommandSent)
-            {
-                // Short press - jog a short distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 X%d F%d",
-                         SHORT_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                rightButton.isPressed = false;
-                lastJogTime = millis();
-            }
-            else if (rightButton.isHeld && !rightButton.longPressCommandSent)
-            {
-                // Long press - jog a longer distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 X%d F%d",
-                         LONG_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                rightButton.longPressCommandSent = true;
-                lastJogTime = millis();
-            }
+/**
+ * Jog for one direction button: a short press moves SHORT_JOG_DISTANCE,
+ * a hold streams segments until the button is released
+ * @param jog Jog button reference
+ */
+void handleJogButton(JogButton &jog)
+{
+    ButtonState &btn = jog.button;
+    char jogCommand[32];
 
-            // DOWN button
-            if (downButton.isPressed && !downButton.isHeld && !downButton.longPressCommandSent)
-            {
-                // Short press - jog a short distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 Y-%d F%d",
-                         SHORT_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                downButton.isPressed = false;
-                lastJogTime = millis();
-            }
-            else if (downButton.isHeld && !downButton.longPressCommandSent)
-            {
-                // Long press - jog a longer distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 Y-%d F%d",
-                         LONG_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                downButton.longPressCommandSent = true;
-                lastJogTime = millis();
-            }
+    if (btn.isPressed && !btn.isHeld && !btn.longPressCommandSent)
+    {
+        // Short press - jog a short distance
+        snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 %c%s%d F%d",
+                 jog.axis, jog.negative ? "-" : "", SHORT_JOG_DISTANCE, JOG_FEEDRATE);
+        fnc_send_line(jogCommand, 100);
+        btn.isPressed = false;
+    }
+    else if (btn.isHeld)
+    {
+        uint32_t now = millis();
+        if (!btn.longPressCommandSent)
+        {
+            // Hold started
+            btn.longPressCommandSent = true;
+            jog.streamStart = now;
+            jog.queuedMs = 0;
+        }
 
-            // LEFT button
-            if (leftButton.isPressed && !leftButton.isHeld && !leftButton.longPressCommandSent)
-            {
-                // Short press - jog a short distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 X-%d F%d",
-                         SHORT_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                leftButton.isPressed = false;
-                lastJogTime = millis();
-            }
-            else if (leftButton.isHeld && !leftButton.longPressCommandSent)
-            {
-                // Long press - jog a longer distance
-                snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 X-%d F%d",
-                         LONG_JOG_DISTANCE, JOG_FEEDRATE);
-                fnc_send_line(jogCommand, 100);
-                leftButton.longPressCommandSent = true;
-                lastJogTime = millis();
-            }
+        // Keep JOG_LEAD_MS of motion queued.  If sending fell behind, the
+        // machine has slowed down, so catch up from now rather than
+        // sending a burst to make up the difference.
+        uint32_t elapsed = now - jog.streamStart;
+        if (jog.queuedMs < elapsed)
+        {
+            jog.queuedMs = elapsed;
+        }
+
+        // Segment length in microns: mm/min * ms / 60
+        const long segment = (long)JOG_FEEDRATE * JOG_SEGMENT_MS / 60;
+        snprintf(jogCommand, sizeof(jogCommand), "$J=G91 G21 %c%s%ld.%03ld F%d",
+                 jog.axis, jog.negative ? "-" : "", segment / 1000, segment % 1000, JOG_FEEDRATE);
+        while (jog.queuedMs < elapsed + JOG_LEAD_MS && fnc_can_send(strlen(jogCommand)))
+        {
+            fnc_send_line(jogCommand, 100);
+            jog.queuedMs += JOG_SEGMENT_MS;
         }
     }
 }
@@ -458,11 +468,24 @@ void handleButtons()
  */
 void updateLEDs()
 {
+    // Looping animations belong to a state.  The breathing red of startup
+    // plays in ALARM state, until homing starts.
     if (machineState == HOMING)
     {
         LEDControl::LedColors::homingAnimation();
     }
-    else if (machineState == IDLE)
+    else if (machineState != ALARM)
+    {
+        LEDControl::LedColors::endLoop();
+    }
+
+    // Transitions and looping animations draw the LEDs themselves
+    if (LEDControl::LedColors::animate())
+    {
+        return;
+    }
+
+    if (machineState == IDLE)
     {
         if (!justFinishedHoming)
         {
@@ -0,0 +1,12 @@
+// Host stand-in for the parts of the Arduino API that GrblParserC uses.
+// The test drives the clock itself.
+#pragma once
+
+extern unsigned long test_now;
+
+static inline unsigned long millis() {
+    return test_now;
+}
+static inline void delay(unsigned long ms) {
+    test_now += ms;
+}
@@ -0,0 +1,300 @@
+// Host test of GrblParserC: replays captured FluidNC output and checks the
+// callbacks and the transmit pipelining, without keypad hardware.
+//
+//   cc -std=c99 -Wall -I. -I../main -o test_GrblParserC test_GrblParserC.c ../main/GrblParserC.c
+//   ./test_GrblParserC fluidnc_capture.txt
+
+#include "GrblParserC.h"
+
+#include <stdio.h>
+#include <string.h>
+
+unsigned long test_now = 0;
+
+// The fake UART: sent bytes land in tx_log, received bytes come from rx
+static char        tx_log[1024];
+static size_t      tx_len  = 0;
+static int         tx_room = 1000;
+static const char* rx      = "";
+
+int fnc_getchar() {
+    return *rx ? (uint8_t)*rx++ : -1;
+}
+void fnc_putchar(uint8_t ch) {
+    if (tx_room > 0) {
+        tx_room--;
+    }
+    if (tx_len < sizeof(tx_log) - 1) {
+        tx_log[tx_len++] = ch;
+        tx_log[tx_len]   = '\0';
+    }
+}
+int fnc_tx_room() {
+    return tx_room;
+}
+
+// What the callbacks saw, in order
+static char events[1024];
+static void event(const char* fmt, int n) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), fmt, n);
+    strncat(events, buf, sizeof(events) - strlen(events) - 1);
+}
+void show_state(const char* state) {
+    strncat(events, state, sizeof(events) - strlen(events) - 1);
+    event(" ", 0);
+}
+void show_error(int error) {
+    event("error%d ", error);
+}
+void show_alarm(int alarm) {
+    event("alarm%d ", alarm);
+}
+void show_ok() {
+    event("ok ", 0);
+}
+
+static int failures = 0;
+#define CHECK(cond)                                                 \
+    do {                                                            \
+        if (!(cond)) {                                              \
+            printf("%s:%d: FAILED %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                             \
+        }                                                           \
+    } while (0)
+
+static void reset_tx() {
+    tx_len    = 0;
+    tx_log[0] = '\0';
+}
+
+// Times out whatever is pending and lets two Idle reports clear the acks
+// still owed, so a test starts from an empty window
+static void settle() {
+    while (fnc_pending()) {
+        test_now += 200;
+        fnc_poll();
+    }
+    rx = "<Idle|MPos:0.000,0.000,0.000|FS:0,0>\n<Idle|MPos:0.000,0.000,0.000|FS:0,0>\n";
+    fnc_poll();
+}
+
+// Feeds input a line at a time with the clock moving, as the UART would
+static void replay(const char* capture) {
+    static char buf[4096];
+    strncpy(buf, capture, sizeof(buf) - 1);
+    for (char* line = strtok(buf, "\n"); line; line = strtok(NULL, "\n")) {
+        char with_nl[160];
+        snprintf(with_nl, sizeof(with_nl), "%s\r\n", line);
+        rx = with_nl;
+        fnc_poll();
+        test_now += 5;
+    }
+}
+
+static void test_capture(const char* path) {
+    static char capture[4096];
+    FILE*       f = fopen(path, "r");
+    if (!f) {
+        printf("cannot open %s\n", path);
+        failures++;
+        return;
+    }
+    size_t n   = fread(capture, 1, sizeof(capture) - 1, f);
+    capture[n] = '\0';
+    fclose(f);
+
+    events[0]      = '\0';
+    _machine_ready = false;
+    replay(capture);
+
+    CHECK(_machine_ready);
+    CHECK(!strcmp(events,
+                  "Alarm ok Alarm alarm14 ok Home Home Idle ok ok Jog error15 Jog ok Idle Run Hold:0 Idle "));
+}
+
+static void test_pipelining() {
+    // Reset the window from any earlier test
+    while (fnc_pending()) {
+        rx = "ok\n";
+        fnc_poll();
+    }
+    reset_tx();
+    tx_room = 1000;
+
+    // Lines go out at once, without waiting for acks, up to the window
+    const char* jog = "$J=G91 G21 X1 F10000";  // 20 chars + newline
+    for (int i = 0; i < MAX_PENDING_LINES; i++) {
+        CHECK(fnc_can_send(strlen(jog)));
+        unsigned long before = test_now;
+        fnc_send_line(jog, 100);
+        CHECK(test_now == before);  // Did not wait
+    }
+    CHECK(fnc_pending() == MAX_PENDING_LINES);
+    CHECK(tx_len == MAX_PENDING_LINES * (strlen(jog) + 1));
+    CHECK(!fnc_can_send(strlen(jog)));
+
+    // Each ack opens the window by one line
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(fnc_pending() == MAX_PENDING_LINES - 1);
+    CHECK(fnc_can_send(strlen(jog)));
+
+    // A line the UART cannot take yet stays queued until there is room
+    reset_tx();
+    tx_room = 5;
+    fnc_send_line("G0 X10", 100);
+    CHECK(!strcmp(tx_log, "G0 X1"));
+    tx_room = 100;
+    rx      = "";
+    fnc_poll();
+    CHECK(!strncmp(tx_log, "G0 X10\n", 7));
+
+    // Unacked lines time out and free the window
+    test_now += 200;
+    for (int i = 0; i < MAX_PENDING_LINES; i++) {
+        fnc_poll();
+    }
+    CHECK(fnc_pending() == 0);
+    CHECK(!_ackwait);
+}
+
+static void test_late_ack() {
+    settle();
+
+    // An ack that comes after its line timed out is not taken for a newer line's
+    fnc_send_line("$H", 100);
+    test_now += 200;
+    fnc_poll();
+    CHECK(fnc_pending() == 0);
+    fnc_send_line("G0 X1", 100);
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(fnc_pending() == 1);
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(fnc_pending() == 0);
+
+    // The ok for $H can follow the first Idle report
+    fnc_send_line("$H", 100);
+    test_now += 200;
+    fnc_poll();
+    rx = "<Idle|MPos:0.000,0.000,0.000|FS:0,0>\nok\n";
+    fnc_poll();
+    fnc_send_line("G0 X2", 100);
+    CHECK(fnc_pending() == 1);
+
+    // An ack that never comes is written off once FluidNC stays Idle
+    test_now += 200;
+    fnc_poll();
+    fnc_send_line("G0 X3", 100);
+    test_now += 200;
+    fnc_poll();
+    CHECK(fnc_pending() == 0);
+    rx = "<Idle|MPos:0.000,0.000,0.000|FS:0,0>\n<Idle|MPos:0.000,0.000,0.000|FS:0,0>\n";
+    fnc_poll();
+    fnc_send_line("G0 X4", 100);
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(fnc_pending() == 0);
+
+    // A restarted FluidNC has dropped its input, so nothing pending is acked
+    fnc_send_line("G0 X5", 100);
+    fnc_send_line("G0 X6", 100);
+    rx = "Grbl 3.7 [FluidNC v3.7.17 (noradio) '$' for help]\n";
+    fnc_poll();
+    CHECK(fnc_pending() == 0);
+    CHECK(!_ackwait);
+}
+
+static void test_status_polling() {
+    settle();
+
+    // Status is still polled, at the same rate, while lines are pending
+    fnc_send_line("G0 X1", 100);
+    reset_tx();
+    test_now += 60;
+    fnc_poll();
+    CHECK(!strcmp(tx_log, "?"));
+    fnc_poll();
+    CHECK(!strcmp(tx_log, "?"));
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(fnc_pending() == 0);
+}
+
+static void test_jog_cancel() {
+    settle();
+    reset_tx();
+
+    // One segment partly sent and two queued behind it
+    tx_room = 5;
+    fnc_send_line("$J=G91 G21 X6.666 F10000", 100);
+    fnc_send_line("$J=G91 G21 X6.666 F10000", 100);
+    CHECK(fnc_pending() == 2);
+
+    // The partial line is finished, the queued one dropped, and the cancel follows
+    fnc_jog_cancel();
+    CHECK(fnc_pending() == 1);
+    tx_room = 100;
+    rx      = "";
+    fnc_poll();
+    CHECK(!strcmp(tx_log, "$J=G91 G21 X6.666 F10000\n\x85"));
+
+    // That line may be parsed after the cancel, so the cancel goes again
+    // once it is acked, and nothing is sent in between
+    CHECK(!fnc_can_send(5));
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(!strcmp(tx_log, "$J=G91 G21 X6.666 F10000\n\x85\x85"));
+    CHECK(fnc_can_send(5));
+
+    // Lines that all went out before the cancel hold the second one until
+    // the last of them is acked
+    reset_tx();
+    tx_room = 1000;
+    for (int i = 0; i < 3; i++) {
+        fnc_send_line("$J=G91 G21 X6.666 F10000", 100);
+    }
+    reset_tx();
+    fnc_jog_cancel();
+    CHECK(!strcmp(tx_log, "\x85"));
+    CHECK(fnc_pending() == 3);
+    rx = "ok\nok\n";
+    fnc_poll();
+    CHECK(!strchr(tx_log + 1, '\x85'));
+    CHECK(fnc_pending() == 1);
+    CHECK(!fnc_can_send(5));
+    reset_tx();
+    rx = "ok\n";
+    fnc_poll();
+    CHECK(tx_len && tx_log[tx_len - 1] == '\x85');
+    CHECK(fnc_pending() == 0);
+
+    // A line sent while the cancel is owed waits for it
+    fnc_send_line("$J=G91 G21 X6.666 F10000", 100);
+    fnc_jog_cancel();
+    reset_tx();
+    rx = "ok\n";
+    fnc_send_line("G0 X1", 100);
+    CHECK(tx_len >= 7 && !strcmp(tx_log + tx_len - 7, "\x85G0 X1\n"));
+    settle();
+
+    // With nothing queued the cancel goes out at once, and only once
+    reset_tx();
+    fnc_jog_cancel();
+    CHECK(!strcmp(tx_log, "\x85"));
+    CHECK(fnc_pending() == 0);
+    fnc_poll();
+    CHECK(!strchr(tx_log + 1, '\x85'));
+}
+
+int main(int argc, char** argv) {
+    test_capture(argc > 1 ? argv[1] : "fluidnc_capture.txt");
+    test_pipelining();
+    test_late_ack();
+    test_status_polling();
+    test_jog_cancel();
+    printf(failures ? "%d FAILED\n" : "all passed\n", failures);
+    return failures != 0;
+}
@@ -1,4 +1,5 @@
 #include "Z_axis.h"
+#include "planner.h"
 #include <Arduino.h>
 
 void setupPen() {
@@ -6,7 +7,9 @@ void setupPen() {
     penUp();
 }
 
+// The pen moves when the lines queued before it are done
 void penUp() {
+    plannerSynchronize();
     penServo.write(penZUp);
     delay(LineDelay);
     Zpos = Zmax;
@@ -16,6 +19,7 @@ void penUp() {
 }
 
 void penDown() {
+    plannerSynchronize();
     penServo.write(penZDown);
     delay(LineDelay);
     Zpos = Zmin;
@@ -0,0 +1,27 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+/// Throughput benchmark, run by M60.
+///
+/// For full and then half stepping, runs the pen out along X and back at
+/// rising feeds, with the step rate limit lifted, and counts the steps back
+/// to the X limit switch after each feed.  A feed passes when the count
+/// matches where the pen should be, so no steps were lost.  StepAcceleration
+/// still applies, so each feed is reported as the peak speed the run
+/// reaches, and the feeds stop rising once the run is too short to reach
+/// them.  Reports the fastest peak that passes in each mode, with its step
+/// rate; MaxStepRate can then be set from it.  The pen is lifted and the
+/// machine is homed again afterwards.
+
+#include "config.h"
+
+#define BENCHMARK_DISTANCE 100   // mm run out along X
+#define BENCHMARK_CLEARANCE 2    // mm from the switch where each run ends
+#define BENCHMARK_PASSES 3       // Runs out and back per feed
+#define BENCHMARK_TOLERANCE 2    // Steps the count may be off by
+#define BENCHMARK_START 10       // First feed, mm/s
+#define BENCHMARK_STEP 5         // Feed increase, mm/s
+#define BENCHMARK_MAX 100        // Last feed, mm/s
+
+void runBenchmark();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,91 @@
+#include "benchmark.h"
+#include "kinamatics.h"
+#include "planner.h"
+#include "stepper.h"
+#include "Z_axis.h"
+#include <Arduino.h>
+
+// Runs out and back at feed, then returns the steps lost on the way
+static long lostSteps(float feed) {
+    home();
+    long x0 = Xpos;
+    long y0 = Ypos;
+    long out = BENCHMARK_DISTANCE * StepsPerMillimeterX;
+    long back = BENCHMARK_CLEARANCE * StepsPerMillimeterX;
+
+    Feedrate = feed;
+    for (int i = 0; i < BENCHMARK_PASSES; i++) {
+        mov(x0 + out, y0);
+        Xpos = x0 + out;
+        mov(x0 + back, y0);
+        Xpos = x0 + back;
+    }
+    plannerSynchronize();
+
+    // Motors step once each per X step, so the count back is in X steps
+    long steps = stepUntil(X_Limit, 1, 1, 4 * back);
+    return labs(steps - back);
+}
+
+// The top speed of a run out at feed.  Acceleration is left in place, so
+// a run too short to reach feed peaks halfway along.
+static float peakSpeed(float feed) {
+    float a = StepAcceleration / StepsPerMillimeterX;
+    float run = BENCHMARK_DISTANCE - BENCHMARK_CLEARANCE;
+    return min(feed, sqrtf(a * run));
+}
+
+// The fastest peak speed with no steps lost in the current mode, or 0
+static float maxReliableFeed() {
+    float savedFeed = Feedrate;
+    float savedRate = MaxStepRate;
+    MaxStepRate = 1e6;
+
+    float best = 0;
+    for (float feed = BENCHMARK_START; feed <= BENCHMARK_MAX; feed += BENCHMARK_STEP) {
+        float peak = peakSpeed(feed);
+        long lost = lostSteps(feed);
+        Serial.print(halfStepping() ? "Half step " : "Full step ");
+        Serial.print(peak);
+        Serial.print(" mm/s: ");
+        Serial.print(lost);
+        Serial.println(" steps off");
+        if (lost > BENCHMARK_TOLERANCE) {
+            break;
+        }
+        best = peak;
+        if (peak < feed) {
+            break;  // Faster feeds reach the same peak
+        }
+    }
+
+    Feedrate = savedFeed;
+    MaxStepRate = savedRate;
+    return best;
+}
+
+void runBenchmark() {
+    penUp();
+    bool wasHalf = halfStepping();
+
+    // Rates are per motor, in the mode's own steps, to set MaxStepRate from
+    setStepMode(FULL_STEP);
+    float full = maxReliableFeed();
+    float fullRate = full * StepsPerMillimeterX;
+    setStepMode(HALF_STEP);
+    float half = maxReliableFeed();
+    float halfRate = half * StepsPerMillimeterX;
+
+    setStepMode(wasHalf ? HALF_STEP : FULL_STEP);
+    home();
+
+    Serial.print("Max reliable feed, full step: ");
+    Serial.print(full);
+    Serial.print(" mm/s (");
+    Serial.print(fullRate);
+    Serial.print(" steps/s), half step: ");
+    Serial.print(half);
+    Serial.print(" mm/s (");
+    Serial.print(halfRate);
+    Serial.println(" steps/s)");
+}
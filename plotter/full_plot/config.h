@@ -2,8 +2,6 @@
 #define CONFIG_H
 
 #include <Servo.h>
-#include <AccelStepper.h>
-#include <MultiStepper.h>
 
 // Pin definitions
 #define X_Limit 9
@@ -39,6 +37,13 @@ extern int penDelay;
 extern float StepsPerMillimeterX;
 extern float StepsPerMillimeterY;
 
+// Motion planning
+extern float Feedrate;
+extern float MaxStepRate;
+extern float StepAcceleration;
+extern float JunctionDeviation;
+extern float HomingRate;
+
 extern float Xmin;
 extern float Xmax;
 extern float Ymin;
@@ -15,8 +15,15 @@ int StepDelay = 0;
 int LineDelay = 10;
 int penDelay = 10;
 
-float StepsPerMillimeterX = 21.55;
-float StepsPerMillimeterY = 21.55;
+// Half steps; see stepper.h
+float StepsPerMillimeterX = 43.1;
+float StepsPerMillimeterY = 43.1;
+
+float Feedrate = 40;            // mm/s for G0 and G1
+float MaxStepRate = 600;        // steps/s for either motor; the old 300 full steps/s. M60 measures what the motors keep up with
+float StepAcceleration = 3000;  // steps/s^2 for either motor
+float JunctionDeviation = 0.05; // mm; larger takes corners faster
+float HomingRate = 400;         // steps/s while seeking the limit switches
 
 float Xmin = 0;
 float Xmax = 210;
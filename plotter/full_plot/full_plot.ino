@@ -1,9 +1,8 @@
 #include <Servo.h>
-#include <AccelStepper.h>
-#include <MultiStepper.h>
 #include "config.h"
 #include "Z_axis.h"
 #include "kinamatics.h"
+#include "stepper.h"
 #include "parser.h"
 
 void setup() {
@@ -3,16 +3,14 @@
 /// Header file of kinamatics of the core XY
 
 #include "config.h"
-#include <AccelStepper.h>
-#include <MultiStepper.h>
-
-extern AccelStepper stepper1;
-extern AccelStepper stepper2;
-extern MultiStepper steppers;
 
 void setupMovement();
 void drawLine(float x1, float y1);
 void mov(long x, long y);
 void home();
 
+/// Steps the motors together in directions dir1, dir2 at HomingRate until
+/// pin reads high, or maxSteps are taken.  Returns the steps taken.
+long stepUntil(int pin, int dir1, int dir2, long maxSteps);
+
 #endif // 
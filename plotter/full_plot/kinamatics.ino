@@ -1,20 +1,11 @@
 #include "kinamatics.h"
+#include "planner.h"
+#include "stepper.h"
 #include <Arduino.h>
 
-AccelStepper stepper1(AccelStepper::FULL4WIRE, 5, 4, 3, 2);
-AccelStepper stepper2(AccelStepper::FULL4WIRE, 22, 19, 18, 17);
-MultiStepper steppers;
-
 void setupMovement() {
-    // Configure each stepper
-    stepper1.setMaxSpeed(300);
-    stepper1.setAcceleration(400);
-    stepper1.setCurrentPosition(0);
-    stepper2.setMaxSpeed(300);
-    stepper2.setAcceleration(400);
-    stepper2.setCurrentPosition(0);
-    steppers.addStepper(stepper1);
-    steppers.addStepper(stepper2);
+    setupSteppers();
+    plannerInit();
 }
 
 void drawLine(float x1, float y1) {
@@ -36,68 +27,46 @@ void drawLine(float x1, float y1) {
 
     mov(x1, y1);
 
-    float x0 = Xpos;
-    float y0 = Ypos;
-
-    long dx = abs(x1 - x0);
-    long dy = abs(y1 - y0);
-    int sx = x0 < x1 ? StepInc : -StepInc;
-    int sy = y0 < y1 ? StepInc : -StepInc;
-
-    long i;
-    long over = 0;
-
-    if (dx > dy) {
-        for (i = 0; i < dx; ++i) {
-            over += dy;
-            if (over >= dx) {
-                over -= dx;
-            }
-            delay(StepDelay);
-        }
-    } else {
-        for (i = 0; i < dy; ++i) {
-            over += dx;
-            if (over >= dy) {
-                over -= dy;
-            }
-            delay(StepDelay);
-        }
-    }
-
-    delay(LineDelay);
-
     Xpos = x1;
     Ypos = y1;
 }
 
+// Queues a move to x, y in steps, through the transform to the two motors.
+// Xpos, Ypos is where the move starts.
 void mov(long x, long y) {
     positions[0] = -(x + y);
     positions[1] = -(x - y);
-    steppers.moveTo(positions);
-    steppers.runSpeedToPosition();
+    plannerLine(positions[0], positions[1], (x - Xpos) / StepsPerMillimeterX, (y - Ypos) / StepsPerMillimeterY, Feedrate);
 }
  
-void home() {
-    positions[1] = (Xmax * StepsPerMillimeterX);
-    positions[0] = (Xmax * StepsPerMillimeterX);
-    steppers.moveTo(
-      positions);
-
-    while (!digitalRead(X_Limit)) {
-        //digitalWrite(LED, HIGH);
-        steppers.run();
+long stepUntil(int pin, int dir1, int dir2, long maxSteps) {
+    unsigned long interval = 1000000 / HomingRate;
+    long steps = 0;
+    while (!digitalRead(pin) && steps < maxSteps) {
+        // Waiting first keeps the first step clear of the last one queued
+        delayMicroseconds(interval);
+        motorStep(0, dir1);
+        motorStep(1, dir2);
+        steps++;
     }
+    return steps;
+}
 
-    positions[0] = Ymax * StepsPerMillimeterY;
-    positions[1] = -(Ymax * StepsPerMillimeterY);
-    steppers.moveTo(positions);
+void home() {
+    // Homing steps the motors directly, from where the queue left them
+    plannerSynchronize();
 
-    while (!digitalRead(Y_Limit)) {
-        //digitalWrite(LED, HIGH);
-        steppers.run();
-    }
+    stepUntil(X_Limit, 1, 1, (long)(2 * Xmax * StepsPerMillimeterX));
+    stepUntil(Y_Limit, 1, -1, (long)(2 * Ymax * StepsPerMillimeterY));
 
     positions[0] = 0;
     positions[1] = 0;
+
+    long m1 = motorPosition(0);
+    long m2 = motorPosition(1);
+    plannerSetPosition(m1, m2);
+
+    // The pen position in steps, from the inverse of the transform in mov()
+    Xpos = -(m1 + m2) / 2;
+    Ypos = (m2 - m1) / 2;
 }
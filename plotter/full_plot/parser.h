@@ -3,6 +3,9 @@
 
 #include "config.h"
 
+#define COMMAND_QUEUE_SIZE 8  // Parsed commands waiting to run
+#define COMMANDS_PER_LINE 2   // Room needed before a line is taken
+
 void processCommands();
 void processIncomingLine(char *line, int charNB);
 
@@ -1,36 +1,100 @@
  #include "parser.h"
 #include "kinamatics.h"
 #include "Z_axis.h"
+#include "planner.h"
+#include "benchmark.h"
 #include <Arduino.h>
 
+// Parsed commands waiting to run.  Lines are parsed as they arrive and
+// acknowledged once their commands are queued, so the sender can send the
+// next line while this one's motion runs.
+enum commandType {
+    CMD_MOVE,
+    CMD_HOME,
+    CMD_PEN_UP,
+    CMD_PEN_DOWN,
+    CMD_BENCHMARK
+};
+
+struct command {
+    uint8_t type;
+    float x;
+    float y;
+};
+
+static struct command commands[COMMAND_QUEUE_SIZE];
+static uint8_t commandTail = 0;
+static uint8_t commandCount = 0;
+
+static bool queueCommand(uint8_t type, float x, float y) {
+    if (commandCount == COMMAND_QUEUE_SIZE) {
+        Serial.println("ERROR - command queue overflow");
+        return false;
+    }
+    struct command &cmd = commands[(commandTail + commandCount) % COMMAND_QUEUE_SIZE];
+    cmd.type = type;
+    cmd.x = x;
+    cmd.y = y;
+    commandCount++;
+    return true;
+}
+
+// Runs queued commands for as long as they can start without waiting.
+// Moves go to the planner while it has room; the pen and homing wait for
+// the motion before them to finish.
+static void runCommands() {
+    while (commandCount) {
+        struct command &cmd = commands[commandTail];
+        if (cmd.type == CMD_MOVE) {
+            if (plannerFull()) {
+                return;
+            }
+            drawLine(cmd.x, cmd.y);
+        } else {
+            if (!plannerIdle()) {
+                return;
+            }
+            switch (cmd.type) {
+                case CMD_HOME:
+                    home();
+                    break;
+                case CMD_PEN_UP:
+                    penUp();
+                    break;
+                case CMD_PEN_DOWN:
+                    penDown();
+                    break;
+                case CMD_BENCHMARK:
+                    runBenchmark();
+                    break;
+            }
+        }
+        commandTail = (commandTail + 1) % COMMAND_QUEUE_SIZE;
+        commandCount--;
+    }
+}
+
 void processCommands() {
     delay(200);
     char line[LINE_BUFFER_LENGTH];
     char c;
     int lineIndex;
-    bool lineIsComment, lineSemiColon;
+    bool lineIsComment, lineSemiColon, lineReady;
 
     lineIndex = 0;
     lineSemiColon = false;
     lineIsComment = false;
+    lineReady = false;
 
     while (1) {
-        while (Serial.available() > 0) {
+        plannerPoll();
+
+        // Serial buffers what arrives meanwhile; a complete line stops
+        // reading until there is room for its commands
+        while (!lineReady && Serial.available() > 0) {
             c = Serial.read();
             if ((c == '\n') || (c == '\r')) {
-                if (lineIndex > 0) {
-                    line[lineIndex] = '\0';
-                    if (verbose) {
-                        Serial.print("Received : ");
-                        Serial.println(line);
-                    }
-                    processIncomingLine(line, lineIndex);
-                    lineIndex = 0;
-                } else {
-                }
-                lineIsComment = false;
-                lineSemiColon = false;
-                Serial.println("OK");
+                lineReady = true;
             } else {
                 if ((lineIsComment) || (lineSemiColon)) {
                     if (c == ')')
@@ -54,12 +118,32 @@ void processCommands() {
                 }
             }
         }
+
+        if (lineReady && COMMAND_QUEUE_SIZE - commandCount >= COMMANDS_PER_LINE) {
+            if (lineIndex > 0) {
+                line[lineIndex] = '\0';
+                if (verbose) {
+                    Serial.print("Received : ");
+                    Serial.println(line);
+                }
+                processIncomingLine(line, lineIndex);
+                lineIndex = 0;
+            }
+            lineIsComment = false;
+            lineSemiColon = false;
+            lineReady = false;
+            Serial.println("OK");
+        }
+
+        runCommands();
     }
 }
 
+// Parses a line into queued commands.  The commanded position is tracked
+// here, as the line is parsed, so a missing axis takes the value that the
+// line before left it at.
 void processIncomingLine(char *line, int charNB) {
     int currentIndex = 0;
-    char buffer[64];
     struct point newPos;
 
     newPos.x = 0.0;
@@ -67,60 +151,61 @@ void processIncomingLine(char *line, int charNB) {
 
     char *indexX;
     char *indexY;
+    char *end;
+    long code;
 
     while (currentIndex < charNB) {
         switch (line[currentIndex++]) {
             case 'G':
-                buffer[0] = line[currentIndex++];
-                buffer[1] = line[currentIndex++];
-                buffer[2] = '\0';
-
-                switch (atoi(buffer)) {
-                    case 00:
-                    case 01:
-                        indexX = strchr(line + currentIndex++, 'X');
-                        indexY = strchr(line + currentIndex++, 'Y');
-                        if (indexY <= 0) {
-                            newPos.x = atof(indexX + 1);
-                            newPos.y = actuatorPos.y;
-                        } else if (indexX <= 0) {
-                            newPos.y = atof(indexY + 1);
-                            newPos.x = actuatorPos.x;
-                        } else {
-                            newPos.y = atof(indexY + 1);
-                            indexY = NULL;
-                            newPos.x = atof(indexX + 1);
-                        }
-                        drawLine(newPos.x, newPos.y);
+                // The word number runs to the next letter, so G1 and G01 are the same
+                code = strtol(line + currentIndex, &end, 10);
+                currentIndex = end - line;
+
+                switch (code) {
+                    case 0:
+                    case 1:
+                        // An axis left out keeps its value
+                        indexX = strchr(line + currentIndex, 'X');
+                        indexY = strchr(line + currentIndex, 'Y');
+                        newPos.x = indexX ? atof(indexX + 1) : actuatorPos.x;
+                        newPos.y = indexY ? atof(indexY + 1) : actuatorPos.y;
+                        queueCommand(CMD_MOVE, newPos.x, newPos.y);
                         actuatorPos.x = newPos.x;
                         actuatorPos.y = newPos.y;
                         break;
 
                     case 28:
-                        home();
+                        queueCommand(CMD_HOME, 0, 0);
                         break;
                 }
                 break;
             case 'M':
-                buffer[0] = line[currentIndex++];
-                buffer[1] = line[currentIndex++];
-                buffer[2] = '\0';
-                switch (atoi(buffer)) {
-                    case 03: {
-                        char *indexS = strchr(line + currentIndex++, 'S');
+                code = strtol(line + currentIndex, &end, 10);
+                currentIndex = end - line;
+                switch (code) {
+                    case 3: {
+                        char *indexS = strchr(line + currentIndex, 'S');
+                        if (!indexS) {
+                            Serial.println("M3 needs S0 (pen up) or S123 (pen down)");
+                            break;
+                        }
                         float Spos = atof(indexS + 1);
                         if (Spos == 123) {
-                            penDown();
+                            queueCommand(CMD_PEN_DOWN, 0, 0);
                         }
                         if (Spos == 000) {
-                            penUp();
+                            queueCommand(CMD_PEN_UP, 0, 0);
                         }
                         break;
                     }
 
+                    case 60:
+                        queueCommand(CMD_BENCHMARK, 0, 0);
+                        break;
+
                     default:
                         Serial.print("Command not recognized : M");
-                        Serial.println(buffer);
+                        Serial.println(code);
                 }
         }
     }
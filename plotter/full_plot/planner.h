@@ -0,0 +1,40 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+/// Lookahead motion queue for the two-motor transform.
+///
+/// Lines are queued as motor step targets.  Each time one is added, the
+/// speeds at the joins between queued lines are planned again, so the pen
+/// slows down only as much as each corner and the end of the queue need.
+/// A timer interrupt runs the queue, accelerating and decelerating along
+/// each line, so motion does not stop between lines.
+
+#include "config.h"
+
+#define PLANNER_SIZE 16      // Lines queued ahead
+#define STEP_TICK_HZ 10000   // Step generator rate; above the fastest step rate
+#define MIN_SPEED 1.0        // mm/s; lines start and end no slower than this
+
+void plannerInit();
+bool plannerFull();
+bool plannerIdle();
+
+/// Queues a line to motor targets m1, m2, which moves the pen dx, dy mm.
+/// Waits if the queue is full.
+void plannerLine(long m1, long m2, float dx, float dy, float feed);
+
+/// Waits until all queued motion is done
+void plannerSynchronize();
+
+/// Runs the step generator from the loop on boards without a step timer
+void plannerPoll();
+
+/// Where the queue ends, in motor steps.  Only call when idle to change it.
+void plannerSetPosition(long m1, long m2);
+
+/// One step generator tick; called by the timer interrupt
+void stepTick();
+
+/// Moves a motor one step; dir is 1 or -1
+void motorStep(int motor, int dir);
+
+#endif // PLANNER_H
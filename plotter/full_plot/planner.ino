@@ -0,0 +1,263 @@
+#include "planner.h"
+#include <Arduino.h>
+#include <math.h>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <pico/time.h>
+#define STEP_TIMER
+#endif
+
+struct block {
+    long steps[2];          // Motor steps, signed
+    long stepEventCount;    // The larger motor's step count
+    float millimeters;
+    float stepsPerMm;       // Step events per mm of pen travel
+    float unit[2];          // Direction of pen travel
+    float nominalSpeed;     // mm/s, within the feed and both motors' step rates
+    float acceleration;     // mm/s^2, within both motors' acceleration
+    float maxEntrySpeed;    // What the corner from the previous line allows
+    float entrySpeed;
+    volatile float exitSpeed;        // The next line's entry speed
+    volatile long decelerateAfter;   // Step event where slowing down starts
+};
+
+// blockTail is the line being run or next to run; blockHead is where the
+// next line goes.  Only the step generator moves blockTail.
+static block blocks[PLANNER_SIZE];
+static volatile uint8_t blockHead = 0;
+static volatile uint8_t blockTail = 0;
+static volatile bool busy = false;   // The step generator has started blocks[blockTail]
+
+static long plannedPosition[2];      // Where the queue ends
+static float previousUnit[2];
+static float previousNominal = 0;
+
+static uint8_t nextBlock(uint8_t i) {
+    return (i + 1) % PLANNER_SIZE;
+}
+
+static uint8_t prevBlock(uint8_t i) {
+    return (i + PLANNER_SIZE - 1) % PLANNER_SIZE;
+}
+
+#ifdef STEP_TIMER
+static repeating_timer_t stepTimer;
+
+static bool onStepTimer(repeating_timer_t *timer) {
+    stepTick();
+    return true;
+}
+#endif
+
+void plannerInit() {
+#ifdef STEP_TIMER
+    // Negative period: ticks are spaced from the start of each callback
+    add_repeating_timer_us(-1000000 / STEP_TICK_HZ, onStepTimer, NULL, &stepTimer);
+#endif
+}
+
+void plannerPoll() {
+#ifndef STEP_TIMER
+    static unsigned long lastTick = micros();
+    const unsigned long tickUs = 1000000 / STEP_TICK_HZ;
+    unsigned long now = micros();
+    if (now - lastTick >= tickUs) {
+        // One tick per call.  Ticks the loop was too busy for, as in homing
+        // or a pen delay, are dropped: that slows the motion down, where
+        // catching up would bunch steps together and lose them.
+        lastTick = now - lastTick >= 2 * tickUs ? now : lastTick + tickUs;
+        stepTick();
+    }
+#endif
+}
+
+bool plannerFull() {
+    return nextBlock(blockHead) == blockTail;
+}
+
+bool plannerIdle() {
+    return blockHead == blockTail;
+}
+
+void plannerSynchronize() {
+    while (!plannerIdle()) {
+        plannerPoll();
+    }
+}
+
+void plannerSetPosition(long m1, long m2) {
+    plannedPosition[0] = m1;
+    plannedPosition[1] = m2;
+    previousNominal = 0;
+}
+
+// Where a line that starts at entry and ends at exit has to start slowing
+// down, whether or not it gets up to its nominal speed in between
+static void planDeceleration(block &b, float entry, float exit) {
+    float a = b.acceleration;
+    float nominal2 = b.nominalSpeed * b.nominalSpeed;
+    float accelDist = (nominal2 - entry * entry) / (2 * a);
+    float decelDist = (nominal2 - exit * exit) / (2 * a);
+    float decelStart;
+    if (accelDist + decelDist > b.millimeters) {
+        // Never reaches nominal speed
+        decelStart = (2 * a * b.millimeters + exit * exit - entry * entry) / (4 * a);
+        decelStart = constrain(decelStart, 0.0f, b.millimeters);
+    } else {
+        decelStart = b.millimeters - decelDist;
+    }
+    b.exitSpeed = exit;
+    b.decelerateAfter = (long)(decelStart * b.stepsPerMm);
+}
+
+// Plans the entry speeds of the lines that have not started: backwards so
+// each line can stop by the end of the queue, then forwards so each line
+// can get up to speed from the one before.  Adding a line never lowers the
+// speeds planned before, so the line being run can take the new plan.
+static void recalculate() {
+    uint8_t first = busy ? nextBlock(blockTail) : blockTail;
+    if (first == blockHead) {
+        return;
+    }
+
+    float nextEntry = 0;
+    uint8_t i = blockHead;
+    do {
+        i = prevBlock(i);
+        block &b = blocks[i];
+        float reachable = sqrtf(nextEntry * nextEntry + 2 * b.acceleration * b.millimeters);
+        b.entrySpeed = min(b.maxEntrySpeed, reachable);
+        nextEntry = b.entrySpeed;
+    } while (i != first);
+
+    if (busy) {
+        block &running = blocks[blockTail];
+        float reachable = sqrtf(running.entrySpeed * running.entrySpeed + 2 * running.acceleration * running.millimeters);
+        block &b = blocks[first];
+        b.entrySpeed = min(b.entrySpeed, reachable);
+        planDeceleration(running, running.entrySpeed, b.entrySpeed);
+    }
+
+    for (i = first; i != blockHead; i = nextBlock(i)) {
+        block &b = blocks[i];
+        uint8_t n = nextBlock(i);
+        float exit = 0;
+        if (n != blockHead) {
+            float reachable = sqrtf(b.entrySpeed * b.entrySpeed + 2 * b.acceleration * b.millimeters);
+            blocks[n].entrySpeed = min(blocks[n].entrySpeed, reachable);
+            exit = blocks[n].entrySpeed;
+        }
+        planDeceleration(b, b.entrySpeed, exit);
+    }
+}
+
+void plannerLine(long m1, long m2, float dx, float dy, float feed) {
+    float millimeters = sqrtf(dx * dx + dy * dy);
+    long steps[2] = { m1 - plannedPosition[0], m2 - plannedPosition[1] };
+    long count = max(labs(steps[0]), labs(steps[1]));
+    if (count == 0 || millimeters == 0) {
+        return;
+    }
+
+    while (plannerFull()) {
+        plannerPoll();
+    }
+
+    block &b = blocks[blockHead];
+    b.steps[0] = steps[0];
+    b.steps[1] = steps[1];
+    b.stepEventCount = count;
+    b.millimeters = millimeters;
+    b.stepsPerMm = count / millimeters;
+    b.unit[0] = dx / millimeters;
+    b.unit[1] = dy / millimeters;
+
+    // Along this line the faster motor turns stepsPerMm steps per mm, so
+    // it sets the limits on speed and acceleration
+    b.nominalSpeed = min(feed, MaxStepRate / b.stepsPerMm);
+    b.acceleration = StepAcceleration / b.stepsPerMm;
+
+    // The speed through the corner from the previous line, by junction
+    // deviation: the speed at which a circular path that deviates no more
+    // than JunctionDeviation from the corner stays within acceleration
+    b.maxEntrySpeed = 0;
+    if (previousNominal > 0 && !plannerIdle()) {
+        float cosTheta = -(previousUnit[0] * b.unit[0] + previousUnit[1] * b.unit[1]);
+        if (cosTheta < -0.999999f) {
+            b.maxEntrySpeed = min(previousNominal, b.nominalSpeed);  // Straight on
+        } else if (cosTheta < 0.999999f) {
+            float sinHalf = sqrtf(0.5f * (1.0f - cosTheta));
+            float v2 = b.acceleration * JunctionDeviation * sinHalf / (1.0f - sinHalf);
+            b.maxEntrySpeed = min(sqrtf(v2), min(previousNominal, b.nominalSpeed));
+        }
+    }
+    b.entrySpeed = b.maxEntrySpeed;
+
+    plannedPosition[0] = m1;
+    plannedPosition[1] = m2;
+    previousUnit[0] = b.unit[0];
+    previousUnit[1] = b.unit[1];
+    previousNominal = b.nominalSpeed;
+
+    // The step generator must not start a line while it is being planned
+    noInterrupts();
+    blockHead = nextBlock(blockHead);
+    recalculate();
+    interrupts();
+}
+
+//---------------------------------------------------------------
+//                     Step generator
+//---------------------------------------------------------------
+// Speed changes by acceleration * dt each tick.  Lines are run with a
+// Bresenham walk of the two motors, advanced at the current speed.  The
+// speed carries over from one line to the next; when the queue runs dry
+// the pen has slowed to a stop.
+void stepTick() {
+    static float speed = 0;       // mm/s
+    static float phase = 0;       // Fraction of a step event
+    static long completed;
+    static long counter[2];
+
+    if (!busy) {
+        if (blockTail == blockHead) {
+            speed = 0;
+            return;
+        }
+        block &b = blocks[blockTail];
+        completed = 0;
+        counter[0] = counter[1] = -(b.stepEventCount >> 1);
+        phase = 0;
+        if (speed > b.entrySpeed) {
+            speed = b.entrySpeed;
+        }
+        busy = true;
+    }
+
+    block &b = blocks[blockTail];
+    const float dt = 1.0f / STEP_TICK_HZ;
+    if (completed >= b.decelerateAfter) {
+        if (speed > b.exitSpeed) {
+            speed = max(speed - b.acceleration * dt, (float)b.exitSpeed);
+        }
+    } else if (speed < b.nominalSpeed) {
+        speed = min(speed + b.acceleration * dt, b.nominalSpeed);
+    }
+
+    phase += max(speed, (float)MIN_SPEED) * b.stepsPerMm * dt;
+    while (phase >= 1.0f) {
+        phase -= 1.0f;
+        for (int m = 0; m < 2; m++) {
+            counter[m] += labs(b.steps[m]);
+            if (counter[m] > 0) {
+                counter[m] -= b.stepEventCount;
+                motorStep(m, b.steps[m] > 0 ? 1 : -1);
+            }
+        }
+        if (++completed == b.stepEventCount) {
+            busy = false;
+            blockTail = nextBlock(blockTail);
+            break;
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef STEPPER_H
+#define STEPPER_H
+/// Coil driver for 28BYJ-48 steppers on ULN2003 boards.
+///
+/// Each step writes the motor's coils from its phase table, so the step
+/// generator in planner.ino can step the motors from its timer interrupt.
+/// Half stepping doubles the resolution and runs the motors more smoothly
+/// at the low step rates these motors manage.
+
+#include <stdint.h>
+
+struct phaseTable {
+    const uint8_t *phases;  // Coil patterns; bit i drives the motor's pin i
+    uint8_t count;          // A power of 2
+};
+
+extern const phaseTable FULL_STEP;
+extern const phaseTable HALF_STEP;
+
+void setupSteppers();
+
+/// Switches both motors between full and half stepping.  Positions and the
+/// step-based settings in config.ino are rescaled to the new step size.
+void setStepMode(const phaseTable &table);
+bool halfStepping();
+
+long motorPosition(int motor);
+
+#endif // STEPPER_H
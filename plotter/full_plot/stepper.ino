@@ -0,0 +1,80 @@
+#include "stepper.h"
+#include "planner.h"
+#include "config.h"
+#include <Arduino.h>
+
+// Coil sequences in AccelStepper's pin order, so the motors are wired as
+// they were for AccelStepper::FULL4WIRE.  Full step position p and half
+// step position 2p + 1 energize the same coils.
+static const uint8_t fullStepPhases[] = { 0b0101, 0b0110, 0b1010, 0b1001 };
+static const uint8_t halfStepPhases[] = { 0b0001, 0b0101, 0b0100, 0b0110, 0b0010, 0b1010, 0b1000, 0b1001 };
+
+const phaseTable FULL_STEP = { fullStepPhases, 4 };
+const phaseTable HALF_STEP = { halfStepPhases, 8 };
+
+struct motor {
+    uint8_t pins[4];
+    const phaseTable *table;
+    volatile long position;
+};
+
+static motor motors[2] = {
+    { { 5, 4, 3, 2 }, &HALF_STEP, 0 },
+    { { 22, 19, 18, 17 }, &HALF_STEP, 0 },
+};
+
+static void energize(motor &m) {
+    uint8_t pattern = m.table->phases[m.position & (m.table->count - 1)];
+    for (int i = 0; i < 4; i++) {
+        digitalWrite(m.pins[i], (pattern >> i) & 1);
+    }
+}
+
+void setupSteppers() {
+    for (int m = 0; m < 2; m++) {
+        for (int i = 0; i < 4; i++) {
+            pinMode(motors[m].pins[i], OUTPUT);
+        }
+        energize(motors[m]);
+    }
+}
+
+void motorStep(int motor, int dir) {
+    motors[motor].position += dir;
+    energize(motors[motor]);
+}
+
+long motorPosition(int motor) {
+    return motors[motor].position;
+}
+
+bool halfStepping() {
+    return motors[0].table == &HALF_STEP;
+}
+
+void setStepMode(const phaseTable &table) {
+    bool toHalf = &table == &HALF_STEP;
+    if (toHalf == halfStepping()) {
+        return;
+    }
+    plannerSynchronize();
+
+    float scale = toHalf ? 2.0 : 0.5;
+    StepsPerMillimeterX *= scale;
+    StepsPerMillimeterY *= scale;
+    MaxStepRate *= scale;
+    StepAcceleration *= scale;
+    HomingRate *= scale;
+    Xpos *= scale;
+    Ypos *= scale;
+
+    for (int m = 0; m < 2; m++) {
+        long p = motors[m].position;
+        // Rounded down, so both motors keep the same parity
+        motors[m].position = toHalf ? 2 * p + 1 : (p - 1 - (p < 1)) / 2;
+        motors[m].table = &table;
+        energize(motors[m]);
+    }
+    delay(50);  // Lets the rotors settle on the new coils
+    plannerSetPosition(motors[0].position, motors[1].position);
+}
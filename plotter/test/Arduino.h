@@ -0,0 +1,60 @@
+// Host stand-in for the parts of the Arduino API that the plotter sketch
+// uses.  host_plot.cpp provides the clock, the pins and the serial port.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+template <class T, class L, class H>
+T constrain(T value, L low, H high) {
+    return value < low ? low : value > high ? high : value;
+}
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class HostSerial {
+public:
+    void begin(long baud) {}
+    int available();
+    int read();
+
+    void print(const char *s);
+    void print(char c);
+    void print(int n) { print((long)n); }
+    void print(long n);
+    void print(unsigned long n);
+    void print(double f);  // 2 decimals, as on the board
+
+    template <class T>
+    void println(T value) {
+        print(value);
+        println();
+    }
+    void println() { print('\n'); }
+};
+
+extern HostSerial Serial;
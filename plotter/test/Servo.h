@@ -0,0 +1,8 @@
+// Host stand-in for the Servo library; host_plot.cpp records the angles
+#pragma once
+
+class Servo {
+public:
+    void attach(int pin) {}
+    void write(int angle);
+};
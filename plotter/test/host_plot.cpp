@@ -0,0 +1,212 @@
+// Host build of the plotter sketch: runs a G-code file through the parser,
+// the planner and the coil driver against a stub HAL, without plotter
+// hardware.  Prints what the machine did: the serial replies, each pen move
+// with where the pen was, and at the end the motor positions and a hash of
+// the step sequence.  The simulated and host times go to stderr.
+//
+//   c++ -std=gnu++11 -O2 -Wall -I. -o host_plot host_plot.cpp
+//   ./host_plot samples/square.gcode
+//
+// run_samples.sh runs every sample and compares it with its .expected file.
+
+#include <Arduino.h>  // As the IDE adds to the sketch
+
+#include "../full_plot/full_plot.ino"
+#include "../full_plot/Z_axis.ino"
+#include "../full_plot/benchmark.ino"
+#include "../full_plot/config.ino"
+#include "../full_plot/kinamatics.ino"
+#include "../full_plot/parser.ino"
+#include "../full_plot/planner.ino"
+#include "../full_plot/stepper.ino"
+
+#include <stdio.h>
+#include <time.h>
+
+// Where the limit switches are, in mm from where the pen starts
+#define SWITCH_X -30.0
+#define SWITCH_Y -30.0
+
+#define TIME_LIMIT_S 3600  // Simulated; a run that takes longer has hung
+
+HostSerial Serial;
+
+// The clock moves on by 1 us each time it is read, about what a pass of
+// the loop takes on the board
+static unsigned long now_us = 0;
+
+unsigned long micros() {
+    if (now_us > TIME_LIMIT_S * 1000000UL) {
+        fprintf(stderr, "timed out\n");
+        exit(1);
+    }
+    return ++now_us;
+}
+unsigned long millis() {
+    return micros() / 1000;
+}
+void delay(unsigned long ms) {
+    now_us += ms * 1000;
+}
+void delayMicroseconds(unsigned int us) {
+    now_us += us;
+}
+
+//---------------------------------------------------------------
+//                     Motors and switches
+//---------------------------------------------------------------
+// Where each rotor is, in half steps, decoded from the coils the way the
+// motor follows them.  The sketch's own idea of the position is not used.
+static int pinState[64];
+static long rotor[2];
+static int rotorPhase[2];
+static long stepCount = 0;
+static uint32_t stepHash = 2166136261u;  // FNV-1a of the steps, in order
+
+void pinMode(int pin, int mode) {}
+
+static void coilsChanged(int m) {
+    int pattern = 0;
+    for (int i = 0; i < 4; i++) {
+        pattern |= pinState[motors[m].pins[i]] << i;
+    }
+    int phase = -1;
+    for (int i = 0; i < 8; i++) {
+        if (halfStepPhases[i] == pattern) {
+            phase = i;
+        }
+    }
+    if (phase < 0) {
+        printf("bad coil pattern %d on motor %d\n", pattern, m);
+        exit(1);
+    }
+    int delta = (phase - rotorPhase[m] + 8) % 8;
+    if (delta == 0) {
+        return;
+    }
+    if (delta > 4) {
+        delta -= 8;
+    }
+    rotor[m] += delta;
+    rotorPhase[m] = phase;
+    stepCount++;
+    uint8_t step = m << 4 | (delta & 0xf);
+    stepHash = (stepHash ^ step) * 16777619u;
+}
+
+void digitalWrite(int pin, int value) {
+    pinState[pin] = value;
+    for (int m = 0; m < 2; m++) {
+        if (pin == motors[m].pins[3]) {
+            coilsChanged(m);
+        }
+    }
+}
+
+static double halfStepsPerMm() {
+    return halfStepping() ? StepsPerMillimeterX : 2 * StepsPerMillimeterX;
+}
+
+// The pen position in mm, by the inverse of the transform in mov()
+static double penX() {
+    return -(rotor[0] + rotor[1]) / 2.0 / halfStepsPerMm();
+}
+static double penY() {
+    return (rotor[1] - rotor[0]) / 2.0 / halfStepsPerMm();
+}
+
+int digitalRead(int pin) {
+    if (pin == X_Limit) {
+        return penX() <= SWITCH_X;
+    }
+    if (pin == Y_Limit) {
+        return penY() <= SWITCH_Y;
+    }
+    return LOW;
+}
+
+void Servo::write(int angle) {
+    printf("pen %d at %.2f, %.2f\n", angle, penX(), penY());
+}
+
+//---------------------------------------------------------------
+//                     Serial port
+//---------------------------------------------------------------
+static const char *input = "";
+static size_t inputLength = 0;
+static size_t inputPos = 0;
+static clock_t started;
+
+static void finish() {
+    printf("end at %.2f, %.2f; motors %ld, %ld; %ld steps, hash %08x\n",
+           penX(), penY(), rotor[0], rotor[1], stepCount, (unsigned)stepHash);
+    fprintf(stderr, "%.3f s simulated, %.3f s host\n",
+            now_us / 1e6, (double)(clock() - started) / CLOCKS_PER_SEC);
+    exit(0);
+}
+
+// The whole file is there to read.  Once it has been read and its commands
+// have run, the run is over.
+int HostSerial::available() {
+    if (inputPos == inputLength && commandCount == 0 && plannerIdle()) {
+        finish();
+    }
+    return inputLength - inputPos;
+}
+
+int HostSerial::read() {
+    return inputPos < inputLength ? (uint8_t)input[inputPos++] : -1;
+}
+
+// Replies are printed a line at a time, marked with <
+static bool lineStart = true;
+
+void HostSerial::print(char c) {
+    if (lineStart) {
+        fputs("< ", stdout);
+    }
+    putchar(c);
+    lineStart = c == '\n';
+}
+void HostSerial::print(const char *s) {
+    while (*s) {
+        print(*s++);
+    }
+}
+void HostSerial::print(long n) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", n);
+    print(buf);
+}
+void HostSerial::print(unsigned long n) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%lu", n);
+    print(buf);
+}
+void HostSerial::print(double f) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.2f", f);
+    print(buf);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s file.gcode\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 2;
+    }
+    static char text[1 << 20];
+    inputLength = fread(text, 1, sizeof(text), f);
+    fclose(f);
+    input = text;
+
+    started = clock();
+    setup();
+    while (1) {
+        loop();
+    }
+}
@@ -0,0 +1,24 @@
+#!/bin/sh
+# Builds host_plot and runs every sample through it, comparing what the
+# machine did with the sample's .expected file and reporting how long each
+# run took.  With --update, writes the .expected files instead.
+#
+#   ./run_samples.sh [--update]
+
+cd "$(dirname "$0")" || exit 1
+c++ -std=gnu++11 -O2 -Wall -I. -o host_plot host_plot.cpp || exit 1
+
+failed=0
+for sample in samples/*.gcode; do
+    expected="${sample%.gcode}.expected"
+    printf '%s: ' "$sample"
+    if [ "$1" = "--update" ]; then
+        ./host_plot "$sample" > "$expected"
+    elif ! ./host_plot "$sample" | diff -u "$expected" - > "$sample.diff"; then
+        echo "FAILED, see $sample.diff"
+        failed=1
+        continue
+    fi
+    rm -f "$sample.diff"
+done
+exit $failed
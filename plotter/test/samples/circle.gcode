@@ -0,0 +1,150 @@
+(circle of 72 segments, twice around)
+M03 S000
+G00 X90.00 Y60.00
+M03 S123
+G01 X89.89 Y62.61
+G01 X89.54 Y65.21
+G01 X88.98 Y67.76
+G01 X88.19 Y70.26
+G01 X87.19 Y72.68
+G01 X85.98 Y75.00
+G01 X84.57 Y77.21
+G01 X82.98 Y79.28
+G01 X81.21 Y81.21
+G01 X79.28 Y82.98
+G01 X77.21 Y84.57
+G01 X75.00 Y85.98
+G01 X72.68 Y87.19
+G01 X70.26 Y88.19
+G01 X67.76 Y88.98
+G01 X65.21 Y89.54
+G01 X62.61 Y89.89
+G01 X60.00 Y90.00
+G01 X57.39 Y89.89
+G01 X54.79 Y89.54
+G01 X52.24 Y88.98
+G01 X49.74 Y88.19
+G01 X47.32 Y87.19
+G01 X45.00 Y85.98
+G01 X42.79 Y84.57
+G01 X40.72 Y82.98
+G01 X38.79 Y81.21
+G01 X37.02 Y79.28
+G01 X35.43 Y77.21
+G01 X34.02 Y75.00
+G01 X32.81 Y72.68
+G01 X31.81 Y70.26
+G01 X31.02 Y67.76
+G01 X30.46 Y65.21
+G01 X30.11 Y62.61
+G01 X30.00 Y60.00
+G01 X30.11 Y57.39
+G01 X30.46 Y54.79
+G01 X31.02 Y52.24
+G01 X31.81 Y49.74
+G01 X32.81 Y47.32
+G01 X34.02 Y45.00
+G01 X35.43 Y42.79
+G01 X37.02 Y40.72
+G01 X38.79 Y38.79
+G01 X40.72 Y37.02
+G01 X42.79 Y35.43
+G01 X45.00 Y34.02
+G01 X47.32 Y32.81
+G01 X49.74 Y31.81
+G01 X52.24 Y31.02
+G01 X54.79 Y30.46
+G01 X57.39 Y30.11
+G01 X60.00 Y30.00
+G01 X62.61 Y30.11
+G01 X65.21 Y30.46
+G01 X67.76 Y31.02
+G01 X70.26 Y31.81
+G01 X72.68 Y32.81
+G01 X75.00 Y34.02
+G01 X77.21 Y35.43
+G01 X79.28 Y37.02
+G01 X81.21 Y38.79
+G01 X82.98 Y40.72
+G01 X84.57 Y42.79
+G01 X85.98 Y45.00
+G01 X87.19 Y47.32
+G01 X88.19 Y49.74
+G01 X88.98 Y52.24
+G01 X89.54 Y54.79
+G01 X89.89 Y57.39
+G01 X90.00 Y60.00
+G01 X89.89 Y62.61
+G01 X89.54 Y65.21
+G01 X88.98 Y67.76
+G01 X88.19 Y70.26
+G01 X87.19 Y72.68
+G01 X85.98 Y75.00
+G01 X84.57 Y77.21
+G01 X82.98 Y79.28
+G01 X81.21 Y81.21
+G01 X79.28 Y82.98
+G01 X77.21 Y84.57
+G01 X75.00 Y85.98
+G01 X72.68 Y87.19
+G01 X70.26 Y88.19
+G01 X67.76 Y88.98
+G01 X65.21 Y89.54
+G01 X62.61 Y89.89
+G01 X60.00 Y90.00
+G01 X57.39 Y89.89
+G01 X54.79 Y89.54
+G01 X52.24 Y88.98
+G01 X49.74 Y88.19
+G01 X47.32 Y87.19
+G01 X45.00 Y85.98
+G01 X42.79 Y84.57
+G01 X40.72 Y82.98
+G01 X38.79 Y81.21
+G01 X37.02 Y79.28
+G01 X35.43 Y77.21
+G01 X34.02 Y75.00
+G01 X32.81 Y72.68
+G01 X31.81 Y70.26
+G01 X31.02 Y67.76
+G01 X30.46 Y65.21
+G01 X30.11 Y62.61
+G01 X30.00 Y60.00
+G01 X30.11 Y57.39
+G01 X30.46 Y54.79
+G01 X31.02 Y52.24
+G01 X31.81 Y49.74
+G01 X32.81 Y47.32
+G01 X34.02 Y45.00
+G01 X35.43 Y42.79
+G01 X37.02 Y40.72
+G01 X38.79 Y38.79
+G01 X40.72 Y37.02
+G01 X42.79 Y35.43
+G01 X45.00 Y34.02
+G01 X47.32 Y32.81
+G01 X49.74 Y31.81
+G01 X52.24 Y31.02
+G01 X54.79 Y30.46
+G01 X57.39 Y30.11
+G01 X60.00 Y30.00
+G01 X62.61 Y30.11
+G01 X65.21 Y30.46
+G01 X67.76 Y31.02
+G01 X70.26 Y31.81
+G01 X72.68 Y32.81
+G01 X75.00 Y34.02
+G01 X77.21 Y35.43
+G01 X79.28 Y37.02
+G01 X81.21 Y38.79
+G01 X82.98 Y40.72
+G01 X84.57 Y42.79
+G01 X85.98 Y45.00
+G01 X87.19 Y47.32
+G01 X88.19 Y49.74
+G01 X88.98 Y52.24
+G01 X89.54 Y54.79
+G01 X89.89 Y57.39
+G01 X90.00 Y60.00
+M03 S000
+G00 X0 Y0
@@ -0,0 +1,17 @@
+(comments, lower case, single axis moves, one digit and unspaced words, homing and unknown commands)
+m03 s000
+g00 x10 y15 ; to the start
+G01 X30
+G01 Y40
+M03 S123
+G01 X10 (back) Y15
+M03 S000
+M05
+G1X10Y10
+G1 X20
+M3S123
+M03
+M03 S000
+G28
+G00 X5 Y5
+G01 X250 Y400
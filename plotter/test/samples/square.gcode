@@ -0,0 +1,10 @@
+; 40 mm square
+M03 S000
+G00 X20 Y20
+M03 S123
+G01 X60 Y20
+G01 X60 Y60
+G01 X20 Y60
+G01 X20 Y20
+M03 S000
+G00 X0 Y0